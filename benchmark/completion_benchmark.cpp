@@ -0,0 +1,140 @@
+// This benchmark measures per-request completion cost for blocking requests, between `std::promise` / `std::future`
+// and completion slot.
+//
+// A completer thread plays the eventloop: it drains submitted completions and fulfills them in batches, as
+// `CheckMulti` does for transfers finished in one pass. No network IO is involved, so the measured latency is purely
+// the cost of completion and wakeup.
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <thread>
+
+#include "completion_slot.hpp"
+#include "duckdb/common/helper.hpp"
+#include "duckdb/common/http_util.hpp"
+#include "duckdb/common/unique_ptr.hpp"
+#include "duckdb/common/vector.hpp"
+#include "mpsc_queue.hpp"
+
+using namespace duckdb; // NOLINT
+
+namespace {
+
+// Number of requests issued by each waiter thread.
+constexpr idx_t REQUESTS_PER_THREAD = 20000;
+// Number of waiter threads, each of which blocks on one request at a time.
+constexpr std::array<idx_t, 4> TEST_THREAD_COUNTS = {1, 4, 16, 64};
+
+// Mimics completion-related fields of a curl request.
+struct PendingCompletion {
+	std::function<void(unique_ptr<HTTPResponse>)> callback;
+	CompletionSlot *slot = nullptr;
+};
+
+// Plays the eventloop, which completes all submitted requests in batches.
+class Completer {
+public:
+	Completer() : thd([this]() { Run(); }) {
+	}
+	~Completer() {
+		stopped.store(true);
+		thd.join();
+	}
+
+	void Submit(PendingCompletion completion) {
+		pending.Push(std::move(completion));
+	}
+
+private:
+	void Run() {
+		vector<CompletionSlot *> slots_to_wake;
+		while (!stopped.load(std::memory_order_relaxed)) {
+			bool has_completion = false;
+			pending.ConsumeAll([&](PendingCompletion completion) {
+				has_completion = true;
+				auto response = make_uniq<HTTPResponse>(HTTPStatusCode::OK_200);
+				if (completion.slot != nullptr) {
+					if (completion.slot->Complete(std::move(response))) {
+						slots_to_wake.emplace_back(completion.slot);
+					}
+				} else {
+					completion.callback(std::move(response));
+				}
+			});
+			for (auto *cur_slot : slots_to_wake) {
+				cur_slot->Wake();
+			}
+			slots_to_wake.clear();
+			if (!has_completion) {
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	MpscQueue<PendingCompletion> pending;
+	std::atomic<bool> stopped {false};
+	std::thread thd;
+};
+
+// Blocking request completion via promise and future, which is how requests used to be completed.
+unique_ptr<HTTPResponse> WaitWithPromise(Completer &completer) {
+	auto response_promise = std::make_shared<std::promise<unique_ptr<HTTPResponse>>>();
+	auto resp_fut = response_promise->get_future();
+	PendingCompletion completion;
+	completion.callback = [response_promise](unique_ptr<HTTPResponse> response) {
+		response_promise->set_value(std::move(response));
+	};
+	completer.Submit(std::move(completion));
+	return resp_fut.get();
+}
+
+// Blocking request completion via completion slot.
+unique_ptr<HTTPResponse> WaitWithSlot(Completer &completer) {
+	auto *slot = CompletionSlot::Acquire();
+	PendingCompletion completion;
+	completion.slot = slot;
+	completer.Submit(std::move(completion));
+	auto response = slot->Wait();
+	CompletionSlot::Release(slot);
+	return response;
+}
+
+template <typename WaitFn>
+void RunBenchmark(const char *name, idx_t thread_count, WaitFn wait_fn) {
+	Completer completer;
+	vector<std::thread> threads;
+	threads.reserve(thread_count);
+
+	const auto start = std::chrono::steady_clock::now();
+	for (idx_t idx = 0; idx < thread_count; ++idx) {
+		threads.emplace_back([&completer, &wait_fn]() {
+			for (idx_t req_idx = 0; req_idx < REQUESTS_PER_THREAD; ++req_idx) {
+				auto response = wait_fn(completer);
+				D_ASSERT(response != nullptr);
+			}
+		});
+	}
+	for (auto &cur_thread : threads) {
+		cur_thread.join();
+	}
+	const auto end = std::chrono::steady_clock::now();
+
+	const auto total_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+	const idx_t total_requests = thread_count * REQUESTS_PER_THREAD;
+	std::cout << name << " completion with " << thread_count << " threads takes " << total_ns / total_requests
+	          << " nanoseconds per request" << std::endl;
+}
+
+} // namespace
+
+int main() {
+	for (idx_t cur_thread_count : TEST_THREAD_COUNTS) {
+		RunBenchmark("promise-based", cur_thread_count, WaitWithPromise);
+		RunBenchmark("slot-based", cur_thread_count, WaitWithSlot);
+	}
+	return 0;
+}
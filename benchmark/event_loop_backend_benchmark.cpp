@@ -0,0 +1,120 @@
+// This benchmark compares request rate between epoll-based and io_uring-based eventloop backends.
+//
+// A fixed number of small range requests are kept in flight against the given URL, so the cost is dominated by
+// per-transfer eventloop overhead rather than bandwidth; point it to a server close by (i.e. on loopback), otherwise
+// network latency dominates.
+//
+// Usage: event_loop_backend_benchmark [url]
+
+#include <array>
+#include <chrono>
+#include <curl/curl.h>
+#include <iostream>
+#include <sys/resource.h>
+
+#include "curl_completion_queue.hpp"
+#include "curl_request.hpp"
+#include "duckdb/common/helper.hpp"
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/unique_ptr.hpp"
+#include "duckdb/common/vector.hpp"
+#include "extension_config.hpp"
+#include "io_uring_ring.hpp"
+#include "multi_curl_manager.hpp"
+
+using namespace duckdb; // NOLINT
+
+namespace {
+
+// Default URL to request, which serves the test data file over HTTP/1.1.
+constexpr const char *DEFAULT_URL =
+    "https://raw.githubusercontent.com/dentiny/duck-read-cache-fs/main/test/data/stock-exchanges.csv";
+// Number of requests kept in flight.
+constexpr std::array<idx_t, 3> TEST_CONCURRENCIES = {16, 64, 256};
+// Number of requests issued per benchmark.
+constexpr idx_t REQUEST_COUNT = 20000;
+// Bytes requested per request.
+constexpr idx_t RANGE_SIZE = 1024;
+
+const char *GetBackendName(EventLoopBackend backend) {
+	return backend == EventLoopBackend::IO_URING ? "io_uring" : "epoll";
+}
+
+// Number of context switches of the process so far, which approximates blocking syscalls in eventloops.
+long GetContextSwitchCount() {
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_nvcsw + usage.ru_nivcsw;
+}
+
+void RunBenchmark(CurlEventLoop &event_loop, const string &url, idx_t concurrency) {
+	CurlCompletionQueue completion_queue;
+	const string range_header = "Range: bytes=0-" + std::to_string(RANGE_SIZE - 1);
+	curl_slist *headers = curl_slist_append(nullptr, range_header.c_str());
+
+	// Each in-flight slot reuses its easy handle, so connections are kept alive.
+	vector<CURL *> easy_curls(concurrency, nullptr);
+	auto submit = [&](idx_t slot) {
+		auto req = make_uniq<CurlRequest>(easy_curls[slot]);
+		req->SetUrl(url);
+		req->SetHeaders(headers);
+		req->SetGetAttrs();
+		req->SetCompletionCallback(completion_queue.CreateCallback(/*tag=*/slot));
+		event_loop.SubmitRequest(std::move(req));
+	};
+
+	const long start_context_switches = GetContextSwitchCount();
+	const auto start = std::chrono::steady_clock::now();
+	idx_t submitted = 0;
+	for (idx_t slot = 0; slot < concurrency && submitted < REQUEST_COUNT; ++slot, ++submitted) {
+		easy_curls[slot] = curl_easy_init();
+		submit(slot);
+	}
+	idx_t failed = 0;
+	for (idx_t completed = 0; completed < REQUEST_COUNT; ++completed) {
+		auto completion = completion_queue.Pop();
+		if (completion.response->HasRequestError() || !completion.response->Success()) {
+			++failed;
+		}
+		if (submitted < REQUEST_COUNT) {
+			submit(completion.tag);
+			++submitted;
+		}
+	}
+	const auto end = std::chrono::steady_clock::now();
+	const long context_switches = GetContextSwitchCount() - start_context_switches;
+
+	for (auto *easy_curl : easy_curls) {
+		curl_easy_cleanup(easy_curl);
+	}
+	curl_slist_free_all(headers);
+
+	const auto duration_us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+	std::cout << GetBackendName(event_loop.GetBackend()) << " backend with concurrency " << concurrency << " takes "
+	          << duration_us / 1000 << " milliseconds, " << REQUEST_COUNT * 1000000 / std::max<int64_t>(duration_us, 1)
+	          << " requests per second, " << static_cast<double>(context_switches) / REQUEST_COUNT
+	          << " context switches per request, " << failed << " failed requests" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	curl_global_init(CURL_GLOBAL_DEFAULT);
+	const string url = argc > 1 ? argv[1] : DEFAULT_URL;
+
+	vector<EventLoopBackend> backends {EventLoopBackend::EPOLL};
+	if (IoUring::IsSupported()) {
+		backends.emplace_back(EventLoopBackend::IO_URING);
+	} else {
+		std::cout << "io_uring is not supported by the kernel, only benchmark epoll backend" << std::endl;
+	}
+
+	for (idx_t cur_concurrency : TEST_CONCURRENCIES) {
+		for (auto cur_backend : backends) {
+			// Eventloops are never destroyed, same as those owned by the manager.
+			auto *event_loop = new CurlEventLoop(cur_backend);
+			RunBenchmark(*event_loop, url, cur_concurrency);
+		}
+	}
+	return 0;
+}
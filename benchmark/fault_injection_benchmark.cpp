@@ -0,0 +1,243 @@
+// This benchmark measures tail latency of range reads issued via `MultiCurlManager`, when a fraction of requests hits
+// faults seen in production: slow first byte, mid-body stalls, connection resets, 503 SlowDown and truncated bodies.
+//
+// Faults are injected at random by the in-process loopback server with a fixed seed, so runs are repeatable. A fixed
+// number of requests are kept in flight via asynchronous submission, each on its own easy handle; results are written
+// to stdout as CSV (default) or JSON lines, one row per fault scenario.
+//
+// Note that curl silently retries requests whose reused connection is reset before any response, so connection resets
+// mostly show up in latency rather than request errors. Over HTTP/2 a reset fails all streams multiplexed on the
+// connection.
+//
+// Usage: fault_injection_benchmark [--requests=N] [--concurrency=N] [--block-size=BYTES] [--fault-rate=RATE]
+//                                  [--fault-delay-ms=MS] [--deadline-ms=MS] [--http2] [--format=csv|json]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <curl/curl.h>
+#include <iostream>
+
+#include "curl_completion_queue.hpp"
+#include "curl_request.hpp"
+#include "duckdb/common/helper.hpp"
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/common/unique_ptr.hpp"
+#include "duckdb/common/vector.hpp"
+#include "latency_histogram.hpp"
+#include "loopback_range_server.hpp"
+#include "multi_curl_manager.hpp"
+
+using namespace duckdb; // NOLINT
+
+namespace {
+
+// Number of blocks in the served object, requests read them in turn.
+constexpr idx_t OBJECT_BLOCK_COUNT = 64;
+// Curl timeout, which bounds requests stalled beyond the deadline if there's none.
+constexpr long CURL_TIMEOUT_MS = 60000;
+
+struct BenchmarkOptions {
+	idx_t requests = 2000;
+	// Number of requests kept in flight.
+	idx_t concurrency = 32;
+	idx_t block_size = 256 * 1024;
+	// Probability of each request to hit the fault of the scenario.
+	double fault_rate = 0.01;
+	uint64_t fault_delay_ms = 200;
+	// Request deadline, 0 means no deadline.
+	uint64_t deadline_ms = 0;
+	bool http2 = false;
+	string format = "csv";
+};
+
+struct FaultScenario {
+	const char *name;
+	// Faults injected, each with the fault rate divided evenly.
+	vector<LoopbackFault> faults;
+};
+
+const vector<FaultScenario> FAULT_SCENARIOS = {
+    {"none", {}},
+    {"slow_first_byte", {LoopbackFault::SLOW_FIRST_BYTE}},
+    {"mid_body_stall", {LoopbackFault::MID_BODY_STALL}},
+    {"connection_reset", {LoopbackFault::CONNECTION_RESET}},
+    {"slow_down", {LoopbackFault::SLOW_DOWN}},
+    {"truncated_body", {LoopbackFault::TRUNCATED_BODY}},
+    {"mixed",
+     {LoopbackFault::SLOW_FIRST_BYTE, LoopbackFault::MID_BODY_STALL, LoopbackFault::CONNECTION_RESET,
+      LoopbackFault::SLOW_DOWN, LoopbackFault::TRUNCATED_BODY}},
+};
+
+struct BenchmarkResult {
+	string scenario;
+	uint64_t requests = 0;
+	uint64_t faults = 0;
+	// Requests which complete with a request error, e.g. reset, truncated or beyond deadline.
+	uint64_t request_errors = 0;
+	// Requests which complete with a non-2xx status.
+	uint64_t error_statuses = 0;
+	uint64_t duration_us = 0;
+	LatencyHistogram::Snapshot latency;
+};
+
+// A request slot, which keeps one request in flight at a time.
+struct RequestSlot {
+	CURL *easy_curl = nullptr;
+	curl_slist *headers = nullptr;
+	std::chrono::steady_clock::time_point start;
+};
+
+unique_ptr<CurlRequest> CreateRequest(const BenchmarkOptions &options, const string &url, RequestSlot &slot,
+                                      uint64_t tag, idx_t request_idx, CurlCompletionQueue &completion_queue) {
+	curl_slist_free_all(slot.headers);
+	const idx_t start_offset = (request_idx % OBJECT_BLOCK_COUNT) * options.block_size;
+	const string range = StringUtil::Format("Range: bytes=%llu-%llu", start_offset, start_offset + options.block_size - 1);
+	slot.headers = curl_slist_append(nullptr, range.c_str());
+	slot.start = std::chrono::steady_clock::now();
+
+	auto req = make_uniq<CurlRequest>(slot.easy_curl);
+	req->SetUrl(url);
+	req->SetHeaders(slot.headers);
+	req->SetGetAttrs();
+	req->SetCompletionCallback(completion_queue.CreateCallback(tag));
+	if (options.deadline_ms > 0) {
+		req->SetDeadline(slot.start + std::chrono::milliseconds(options.deadline_ms));
+	}
+	return req;
+}
+
+BenchmarkResult RunBenchmark(const BenchmarkOptions &options, const FaultScenario &scenario) {
+	LoopbackRangeServerConfig config;
+	config.object_size = options.block_size * OBJECT_BLOCK_COUNT;
+	config.enable_http2 = options.http2;
+	config.fault_delay = std::chrono::milliseconds(options.fault_delay_ms);
+	for (auto cur_fault : scenario.faults) {
+		config.fault_probabilities.push_back(
+		    {cur_fault, options.fault_rate / static_cast<double>(scenario.faults.size())});
+	}
+	LoopbackRangeServer server {config};
+	const string url = server.GetUrl();
+
+	vector<RequestSlot> slots(std::min(options.concurrency, options.requests));
+	for (auto &cur_slot : slots) {
+		cur_slot.easy_curl = curl_easy_init();
+		curl_easy_setopt(cur_slot.easy_curl, CURLOPT_TIMEOUT_MS, CURL_TIMEOUT_MS);
+		if (options.http2) {
+			// Upgraded from HTTP/1.1 rather than prior knowledge, which older libcurl fails to reuse in multi mode.
+			curl_easy_setopt(cur_slot.easy_curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2_0);
+		}
+	}
+
+	BenchmarkResult result;
+	result.scenario = scenario.name;
+	LatencyHistogram latency;
+	CurlCompletionQueue completion_queue;
+	auto &manager = MultiCurlManager::GetInstance();
+
+	const auto start = std::chrono::steady_clock::now();
+	idx_t submitted = 0;
+	for (idx_t slot_idx = 0; slot_idx < slots.size(); ++slot_idx, ++submitted) {
+		manager.SubmitRequest(
+		    CreateRequest(options, url, slots[slot_idx], /*tag=*/slot_idx, submitted, completion_queue));
+	}
+	for (idx_t completed = 0; completed < options.requests; ++completed) {
+		auto completion = completion_queue.Pop();
+		auto &slot = slots[completion.tag];
+		latency.Record(
+		    std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - slot.start)
+		        .count());
+		if (completion.response->HasRequestError()) {
+			++result.request_errors;
+		} else if (static_cast<int>(completion.response->status) >= 300) {
+			++result.error_statuses;
+		}
+		if (submitted < options.requests) {
+			manager.SubmitRequest(CreateRequest(options, url, slot, completion.tag, submitted, completion_queue));
+			++submitted;
+		}
+	}
+	const auto end = std::chrono::steady_clock::now();
+
+	for (auto &cur_slot : slots) {
+		curl_slist_free_all(cur_slot.headers);
+		curl_easy_cleanup(cur_slot.easy_curl);
+	}
+	result.requests = options.requests;
+	result.faults = server.GetFaultCount();
+	result.duration_us =
+	    static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+	result.latency = latency.GetSnapshot();
+	return result;
+}
+
+void PrintResult(const BenchmarkOptions &options, const BenchmarkResult &result) {
+	const char *protocol = options.http2 ? "h2c" : "http1.1";
+	if (options.format == "json") {
+		std::cout << StringUtil::Format(
+		                 "{\"scenario\":\"%s\",\"server_protocol\":\"%s\",\"fault_rate\":%.4f,\"requests\":%llu,"
+		                 "\"faults\":%llu,\"request_errors\":%llu,\"error_statuses\":%llu,\"duration_us\":%llu,"
+		                 "\"p50_us\":%llu,\"p99_us\":%llu,\"p999_us\":%llu,\"max_us\":%llu}",
+		                 result.scenario, protocol, options.fault_rate, result.requests, result.faults,
+		                 result.request_errors, result.error_statuses, result.duration_us,
+		                 result.latency.GetPercentile(0.5), result.latency.GetPercentile(0.99),
+		                 result.latency.GetPercentile(0.999), result.latency.max_us)
+		          << std::endl;
+		return;
+	}
+	std::cout << StringUtil::Format("%s,%s,%.4f,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu", result.scenario,
+	                                protocol, options.fault_rate, result.requests, result.faults,
+	                                result.request_errors, result.error_statuses, result.duration_us,
+	                                result.latency.GetPercentile(0.5), result.latency.GetPercentile(0.99),
+	                                result.latency.GetPercentile(0.999), result.latency.max_us)
+	          << std::endl;
+}
+
+BenchmarkOptions ParseOptions(int argc, char **argv) {
+	BenchmarkOptions options;
+	for (int idx = 1; idx < argc; ++idx) {
+		const string arg = argv[idx];
+		const auto eq_pos = arg.find('=');
+		const string key = arg.substr(0, eq_pos);
+		const string value = eq_pos == string::npos ? "" : arg.substr(eq_pos + 1);
+		if (key == "--requests" && std::stoull(value) > 0) {
+			options.requests = std::stoull(value);
+		} else if (key == "--concurrency" && std::stoull(value) > 0) {
+			options.concurrency = std::stoull(value);
+		} else if (key == "--block-size" && std::stoull(value) > 0) {
+			options.block_size = std::stoull(value);
+		} else if (key == "--fault-rate") {
+			options.fault_rate = std::stod(value);
+		} else if (key == "--fault-delay-ms") {
+			options.fault_delay_ms = std::stoull(value);
+		} else if (key == "--deadline-ms") {
+			options.deadline_ms = std::stoull(value);
+		} else if (key == "--http2") {
+			options.http2 = true;
+		} else if (key == "--format" && (value == "csv" || value == "json")) {
+			options.format = value;
+		} else {
+			std::cerr << "Unknown argument " << arg << std::endl;
+			std::exit(1);
+		}
+	}
+	return options;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	const auto options = ParseOptions(argc, argv);
+	curl_global_init(CURL_GLOBAL_DEFAULT);
+
+	if (options.format == "csv") {
+		std::cout << "scenario,server_protocol,fault_rate,requests,faults,request_errors,error_statuses,duration_us,"
+		             "p50_us,p99_us,p999_us,max_us"
+		          << std::endl;
+	}
+	for (const auto &cur_scenario : FAULT_SCENARIOS) {
+		PrintResult(options, RunBenchmark(options, cur_scenario));
+	}
+	return 0;
+}
@@ -1,13 +1,24 @@
-// This benchmark compares the performance under heavy load read request, between httplib and multi-curl based
-// implementation.
+// This benchmark compares range read throughput and latency between httplib, curl and multi-curl based
+// implementations, against an in-process loopback server so results are repeatable and don't need network access.
+//
+// For each block size and implementation, the object is read in blocks by concurrent threads sharing one file handle;
+// results are written to stdout as CSV (default) or JSON lines, one row per run.
+//
+// Usage: multicurl_benchmark [--object-size=BYTES] [--latency-us=US] [--bandwidth-mbps=MBPS] [--http2]
+//                            [--concurrency=N] [--max-requests=N] [--iterations=N] [--format=csv|json]
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <chrono>
+#include <cstdlib>
+#include <iostream>
 
 #include "duckdb.hpp"
 #include "duckdb/common/helper.hpp"
 #include "duckdb/common/http_util.hpp"
 #include "duckdb/common/string.hpp"
+#include "duckdb/common/string_util.hpp"
 #include "duckdb/common/unique_ptr.hpp"
 #include "duckdb/common/shared_ptr.hpp"
 #include "duckdb/common/vector.hpp"
@@ -16,84 +27,197 @@
 #include "duckdb/main/client_context_file_opener.hpp"
 #include "httpfs.hpp"
 #include "httpfs_client.hpp"
-#include "multi_curl_manager.hpp"
+#include "latency_histogram.hpp"
+#include "loopback_range_server.hpp"
+#include "multi_curl_util.hpp"
 #include "thread_pool.hpp"
 
 using namespace duckdb; // NOLINT
 
-// Spawn a number of threads for concurrent IO requests.
-constexpr size_t CONCURRENCY = 2000;
-// Benchmark iteration count.
-constexpr idx_t ITERATION_COUNT = 5;
+namespace {
+
 // Test block sizes.
 constexpr std::array<idx_t, 7> TEST_BLOCK_SIZES = {32,         256,         2 * 1024,       16 * 1024,
                                                    128 * 1024, 1024 * 1024, 2 * 1024 * 1024};
+// Implementations to compare, named after values of `curl_httpfs_client_implementation`.
+constexpr std::array<const char *, 3> IMPLEMENTATIONS = {"httplib", "curl", "multi_curl"};
 
-// Handle single IO request: one HEAD request + one GET request.
-void HandleSingleRequest(ClientContextFileOpener *file_opener, idx_t start_offset, idx_t bytes_to_read,
-                         idx_t file_size) {
-	HTTPFileSystem fs {};
-	string url = "https://raw.githubusercontent.com/dentiny/duck-read-cache-fs/main/test/data/stock-exchanges.csv";
-	auto file_handle = fs.OpenFile(url, FileOpenFlags::FILE_FLAGS_READ, file_opener);
+struct BenchmarkOptions {
+	idx_t object_size = 64 * 1024 * 1024;
+	uint64_t latency_us = 0;
+	uint64_t bandwidth_mbps = 0;
+	bool http2 = false;
+	// Number of threads issuing reads concurrently.
+	idx_t concurrency = 64;
+	// Max number of reads per iteration, so small block sizes don't take forever.
+	idx_t max_requests = 4096;
+	idx_t iterations = 3;
+	string format = "csv";
+};
+
+struct BenchmarkResult {
+	string implementation;
+	idx_t block_size = 0;
+	uint64_t requests = 0;
+	uint64_t failed_requests = 0;
+	uint64_t bytes = 0;
+	uint64_t duration_us = 0;
+	LatencyHistogram::Snapshot latency;
+};
 
-	bytes_to_read = std::min(bytes_to_read, file_size - start_offset);
-	string buffer(bytes_to_read, '\0');
-	file_handle->Read(static_cast<void *>(const_cast<char *>(buffer.data())), bytes_to_read, /*location=*/start_offset);
+shared_ptr<HTTPUtil> CreateHttpUtil(const string &implementation) {
+	if (implementation == "httplib") {
+		return make_shared_ptr<HTTPFSUtil>();
+	}
+	if (implementation == "curl") {
+		return make_shared_ptr<HTTPFSCurlUtil>();
+	}
+	return make_shared_ptr<MultiCurlUtil>();
 }
 
-// Read a remote object via httpfs.
-void PerformBenchmarkImpl(shared_ptr<HTTPFSUtil> httpfs_util, idx_t block_size) {
+// Read the object in blocks of the given size with the given implementation, and accumulate into the result.
+void PerformBenchmarkImpl(const BenchmarkOptions &options, const string &url, const string &implementation,
+                          idx_t block_size, LatencyHistogram &latency, BenchmarkResult &result) {
 	DuckDB db(nullptr);
 	auto &instance = db.instance;
-	instance->config.http_util = make_shared_ptr<HTTPFSCurlUtil>();
+	instance->config.SetHTTPUtil(CreateHttpUtil(implementation));
 	auto client_context = make_shared_ptr<ClientContext>(instance);
 	client_context->transaction.BeginTransaction();
 	ClientContextFileOpener file_opener {*client_context};
 
 	HTTPFileSystem fs {};
-	string url = "https://raw.githubusercontent.com/dentiny/duck-read-cache-fs/main/test/data/stock-exchanges.csv";
-	auto file_handle = fs.OpenFile(url, FileOpenFlags::FILE_FLAGS_READ, &file_opener);
+	auto file_handle =
+	    fs.OpenFile(url, FileOpenFlags::FILE_FLAGS_READ | FileOpenFlags::FILE_FLAGS_PARALLEL_ACCESS, &file_opener);
 	const idx_t file_size = file_handle->GetFileSize();
+	const idx_t request_count = std::min(options.max_requests, (file_size + block_size - 1) / block_size);
 
-	ThreadPool tp {CONCURRENCY};
-	for (idx_t cur_start_offset = 0; cur_start_offset < file_size; cur_start_offset += block_size) {
-		tp.Push([cur_start_offset, &file_opener, block_size, file_size]() {
-			HandleSingleRequest(&file_opener, cur_start_offset, block_size, file_size);
-		});
+	std::atomic<uint64_t> failed_requests {0};
+	const auto start = std::chrono::steady_clock::now();
+	{
+		ThreadPool tp {options.concurrency};
+		for (idx_t request_idx = 0; request_idx < request_count; ++request_idx) {
+			const idx_t start_offset = request_idx * block_size;
+			const idx_t bytes_to_read = std::min(block_size, file_size - start_offset);
+			tp.Push([&file_handle, &latency, &failed_requests, start_offset, bytes_to_read]() {
+				string buffer(bytes_to_read, '\0');
+				const auto read_start = std::chrono::steady_clock::now();
+				try {
+					file_handle->Read(static_cast<void *>(const_cast<char *>(buffer.data())), bytes_to_read,
+					                  /*location=*/start_offset);
+				} catch (...) {
+					failed_requests.fetch_add(1);
+					return;
+				}
+				latency.Record(std::chrono::duration_cast<std::chrono::microseconds>(
+				                   std::chrono::steady_clock::now() - read_start)
+				                   .count());
+				// Check both ends of the block, which catches misplaced ranges.
+				if (buffer.front() != LoopbackRangeServer::GetGeneratedByte(start_offset) ||
+				    buffer.back() != LoopbackRangeServer::GetGeneratedByte(start_offset + bytes_to_read - 1)) {
+					failed_requests.fetch_add(1);
+				}
+			});
+		}
+		tp.Wait();
 	}
-	tp.Wait();
+	const auto end = std::chrono::steady_clock::now();
+
+	result.requests += request_count;
+	result.failed_requests += failed_requests.load();
+	result.bytes += std::min(request_count * block_size, file_size);
+	result.duration_us +=
+	    static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
 }
 
-// Benchmark httplib-based http filesystem.
-void BenchmarkHttplib(idx_t block_size) {
-	const auto start = std::chrono::steady_clock::now();
-	for (idx_t ii = 0; ii < ITERATION_COUNT; ++ii) {
-		auto http_util = make_shared_ptr<HTTPFSUtil>();
-		PerformBenchmarkImpl(std::move(http_util), block_size);
+BenchmarkResult RunBenchmark(const BenchmarkOptions &options, const string &url, const string &implementation,
+                             idx_t block_size) {
+	BenchmarkResult result;
+	result.implementation = implementation;
+	result.block_size = block_size;
+	LatencyHistogram latency;
+	for (idx_t iteration = 0; iteration < options.iterations; ++iteration) {
+		PerformBenchmarkImpl(options, url, implementation, block_size, latency, result);
 	}
-	const auto end = std::chrono::steady_clock::now();
-	auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
-	std::cout << "httplib-based IO operation with block size " << block_size << " takes " << duration.count()
-	          << " milliseconds" << std::endl;
+	result.latency = latency.GetSnapshot();
+	return result;
 }
 
-// Benchmark multi-curl-based http filesystem.
-void BenchmarkMultiCurl(idx_t block_size) {
-	const auto start = std::chrono::steady_clock::now();
-	for (idx_t ii = 0; ii < ITERATION_COUNT; ++ii) {
-		auto http_util = make_shared_ptr<HTTPFSCurlUtil>();
-		PerformBenchmarkImpl(std::move(http_util), block_size);
+void PrintResult(const BenchmarkOptions &options, const BenchmarkResult &result) {
+	const double throughput_mib_per_sec = static_cast<double>(result.bytes) / (1024.0 * 1024.0) /
+	                                      (static_cast<double>(std::max<uint64_t>(result.duration_us, 1)) / 1e6);
+	const char *protocol = options.http2 ? "h2c" : "http1.1";
+	if (options.format == "json") {
+		std::cout << StringUtil::Format(
+		                 "{\"implementation\":\"%s\",\"server_protocol\":\"%s\",\"block_size\":%llu,\"requests\":%llu,"
+		                 "\"failed_requests\":%llu,\"bytes\":%llu,\"duration_us\":%llu,\"throughput_mib_per_sec\":%.2f,"
+		                 "\"p50_us\":%llu,\"p99_us\":%llu,\"max_us\":%llu}",
+		                 result.implementation, protocol, result.block_size, result.requests, result.failed_requests,
+		                 result.bytes, result.duration_us, throughput_mib_per_sec, result.latency.GetPercentile(0.5),
+		                 result.latency.GetPercentile(0.99), result.latency.max_us)
+		          << std::endl;
+		return;
 	}
-	const auto end = std::chrono::steady_clock::now();
-	auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
-	std::cout << "multi-curl-based IO operation with block size " << block_size << " takes " << duration.count()
-	          << " milliseconds" << std::endl;
+	std::cout << StringUtil::Format("%s,%s,%llu,%llu,%llu,%llu,%llu,%.2f,%llu,%llu,%llu", result.implementation,
+	                                protocol, result.block_size, result.requests, result.failed_requests,
+	                                result.bytes, result.duration_us, throughput_mib_per_sec,
+	                                result.latency.GetPercentile(0.5), result.latency.GetPercentile(0.99),
+	                                result.latency.max_us)
+	          << std::endl;
+}
+
+BenchmarkOptions ParseOptions(int argc, char **argv) {
+	BenchmarkOptions options;
+	for (int idx = 1; idx < argc; ++idx) {
+		const string arg = argv[idx];
+		const auto eq_pos = arg.find('=');
+		const string key = arg.substr(0, eq_pos);
+		const string value = eq_pos == string::npos ? "" : arg.substr(eq_pos + 1);
+		if (key == "--object-size") {
+			options.object_size = std::stoull(value);
+		} else if (key == "--latency-us") {
+			options.latency_us = std::stoull(value);
+		} else if (key == "--bandwidth-mbps") {
+			options.bandwidth_mbps = std::stoull(value);
+		} else if (key == "--http2") {
+			options.http2 = true;
+		} else if (key == "--concurrency") {
+			options.concurrency = std::stoull(value);
+		} else if (key == "--max-requests") {
+			options.max_requests = std::stoull(value);
+		} else if (key == "--iterations") {
+			options.iterations = std::stoull(value);
+		} else if (key == "--format" && (value == "csv" || value == "json")) {
+			options.format = value;
+		} else {
+			std::cerr << "Unknown argument " << arg << std::endl;
+			std::exit(1);
+		}
+	}
+	return options;
 }
 
-int main() {
+} // namespace
+
+int main(int argc, char **argv) {
+	const auto options = ParseOptions(argc, argv);
+
+	LoopbackRangeServerConfig config;
+	config.object_size = options.object_size;
+	config.latency = std::chrono::microseconds(options.latency_us);
+	config.bandwidth_bytes_per_sec = options.bandwidth_mbps * 1000 * 1000 / 8;
+	config.enable_http2 = options.http2;
+	LoopbackRangeServer server {config};
+	const string url = server.GetUrl();
+
+	if (options.format == "csv") {
+		std::cout << "implementation,server_protocol,block_size,requests,failed_requests,bytes,duration_us,"
+		             "throughput_mib_per_sec,p50_us,p99_us,max_us"
+		          << std::endl;
+	}
 	for (idx_t cur_block_size : TEST_BLOCK_SIZES) {
-		BenchmarkHttplib(cur_block_size);
-		BenchmarkMultiCurl(cur_block_size);
+		for (const auto *cur_implementation : IMPLEMENTATIONS) {
+			PrintResult(options, RunBenchmark(options, url, cur_implementation, cur_block_size));
+		}
 	}
 	return 0;
 }
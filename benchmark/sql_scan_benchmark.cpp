@@ -0,0 +1,289 @@
+// This benchmark runs end-to-end scan queries over S3 against a local S3 stand-in, and compares httplib, curl and
+// multi-curl based implementations on what users actually see: query wall time, number of HTTP requests and bytes
+// transferred.
+//
+// Test data is generated locally into a parquet file and a DuckDB database file, which are served by an in-process
+// loopback server with path-style S3 URLs; request signatures are not checked. Request counts and bytes are taken from
+// httpfs `HTTPState` of each query. Results are written to stdout as CSV (default) or JSON lines, one row per query and
+// implementation.
+//
+// Usage: sql_scan_benchmark [--rows=N] [--latency-us=US] [--bandwidth-mbps=MBPS] [--http2] [--iterations=N]
+//                           [--threads=N] [--format=csv|json]
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <unistd.h>
+
+#include "curl_httpfs_extension.hpp"
+#include "duckdb.hpp"
+#include "duckdb/common/helper.hpp"
+#include "duckdb/common/shared_ptr.hpp"
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/common/vector.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "http_state.hpp"
+#include "loopback_range_server.hpp"
+
+using namespace duckdb; // NOLINT
+
+namespace {
+
+// Implementations to compare, named after values of `curl_httpfs_client_implementation`.
+constexpr std::array<const char *, 3> IMPLEMENTATIONS = {"httplib", "curl", "multi_curl"};
+constexpr const char *BUCKET = "bench";
+constexpr const char *PARQUET_KEY = "lineitem.parquet";
+constexpr const char *DATABASE_KEY = "orders.duckdb";
+
+struct BenchmarkOptions {
+	idx_t rows = 2000000;
+	uint64_t latency_us = 0;
+	uint64_t bandwidth_mbps = 0;
+	bool http2 = false;
+	idx_t iterations = 3;
+	// DuckDB worker threads, 0 means the default.
+	idx_t threads = 0;
+	string format = "csv";
+};
+
+struct BenchmarkQuery {
+	const char *name;
+	// Statements run before and after the timed query, not timed.
+	const char *setup;
+	const char *query;
+	const char *teardown;
+};
+
+// `{parquet}` and `{database}` are replaced with S3 URLs of test data.
+const vector<BenchmarkQuery> BENCHMARK_QUERIES = {
+    {"parquet_count", "", "SELECT count(*) FROM read_parquet('{parquet}')", ""},
+    {"parquet_aggregate", "",
+     "SELECT l_returnflag, sum(l_extendedprice * (1 - l_discount)), avg(l_quantity) FROM read_parquet('{parquet}') "
+     "GROUP BY l_returnflag",
+     ""},
+    {"parquet_filter", "",
+     "SELECT count(*), sum(l_extendedprice) FROM read_parquet('{parquet}') WHERE l_shipdate BETWEEN DATE '1995-01-01' "
+     "AND DATE '1995-03-31'",
+     ""},
+    {"parquet_wide_column", "", "SELECT max(length(l_comment)) FROM read_parquet('{parquet}')", ""},
+    {"attach", "", "ATTACH '{database}' AS remote (READ_ONLY)", "DETACH remote"},
+    {"attach_aggregate", "ATTACH '{database}' AS remote (READ_ONLY)",
+     "SELECT o_orderstatus, count(*), sum(o_totalprice) FROM remote.orders GROUP BY o_orderstatus", "DETACH remote"},
+};
+
+// HTTP state which keeps counters of the last finished query, since httpfs resets them on query end.
+class CapturingHTTPState : public HTTPState {
+public:
+	struct Counters {
+		idx_t head_count = 0;
+		idx_t get_count = 0;
+		idx_t put_count = 0;
+		idx_t post_count = 0;
+		idx_t delete_count = 0;
+		idx_t bytes_received = 0;
+		idx_t bytes_sent = 0;
+	};
+
+	void QueryEnd(ClientContext &context) override {
+		last_query.head_count = head_count.load();
+		last_query.get_count = get_count.load();
+		last_query.put_count = put_count.load();
+		last_query.post_count = post_count.load();
+		last_query.delete_count = delete_count.load();
+		last_query.bytes_received = total_bytes_received.load();
+		last_query.bytes_sent = total_bytes_sent.load();
+		HTTPState::QueryEnd(context);
+	}
+
+	Counters last_query;
+};
+
+struct BenchmarkResult {
+	string implementation;
+	string query;
+	// Wall time of each iteration.
+	vector<uint64_t> durations_us;
+	// Counters of the last iteration.
+	CapturingHTTPState::Counters counters;
+};
+
+string ReadFile(const string &path) {
+	std::ifstream file {path, std::ios::binary};
+	std::stringstream content;
+	content << file.rdbuf();
+	return content.str();
+}
+
+// Generate test data locally, and put it into the server.
+void GenerateTestData(const BenchmarkOptions &options, LoopbackRangeServer &server) {
+	const string parquet_path = StringUtil::Format("/tmp/curl_httpfs_sql_scan_benchmark_%d.parquet", getpid());
+	const string database_path = StringUtil::Format("/tmp/curl_httpfs_sql_scan_benchmark_%d.duckdb", getpid());
+	std::remove(database_path.c_str());
+
+	DuckDB db(nullptr);
+	Connection con {db};
+	auto run = [&con](const string &sql) {
+		auto result = con.Query(sql);
+		if (result->HasError()) {
+			std::cerr << "Failed to generate test data: " << result->GetError() << std::endl;
+			std::exit(1);
+		}
+	};
+	run(StringUtil::Format(
+	    "COPY (SELECT i AS l_orderkey, hash(i) %% 200000 AS l_partkey, (i %% 50 + 1)::DECIMAL(15, 2) AS l_quantity, "
+	    "(hash(i) %% 10000000 / 100)::DECIMAL(15, 2) AS l_extendedprice, (i %% 11 / 100)::DECIMAL(15, 2) AS "
+	    "l_discount, DATE '1992-01-01' + (i %% 2500)::INTEGER AS l_shipdate, ['A', 'N', 'R'][i %% 3 + 1] AS "
+	    "l_returnflag, md5(i::VARCHAR) || md5((i + 1)::VARCHAR) AS l_comment FROM range(%llu) t(i)) TO '%s' "
+	    "(FORMAT parquet)",
+	    options.rows, parquet_path));
+	run(StringUtil::Format("ATTACH '%s' AS local_db", database_path));
+	run(StringUtil::Format(
+	    "CREATE TABLE local_db.orders AS SELECT i AS o_orderkey, ['F', 'O', 'P'][i %% 3 + 1] AS o_orderstatus, "
+	    "(hash(i) %% 50000000 / 100)::DECIMAL(15, 2) AS o_totalprice FROM range(%llu) t(i)",
+	    options.rows / 4));
+	run("DETACH local_db");
+
+	server.PutObject(StringUtil::Format("/%s/%s", BUCKET, PARQUET_KEY), ReadFile(parquet_path));
+	server.PutObject(StringUtil::Format("/%s/%s", BUCKET, DATABASE_KEY), ReadFile(database_path));
+	std::remove(parquet_path.c_str());
+	std::remove(database_path.c_str());
+}
+
+string SubstituteUrls(const string &sql) {
+	auto result = StringUtil::Replace(sql, "{parquet}", StringUtil::Format("s3://%s/%s", BUCKET, PARQUET_KEY));
+	return StringUtil::Replace(result, "{database}", StringUtil::Format("s3://%s/%s", BUCKET, DATABASE_KEY));
+}
+
+vector<BenchmarkResult> RunBenchmark(const BenchmarkOptions &options, const LoopbackRangeServer &server,
+                                     const string &implementation) {
+	DuckDB db(nullptr);
+	db.LoadStaticExtension<CurlHttpfsExtension>();
+	Connection con {db};
+	auto http_state = con.context->registered_state->GetOrCreate<CapturingHTTPState>("http_state");
+	auto run = [&con](const string &sql) {
+		if (sql.empty()) {
+			return;
+		}
+		auto result = con.Query(sql);
+		if (result->HasError()) {
+			std::cerr << "Failed to run `" << sql << "`: " << result->GetError() << std::endl;
+			std::exit(1);
+		}
+	};
+	run(StringUtil::Format("SET curl_httpfs_client_implementation='%s'", implementation));
+	// Every iteration should hit the server, rather than caches.
+	run("SET enable_http_metadata_cache=false");
+	run("SET enable_external_file_cache=false");
+	if (options.threads > 0) {
+		run(StringUtil::Format("SET threads=%llu", options.threads));
+	}
+	run(StringUtil::Format("CREATE SECRET bench_secret (TYPE s3, KEY_ID 'bench', SECRET 'bench', REGION 'us-east-1', "
+	                       "ENDPOINT '127.0.0.1:%d', URL_STYLE 'path', USE_SSL false)",
+	                       server.GetPort()));
+
+	vector<BenchmarkResult> results;
+	for (const auto &cur_query : BENCHMARK_QUERIES) {
+		BenchmarkResult result;
+		result.implementation = implementation;
+		result.query = cur_query.name;
+		for (idx_t iteration = 0; iteration < options.iterations; ++iteration) {
+			run(SubstituteUrls(cur_query.setup));
+			const auto start = std::chrono::steady_clock::now();
+			run(SubstituteUrls(cur_query.query));
+			const auto end = std::chrono::steady_clock::now();
+			result.counters = http_state->last_query;
+			run(SubstituteUrls(cur_query.teardown));
+			result.durations_us.emplace_back(
+			    std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+		}
+		results.emplace_back(std::move(result));
+	}
+	return results;
+}
+
+void PrintResult(const BenchmarkOptions &options, BenchmarkResult result) {
+	std::sort(result.durations_us.begin(), result.durations_us.end());
+	const uint64_t min_us = result.durations_us.front();
+	const uint64_t median_us = result.durations_us[result.durations_us.size() / 2];
+	const auto &counters = result.counters;
+	const char *protocol = options.http2 ? "h2c" : "http1.1";
+	if (options.format == "json") {
+		std::cout << StringUtil::Format(
+		                 "{\"implementation\":\"%s\",\"server_protocol\":\"%s\",\"query\":\"%s\",\"iterations\":%llu,"
+		                 "\"min_us\":%llu,\"median_us\":%llu,\"head_requests\":%llu,\"get_requests\":%llu,"
+		                 "\"put_requests\":%llu,\"post_requests\":%llu,\"delete_requests\":%llu,"
+		                 "\"bytes_received\":%llu,\"bytes_sent\":%llu}",
+		                 result.implementation, protocol, result.query, options.iterations, min_us, median_us,
+		                 counters.head_count, counters.get_count, counters.put_count, counters.post_count,
+		                 counters.delete_count, counters.bytes_received, counters.bytes_sent)
+		          << std::endl;
+		return;
+	}
+	std::cout << StringUtil::Format("%s,%s,%s,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu",
+	                                result.implementation, protocol, result.query, options.iterations, min_us,
+	                                median_us, counters.head_count, counters.get_count, counters.put_count,
+	                                counters.post_count, counters.delete_count, counters.bytes_received,
+	                                counters.bytes_sent)
+	          << std::endl;
+}
+
+BenchmarkOptions ParseOptions(int argc, char **argv) {
+	BenchmarkOptions options;
+	for (int idx = 1; idx < argc; ++idx) {
+		const string arg = argv[idx];
+		const auto eq_pos = arg.find('=');
+		const string key = arg.substr(0, eq_pos);
+		const string value = eq_pos == string::npos ? "" : arg.substr(eq_pos + 1);
+		if (key == "--rows") {
+			options.rows = std::stoull(value);
+		} else if (key == "--latency-us") {
+			options.latency_us = std::stoull(value);
+		} else if (key == "--bandwidth-mbps") {
+			options.bandwidth_mbps = std::stoull(value);
+		} else if (key == "--http2") {
+			options.http2 = true;
+		} else if (key == "--iterations" && std::stoull(value) > 0) {
+			options.iterations = std::stoull(value);
+		} else if (key == "--threads") {
+			options.threads = std::stoull(value);
+		} else if (key == "--format" && (value == "csv" || value == "json")) {
+			options.format = value;
+		} else {
+			std::cerr << "Unknown argument " << arg << std::endl;
+			std::exit(1);
+		}
+	}
+	return options;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	const auto options = ParseOptions(argc, argv);
+
+	LoopbackRangeServerConfig config;
+	config.object_size = 0;
+	config.latency = std::chrono::microseconds(options.latency_us);
+	config.bandwidth_bytes_per_sec = options.bandwidth_mbps * 1000 * 1000 / 8;
+	config.enable_http2 = options.http2;
+	LoopbackRangeServer server {config};
+	GenerateTestData(options, server);
+
+	if (options.format == "csv") {
+		std::cout << "implementation,server_protocol,query,iterations,min_us,median_us,head_requests,get_requests,"
+		             "put_requests,post_requests,delete_requests,bytes_received,bytes_sent"
+		          << std::endl;
+	}
+	for (const auto *cur_implementation : IMPLEMENTATIONS) {
+		for (auto &cur_result : RunBenchmark(options, server, cur_implementation)) {
+			PrintResult(options, std::move(cur_result));
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,39 @@
+#include "client_context_registry.hpp"
+
+#include <algorithm>
+
+namespace duckdb {
+
+/*static*/ ClientContextRegistry &ClientContextRegistry::GetInstance() {
+	static auto *registry = new ClientContextRegistry();
+	return *registry;
+}
+
+void ClientContextRegistry::Register(const HTTPState &http_state, ClientContext &context) {
+	weak_ptr<ClientContext> weak_context = context.shared_from_this();
+
+	const std::lock_guard<std::mutex> lck(mu);
+	client_contexts[&http_state] = std::move(weak_context);
+	if (client_contexts.size() < prune_threshold) {
+		return;
+	}
+	for (auto iter = client_contexts.begin(); iter != client_contexts.end();) {
+		if (iter->second.expired()) {
+			iter = client_contexts.erase(iter);
+		} else {
+			++iter;
+		}
+	}
+	prune_threshold = std::max<idx_t>(prune_threshold, client_contexts.size() * 2);
+}
+
+weak_ptr<ClientContext> ClientContextRegistry::Get(const HTTPState &http_state) {
+	const std::lock_guard<std::mutex> lck(mu);
+	auto iter = client_contexts.find(&http_state);
+	if (iter == client_contexts.end()) {
+		return weak_ptr<ClientContext>();
+	}
+	return iter->second;
+}
+
+} // namespace duckdb
@@ -0,0 +1,193 @@
+#include "completion_slot.hpp"
+
+#include <ctime>
+#include <mutex>
+
+#include "duckdb/common/assert.hpp"
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace duckdb {
+
+namespace {
+
+// Number of slots allocated at once.
+constexpr idx_t SLAB_SIZE = 16;
+
+#ifdef __linux__
+// Returns immediately if [`word`] no longer holds [`expected`], spurious wakeups are handled by the caller.
+void FutexWait(std::atomic<uint32_t> &word, uint32_t expected, const struct timespec *timeout) {
+	syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAIT_PRIVATE, expected, timeout, nullptr, 0);
+}
+void FutexWakeOne(std::atomic<uint32_t> &word) {
+	syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+}
+#endif
+
+} // namespace
+
+// Per-thread list of free slots.
+// Slots are never deallocated, so a late wakeup never touches freed memory; free slots of exited threads are handed
+// over to the global orphan list, and adopted by the next thread running out of slots.
+class CompletionSlotFreeList {
+public:
+	CompletionSlotFreeList() = default;
+	~CompletionSlotFreeList() {
+		if (head == nullptr) {
+			return;
+		}
+		auto *tail = head;
+		while (tail->next_free != nullptr) {
+			tail = tail->next_free;
+		}
+		const std::lock_guard<std::mutex> lck(GetOrphanMutex());
+		tail->next_free = GetOrphanHead();
+		GetOrphanHead() = head;
+	}
+
+	// Disable copy / move constructor / assignment.
+	CompletionSlotFreeList(const CompletionSlotFreeList &) = delete;
+	CompletionSlotFreeList &operator=(const CompletionSlotFreeList &) = delete;
+
+	CompletionSlot *Pop() {
+		if (head == nullptr) {
+			Refill();
+		}
+		auto *slot = head;
+		head = slot->next_free;
+		slot->next_free = nullptr;
+		return slot;
+	}
+
+	void Push(CompletionSlot *slot) {
+		slot->next_free = head;
+		head = slot;
+	}
+
+private:
+	static std::mutex &GetOrphanMutex() {
+		static auto *mu = new std::mutex();
+		return *mu;
+	}
+	static CompletionSlot *&GetOrphanHead() {
+		static CompletionSlot *orphan_head = nullptr;
+		return orphan_head;
+	}
+
+	void Refill() {
+		{
+			const std::lock_guard<std::mutex> lck(GetOrphanMutex());
+			head = GetOrphanHead();
+			GetOrphanHead() = nullptr;
+		}
+		if (head != nullptr) {
+			return;
+		}
+		auto *slab = new CompletionSlot[SLAB_SIZE];
+		for (idx_t idx = 0; idx + 1 < SLAB_SIZE; ++idx) {
+			slab[idx].next_free = &slab[idx + 1];
+		}
+		head = slab;
+	}
+
+	CompletionSlot *head = nullptr;
+};
+
+namespace {
+CompletionSlotFreeList &GetThreadFreeList() {
+	thread_local CompletionSlotFreeList free_list;
+	return free_list;
+}
+} // namespace
+
+/*static*/ CompletionSlot *CompletionSlot::Acquire() {
+	auto *slot = GetThreadFreeList().Pop();
+	D_ASSERT(slot->state.load(std::memory_order_relaxed) == PENDING);
+	return slot;
+}
+
+/*static*/ void CompletionSlot::Release(CompletionSlot *slot) {
+	GetThreadFreeList().Push(slot);
+}
+
+bool CompletionSlot::Complete(unique_ptr<HTTPResponse> response_p) {
+	response = std::move(response_p);
+	const uint32_t prev_state = state.exchange(COMPLETED, std::memory_order_acq_rel);
+	D_ASSERT(prev_state != COMPLETED);
+	return prev_state == PARKED;
+}
+
+void CompletionSlot::Wake() {
+#ifdef __linux__
+	FutexWakeOne(state);
+#else
+	// Lock before notification, so it's not lost between the waiter's check and its wait.
+	{ const std::lock_guard<std::mutex> lck(mu); }
+	cv.notify_one();
+#endif
+}
+
+bool CompletionSlot::Spin() const {
+	for (int idx = 0; idx < SPIN_COUNT; ++idx) {
+		if (state.load(std::memory_order_acquire) == COMPLETED) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void CompletionSlot::PrepareToPark() {
+	// Fails if already parked by a timed wait, or completed.
+	uint32_t expected = PENDING;
+	state.compare_exchange_strong(expected, PARKED, std::memory_order_acq_rel, std::memory_order_acquire);
+}
+
+bool CompletionSlot::WaitFor(std::chrono::nanoseconds timeout) {
+	if (Spin()) {
+		return true;
+	}
+	PrepareToPark();
+	const auto deadline = std::chrono::steady_clock::now() + timeout;
+#ifdef __linux__
+	while (state.load(std::memory_order_acquire) != COMPLETED) {
+		const auto remaining = deadline - std::chrono::steady_clock::now();
+		if (remaining <= std::chrono::nanoseconds::zero()) {
+			return false;
+		}
+		const auto remaining_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(remaining).count();
+		struct timespec ts;
+		ts.tv_sec = remaining_ns / 1000000000;
+		ts.tv_nsec = remaining_ns % 1000000000;
+		FutexWait(state, PARKED, &ts);
+	}
+	return true;
+#else
+	std::unique_lock<std::mutex> lck(mu);
+	return cv.wait_until(lck, deadline, [this]() { return state.load(std::memory_order_acquire) == COMPLETED; });
+#endif
+}
+
+unique_ptr<HTTPResponse> CompletionSlot::Wait() {
+	if (!Spin()) {
+		PrepareToPark();
+#ifdef __linux__
+		while (state.load(std::memory_order_acquire) != COMPLETED) {
+			FutexWait(state, PARKED, /*timeout=*/nullptr);
+		}
+#else
+		std::unique_lock<std::mutex> lck(mu);
+		cv.wait(lck, [this]() { return state.load(std::memory_order_acquire) == COMPLETED; });
+#endif
+	}
+
+	auto result = std::move(response);
+	// Reset for the next acquisition, the completing thread no longer touches the state.
+	state.store(PENDING, std::memory_order_relaxed);
+	return result;
+}
+
+} // namespace duckdb
@@ -0,0 +1,106 @@
+#include "connection_stats_query_function.hpp"
+
+#include <utility>
+
+#include "connection_stats_registry.hpp"
+#include "duckdb/common/helper.hpp"
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/unique_ptr.hpp"
+#include "duckdb/common/vector.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/client_context.hpp"
+
+namespace duckdb {
+
+namespace {
+
+//===--------------------------------------------------------------------===//
+// Get connection stats query function
+//===--------------------------------------------------------------------===//
+
+struct ConnectionStatsData : public GlobalTableFunctionState {
+	vector<HostConnectionStats::Snapshot> snapshots;
+
+	// Used to record the progress of emission.
+	uint64_t offset = 0;
+};
+
+unique_ptr<FunctionData> GetConnectionStatsFuncBind(ClientContext &context, TableFunctionBindInput &input,
+                                                    vector<LogicalType> &return_types, vector<string> &names) {
+	ALWAYS_ASSERT(return_types.empty());
+	ALWAYS_ASSERT(names.empty());
+
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+	names.emplace_back("host");
+	return_types.emplace_back(LogicalType {LogicalTypeId::UBIGINT});
+	names.emplace_back("requests");
+	return_types.emplace_back(LogicalType {LogicalTypeId::UBIGINT});
+	names.emplace_back("new_connections");
+	return_types.emplace_back(LogicalType {LogicalTypeId::UBIGINT});
+	names.emplace_back("reused_connections");
+	// Ratio of transfers served by an existing connection.
+	return_types.emplace_back(LogicalType {LogicalTypeId::DOUBLE});
+	names.emplace_back("reuse_ratio");
+	return_types.emplace_back(LogicalType {LogicalTypeId::UBIGINT});
+	names.emplace_back("tls_handshakes");
+	return_types.emplace_back(LogicalType {LogicalTypeId::DOUBLE});
+	names.emplace_back("tls_handshake_mean_us");
+	return_types.emplace_back(LogicalType {LogicalTypeId::UBIGINT});
+	names.emplace_back("http2_requests");
+	return_types.emplace_back(LogicalType {LogicalTypeId::UBIGINT});
+	names.emplace_back("http2_reused_streams");
+
+	return nullptr;
+}
+
+unique_ptr<GlobalTableFunctionState> GetConnectionStatsFuncInit(ClientContext &context,
+                                                                TableFunctionInitInput &input) {
+	auto result = make_uniq<ConnectionStatsData>();
+	result->snapshots = ConnectionStatsRegistry::GetInstance().GetSnapshots();
+	return std::move(result);
+}
+
+void GetConnectionStatsTableFunc(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+	auto &data = data_p.global_state->Cast<ConnectionStatsData>();
+
+	// All entries have been emitted.
+	if (data.offset >= data.snapshots.size()) {
+		return;
+	}
+
+	// Start filling in the result buffer.
+	idx_t count = 0;
+	while (data.offset < data.snapshots.size() && count < STANDARD_VECTOR_SIZE) {
+		auto &entry = data.snapshots[data.offset++];
+		const double reuse_ratio =
+		    entry.requests == 0 ? 0.0
+		                        : static_cast<double>(entry.reused_connections) / static_cast<double>(entry.requests);
+		const double tls_handshake_mean_us =
+		    entry.tls_handshakes == 0
+		        ? 0.0
+		        : static_cast<double>(entry.tls_handshake_us) / static_cast<double>(entry.tls_handshakes);
+		idx_t col_idx = 0;
+		output.SetValue(col_idx++, count, entry.host);
+		output.SetValue(col_idx++, count, Value::UBIGINT(entry.requests));
+		output.SetValue(col_idx++, count, Value::UBIGINT(entry.new_connections));
+		output.SetValue(col_idx++, count, Value::UBIGINT(entry.reused_connections));
+		output.SetValue(col_idx++, count, Value::DOUBLE(reuse_ratio));
+		output.SetValue(col_idx++, count, Value::UBIGINT(entry.tls_handshakes));
+		output.SetValue(col_idx++, count, Value::DOUBLE(tls_handshake_mean_us));
+		output.SetValue(col_idx++, count, Value::UBIGINT(entry.http2_requests));
+		output.SetValue(col_idx++, count, Value::UBIGINT(entry.http2_reused_streams));
+		count++;
+	}
+	output.SetCardinality(count);
+}
+} // namespace
+
+TableFunction GetConnectionStatsFunc() {
+	TableFunction connection_stats_query_func {/*name=*/"curl_httpfs_connection_stats",
+	                                           /*arguments=*/ {},
+	                                           /*function=*/GetConnectionStatsTableFunc,
+	                                           /*bind=*/GetConnectionStatsFuncBind,
+	                                           /*init_global=*/GetConnectionStatsFuncInit};
+	return connection_stats_query_func;
+}
+} // namespace duckdb
@@ -0,0 +1,51 @@
+#include "connection_stats_registry.hpp"
+
+#include <algorithm>
+
+namespace duckdb {
+
+bool IsConnectionReused(CURLcode result, curl_off_t connect_us) {
+	// Connect time is set once the transfer gets a connection, including a reused one; failed transfers without it
+	// never got any, e.g. on DNS errors or refused connections.
+	return result == CURLE_OK || connect_us > 0;
+}
+
+void HostConnectionStats::Record(const CurlTransferInfo &info, CURLcode result) {
+	requests.fetch_add(1, std::memory_order_relaxed);
+	const bool is_http2 = info.http_version == CURL_HTTP_VERSION_2_0;
+	if (is_http2) {
+		http2_requests.fetch_add(1, std::memory_order_relaxed);
+	}
+	if (info.new_connects == 0) {
+		if (!IsConnectionReused(result, info.connect_us)) {
+			return;
+		}
+		reused_connections.fetch_add(1, std::memory_order_relaxed);
+		if (is_http2) {
+			http2_reused_streams.fetch_add(1, std::memory_order_relaxed);
+		}
+		return;
+	}
+	new_connections.fetch_add(static_cast<uint64_t>(info.new_connects), std::memory_order_relaxed);
+	// Appconnect time is only set once a TLS handshake completes on the transfer's new connection.
+	if (info.appconnect_us > 0) {
+		tls_handshakes.fetch_add(1, std::memory_order_relaxed);
+		tls_handshake_us.fetch_add(
+		    static_cast<uint64_t>(std::max<curl_off_t>(info.appconnect_us - info.connect_us, 0)),
+		    std::memory_order_relaxed);
+	}
+}
+
+HostConnectionStats::Snapshot HostConnectionStats::GetSnapshot() const {
+	Snapshot snapshot;
+	snapshot.requests = requests.load(std::memory_order_relaxed);
+	snapshot.new_connections = new_connections.load(std::memory_order_relaxed);
+	snapshot.reused_connections = reused_connections.load(std::memory_order_relaxed);
+	snapshot.tls_handshakes = tls_handshakes.load(std::memory_order_relaxed);
+	snapshot.tls_handshake_us = tls_handshake_us.load(std::memory_order_relaxed);
+	snapshot.http2_requests = http2_requests.load(std::memory_order_relaxed);
+	snapshot.http2_reused_streams = http2_reused_streams.load(std::memory_order_relaxed);
+	return snapshot;
+}
+
+} // namespace duckdb
@@ -0,0 +1,79 @@
+#include "credential_redaction.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <strings.h>
+
+namespace duckdb {
+
+namespace {
+
+// Request headers whose values are never recorded.
+constexpr const char *CREDENTIAL_HEADERS[] = {"authorization", "proxy-authorization", "x-amz-security-token", "cookie"};
+
+// Query parameters whose values are never exposed, of presigned S3 and GCS URLs, and Azure SAS tokens.
+constexpr const char *CREDENTIAL_QUERY_PARAMS[] = {"x-amz-signature", "x-amz-credential",  "x-amz-security-token",
+                                                   "awsaccesskeyid",  "x-goog-signature", "x-goog-credential",
+                                                   "signature",       "sig"};
+
+bool IsCredentialQueryParam(const char *name, size_t name_len) {
+	for (const auto *cur_param : CREDENTIAL_QUERY_PARAMS) {
+		if (std::strlen(cur_param) == name_len && strncasecmp(name, cur_param, name_len) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+} // namespace
+
+bool IsCredentialHeader(const char *name, size_t name_len) {
+	for (const auto *cur_header : CREDENTIAL_HEADERS) {
+		if (std::strlen(cur_header) == name_len && strncasecmp(name, cur_header, name_len) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+ptrdiff_t FindCredentialHeader(const char *data, size_t size, size_t &name_len) {
+	for (size_t offset = 0; offset < size; ++offset) {
+		for (const auto *cur_header : CREDENTIAL_HEADERS) {
+			const size_t cur_len = std::strlen(cur_header);
+			if (offset + cur_len < size && data[offset + cur_len] == ':' &&
+			    strncasecmp(data + offset, cur_header, cur_len) == 0) {
+				name_len = cur_len;
+				return static_cast<ptrdiff_t>(offset);
+			}
+		}
+	}
+	return -1;
+}
+
+string RedactUrlCredentials(const string &url) {
+	const auto query_start = url.find('?');
+	if (query_start == string::npos) {
+		return url;
+	}
+	const auto query_end = std::min(url.find('#', query_start), url.size());
+	string redacted_url = url.substr(0, query_start + 1);
+	size_t param_start = query_start + 1;
+	while (param_start <= query_end) {
+		const auto param_end = std::min(url.find('&', param_start), query_end);
+		const auto value_start = url.find('=', param_start);
+		if (value_start < param_end && IsCredentialQueryParam(url.data() + param_start, value_start - param_start)) {
+			redacted_url.append(url, param_start, value_start + 1 - param_start);
+			redacted_url.append(REDACTED_VALUE);
+		} else {
+			redacted_url.append(url, param_start, param_end - param_start);
+		}
+		if (param_end < query_end) {
+			redacted_url.push_back('&');
+		}
+		param_start = param_end + 1;
+	}
+	redacted_url.append(url, query_end, string::npos);
+	return redacted_url;
+}
+
+} // namespace duckdb
@@ -0,0 +1,52 @@
+#include "curl_completion_queue.hpp"
+
+#include <utility>
+
+namespace duckdb {
+
+CurlCompletionCallback CurlCompletionQueue::CreateCallback(uint64_t tag) {
+	return [this, tag](unique_ptr<HTTPResponse> response) {
+		Push(tag, std::move(response));
+	};
+}
+
+void CurlCompletionQueue::Push(uint64_t tag, unique_ptr<HTTPResponse> response) {
+	Completion completion;
+	completion.tag = tag;
+	completion.response = std::move(response);
+	{
+		const std::lock_guard<std::mutex> lck(mu);
+		completions.emplace(std::move(completion));
+	}
+	cv.notify_one();
+}
+
+bool CurlCompletionQueue::TryPop(Completion &completion) {
+	const std::lock_guard<std::mutex> lck(mu);
+	if (completions.empty()) {
+		return false;
+	}
+	completion = std::move(completions.front());
+	completions.pop();
+	return true;
+}
+
+CurlCompletionQueue::Completion CurlCompletionQueue::Pop() {
+	std::unique_lock<std::mutex> lck(mu);
+	cv.wait(lck, [this]() { return !completions.empty(); });
+	auto completion = std::move(completions.front());
+	completions.pop();
+	return completion;
+}
+
+bool CurlCompletionQueue::PopWithTimeout(Completion &completion, std::chrono::milliseconds timeout) {
+	std::unique_lock<std::mutex> lck(mu);
+	if (!cv.wait_for(lck, timeout, [this]() { return !completions.empty(); })) {
+		return false;
+	}
+	completion = std::move(completions.front());
+	completions.pop();
+	return true;
+}
+
+} // namespace duckdb
@@ -0,0 +1,56 @@
+#include "curl_handle_pool.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/helper.hpp"
+
+namespace duckdb {
+
+CurlHandlePool::PooledHandle::PooledHandle(CurlHandlePool &pool_p, CURL *easy_curl_p)
+    : pool(pool_p), easy_curl(easy_curl_p) {
+}
+
+CurlHandlePool::PooledHandle::~PooledHandle() {
+	pool.Release(easy_curl);
+}
+
+CurlHandlePool::CurlHandlePool(unique_ptr<CURLHandle> template_handle_p)
+    : template_handle(std::move(template_handle_p)) {
+}
+
+CurlHandlePool::~CurlHandlePool() {
+	for (auto *cur_handle : idle_handles) {
+		curl_easy_cleanup(cur_handle);
+	}
+}
+
+unique_ptr<CurlHandlePool::PooledHandle> CurlHandlePool::Acquire() {
+	CURL *easy_curl = nullptr;
+	{
+		const std::lock_guard<std::mutex> lck(mu);
+		if (!idle_handles.empty()) {
+			easy_curl = idle_handles.back();
+			idle_handles.pop_back();
+		}
+	}
+
+	// Duplication happens outside of critical section, since it copies all options.
+	if (easy_curl == nullptr) {
+		easy_curl = curl_easy_duphandle(*template_handle);
+		if (easy_curl == nullptr) {
+			throw IOException("Failed to duplicate curl easy handle");
+		}
+	}
+	return make_uniq<PooledHandle>(*this, easy_curl);
+}
+
+idx_t CurlHandlePool::GetIdleHandleCount() {
+	const std::lock_guard<std::mutex> lck(mu);
+	return idle_handles.size();
+}
+
+void CurlHandlePool::Release(CURL *easy_curl) {
+	const std::lock_guard<std::mutex> lck(mu);
+	idle_handles.emplace_back(easy_curl);
+}
+
+} // namespace duckdb
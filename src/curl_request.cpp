@@ -1,10 +1,39 @@
 #include "curl_request.hpp"
 
+#include <cstring>
+#include <functional>
+#include <strings.h>
+#include <thread>
+
+#include "debug_event_ring.hpp"
 #include "duckdb/common/assert.hpp"
+#include "duckdb/common/helper.hpp"
 #include "extension_config.hpp"
+#include "url_utils.hpp"
 
 namespace duckdb {
 
+namespace {
+
+// Whether to collect debug events for a new request, based on the configured sample rate.
+bool ShouldCollectDebugEvents() {
+	if (!ENABLE_DEBUG_EVENTS.load(std::memory_order_relaxed)) {
+		return false;
+	}
+	const double sample_rate = DEBUG_EVENTS_SAMPLE_RATE.load(std::memory_order_relaxed);
+	if (sample_rate >= 1.0) {
+		return true;
+	}
+	// Xorshift per thread, which is cheap and good enough for sampling.
+	thread_local uint64_t random_state = std::hash<std::thread::id> {}(std::this_thread::get_id()) | 1;
+	random_state ^= random_state << 13;
+	random_state ^= random_state >> 7;
+	random_state ^= random_state << 17;
+	return static_cast<double>(random_state >> 11) / 9007199254740992.0 < sample_rate;
+}
+
+} // namespace
+
 CurlRequest::CurlRequest(CURL *easy_curl_p) : info(make_uniq<RequestInfo>()), easy_curl(easy_curl_p) {
 	curl_easy_setopt(easy_curl, CURLOPT_HEADERFUNCTION, CurlRequest::WriteHeader);
 	curl_easy_setopt(easy_curl, CURLOPT_HEADERDATA, this);
@@ -12,8 +41,15 @@ CurlRequest::CurlRequest(CURL *easy_curl_p) : info(make_uniq<RequestInfo>()), ea
 	curl_easy_setopt(easy_curl, CURLOPT_WRITEDATA, this);
 	curl_easy_setopt(easy_curl, CURLOPT_PRIVATE, this);
 
-	if (ENABLE_CURL_VERBOSE_LOGGING) {
+	// Easy handles are reused across requests, so verbose logging and debug events are reset when disabled.
+	// Curl only reports debug events in verbose mode, which go to the eventloop's ring instead of stderr.
+	if (ShouldCollectDebugEvents()) {
+		curl_easy_setopt(easy_curl, CURLOPT_DEBUGFUNCTION, DebugEventRing::DebugCallback);
+		curl_easy_setopt(easy_curl, CURLOPT_DEBUGDATA, this);
 		curl_easy_setopt(easy_curl, CURLOPT_VERBOSE, 1L);
+	} else {
+		curl_easy_setopt(easy_curl, CURLOPT_DEBUGFUNCTION, nullptr);
+		curl_easy_setopt(easy_curl, CURLOPT_VERBOSE, ENABLE_CURL_VERBOSE_LOGGING ? 1L : 0L);
 	}
 }
 
@@ -21,21 +57,117 @@ CurlRequest::~CurlRequest() = default;
 
 void CurlRequest::SetUrl(string url) {
 	curl_easy_setopt(easy_curl, CURLOPT_URL, url.c_str());
+	host = GetUrlHost(url);
 	info->url = std::move(url);
 }
-void CurlRequest::SetHeaders(curl_slist *headers) {
-	if (headers != nullptr) {
-		curl_easy_setopt(easy_curl, CURLOPT_HTTPHEADER, headers);
-	}
+void CurlRequest::SetHeaders(curl_slist *headers_p) {
+	headers = headers_p;
+	range = GetRangeHeader(headers);
+	// Always set headers, so headers of previous requests on the same easy handle are not reused.
+	curl_easy_setopt(easy_curl, CURLOPT_HTTPHEADER, headers);
 }
 
+// Easy handles are reused across requests with different methods, so each method resets method-related attributes
+// left by previous requests.
 void CurlRequest::SetGetAttrs() {
+	method = "GET";
+	curl_easy_setopt(easy_curl, CURLOPT_CUSTOMREQUEST, nullptr);
+	curl_easy_setopt(easy_curl, CURLOPT_HTTPGET, 1L);
 	curl_easy_setopt(easy_curl, CURLOPT_NOBODY, 0L);
 }
 void CurlRequest::SetHeadAttrs() {
+	method = "HEAD";
+	curl_easy_setopt(easy_curl, CURLOPT_CUSTOMREQUEST, nullptr);
 	curl_easy_setopt(easy_curl, CURLOPT_NOBODY, 1L);
 	curl_easy_setopt(easy_curl, CURLOPT_HTTPGET, 0L);
 }
+void CurlRequest::SetPutAttrs(const_data_ptr_t buffer, idx_t buffer_len) {
+	method = "PUT";
+	curl_easy_setopt(easy_curl, CURLOPT_NOBODY, 0L);
+	curl_easy_setopt(easy_curl, CURLOPT_POSTFIELDS, const_char_ptr_cast(buffer));
+	curl_easy_setopt(easy_curl, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(buffer_len));
+	curl_easy_setopt(easy_curl, CURLOPT_CUSTOMREQUEST, "PUT");
+}
+void CurlRequest::SetPostAttrs(const_data_ptr_t buffer, idx_t buffer_len) {
+	method = "POST";
+	curl_easy_setopt(easy_curl, CURLOPT_CUSTOMREQUEST, nullptr);
+	curl_easy_setopt(easy_curl, CURLOPT_NOBODY, 0L);
+	curl_easy_setopt(easy_curl, CURLOPT_POST, 1L);
+	curl_easy_setopt(easy_curl, CURLOPT_POSTFIELDS, const_char_ptr_cast(buffer));
+	curl_easy_setopt(easy_curl, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(buffer_len));
+}
+void CurlRequest::SetDeleteAttrs() {
+	method = "DELETE";
+	curl_easy_setopt(easy_curl, CURLOPT_HTTPGET, 1L);
+	curl_easy_setopt(easy_curl, CURLOPT_NOBODY, 0L);
+	curl_easy_setopt(easy_curl, CURLOPT_CUSTOMREQUEST, "DELETE");
+}
+void CurlRequest::SetBodyStream(CurlBodyStream &stream) {
+	body_stream = &stream;
+}
+void CurlRequest::SetCompletionCallback(CurlCompletionCallback callback) {
+	completion_callback = std::move(callback);
+}
+void CurlRequest::SetCompletionSlot(CompletionSlot &slot) {
+	completion_slot = &slot;
+}
+void CurlRequest::SetDeadline(std::chrono::steady_clock::time_point deadline_p) {
+	deadline = deadline_p;
+}
+bool CurlRequest::HasDeadline() const {
+	return deadline != std::chrono::steady_clock::time_point::max();
+}
+bool CurlRequest::HasCompletion() const {
+	return completion_slot != nullptr || completion_callback != nullptr;
+}
+
+void CurlRequest::PopulateResponse(HTTPResponse &response) const {
+	response.url = info->url;
+	response.reason = HTTPUtil::GetStatusMessage(response.status);
+	if (info->header_collection.empty()) {
+		return;
+	}
+	for (auto &header : info->header_collection.back()) {
+		if (header.first == "__RESPONSE_STATUS__") {
+			continue;
+		}
+		response.headers.Insert(header.first, header.second);
+	}
+}
+
+unique_ptr<HTTPResponse> CurlRequest::BuildResponse(CURLcode result) {
+	const HTTPStatusCode status_code = HTTPUtil::ToStatusCode(info->response_code);
+	auto resp = make_uniq<HTTPResponse>(status_code);
+	if (result == CURLcode::CURLE_OK) {
+		resp->body = std::move(info->body);
+		PopulateResponse(*resp);
+		return resp;
+	}
+	resp->url = info->url;
+	resp->reason = HTTPUtil::GetStatusMessage(status_code);
+	if (!info->header_collection.empty() && info->header_collection.back().HasHeader("__RESPONSE_STATUS__")) {
+		resp->request_error = info->header_collection.back().GetHeaderValue("__RESPONSE_STATUS__");
+	} else {
+		resp->request_error = curl_easy_strerror(result);
+	}
+	return resp;
+}
+
+string GetRangeHeader(const curl_slist *headers) {
+	constexpr const char *RANGE_HEADER_PREFIX = "range:";
+	const size_t prefix_len = strlen(RANGE_HEADER_PREFIX);
+	for (const auto *cur_header = headers; cur_header != nullptr; cur_header = cur_header->next) {
+		if (strncasecmp(cur_header->data, RANGE_HEADER_PREFIX, prefix_len) != 0) {
+			continue;
+		}
+		const char *value = cur_header->data + prefix_len;
+		while (*value == ' ') {
+			++value;
+		}
+		return value;
+	}
+	return "";
+}
 
 /*static*/ size_t CurlRequest::WriteHeader(void *contents, size_t size, size_t nmemb, void *userp) {
 	size_t total_size = size * nmemb;
@@ -76,8 +208,45 @@ void CurlRequest::SetHeadAttrs() {
 /*static*/ size_t CurlRequest::WriteBody(void *contents, size_t size, size_t nmemb, void *userp) {
 	size_t total_size = size * nmemb;
 	auto *req = static_cast<CurlRequest *>(userp);
-	req->info->body.append(static_cast<char *>(contents), total_size);
-	return total_size;
+	if (req->body_stream == nullptr || req->body_stream->buffer_body) {
+		req->info->body.append(static_cast<char *>(contents), total_size);
+		return total_size;
+	}
+	return req->StreamBody(static_cast<const_data_ptr_t>(contents), total_size);
+}
+
+size_t CurlRequest::StreamBody(const_data_ptr_t data, size_t data_len) {
+	auto &stream = *body_stream;
+	// Handlers are allowed to throw, which cannot propagate through libcurl; record the exception and abort transfer
+	// by consuming no bytes.
+	try {
+		if (!stream.response_handled) {
+			long response_code = 0;
+			curl_easy_getinfo(easy_curl, CURLINFO_RESPONSE_CODE, &response_code);
+			if (response_code < 200 || response_code >= 300) {
+				stream.buffer_body = true;
+				info->body.append(const_char_ptr_cast(data), data_len);
+				return data_len;
+			}
+
+			info->response_code = static_cast<uint16_t>(response_code);
+			HTTPResponse response(HTTPUtil::ToStatusCode(info->response_code));
+			PopulateResponse(response);
+			stream.response_handled = true;
+			if (stream.response_handler && !stream.response_handler(response)) {
+				stream.accept_content = false;
+			}
+		}
+
+		stream.bytes_streamed += data_len;
+		if (stream.accept_content && !stream.content_handler(data, data_len)) {
+			stream.accept_content = false;
+		}
+	} catch (...) {
+		stream.exception = std::current_exception();
+		return 0;
+	}
+	return data_len;
 }
 
 } // namespace duckdb
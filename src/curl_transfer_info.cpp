@@ -0,0 +1,25 @@
+#include "curl_transfer_info.hpp"
+
+namespace duckdb {
+
+/*static*/ CurlTransferInfo CurlTransferInfo::Read(CURL *easy_curl) {
+	CurlTransferInfo info;
+	curl_easy_getinfo(easy_curl, CURLINFO_NAMELOOKUP_TIME_T, &info.namelookup_us);
+	curl_easy_getinfo(easy_curl, CURLINFO_CONNECT_TIME_T, &info.connect_us);
+	curl_easy_getinfo(easy_curl, CURLINFO_APPCONNECT_TIME_T, &info.appconnect_us);
+	curl_easy_getinfo(easy_curl, CURLINFO_STARTTRANSFER_TIME_T, &info.starttransfer_us);
+	curl_easy_getinfo(easy_curl, CURLINFO_TOTAL_TIME_T, &info.total_us);
+	curl_easy_getinfo(easy_curl, CURLINFO_SIZE_DOWNLOAD_T, &info.bytes_received);
+	curl_easy_getinfo(easy_curl, CURLINFO_SIZE_UPLOAD_T, &info.bytes_sent);
+	curl_easy_getinfo(easy_curl, CURLINFO_NUM_CONNECTS, &info.new_connects);
+	curl_easy_getinfo(easy_curl, CURLINFO_REDIRECT_COUNT, &info.redirect_count);
+	curl_easy_getinfo(easy_curl, CURLINFO_HTTP_VERSION, &info.http_version);
+#if LIBCURL_VERSION_NUM >= 0x080200
+	curl_off_t conn_id = -1;
+	curl_easy_getinfo(easy_curl, CURLINFO_CONN_ID, &conn_id);
+	info.connection_id = static_cast<int64_t>(conn_id);
+#endif
+	return info;
+}
+
+} // namespace duckdb
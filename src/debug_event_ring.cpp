@@ -0,0 +1,135 @@
+#include "debug_event_ring.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "credential_redaction.hpp"
+#include "curl_request.hpp"
+#include "time_utils.hpp"
+
+namespace duckdb {
+
+namespace {
+
+// Length of data without trailing line breaks.
+size_t TrimLineBreaks(const char *data, size_t size) {
+	while (size > 0 && (data[size - 1] == '\n' || data[size - 1] == '\r')) {
+		--size;
+	}
+	return size;
+}
+
+// Appends data to an event, and truncates it to the max data length.
+struct EventDataWriter {
+	DebugEvent &event;
+
+	void Write(const char *data, size_t size) {
+		const size_t write_len = std::min<size_t>(size, DebugEvent::MAX_DATA_LEN - event.data_len);
+		std::memcpy(event.data.data() + event.data_len, data, write_len);
+		event.data_len = static_cast<uint8_t>(event.data_len + write_len);
+	}
+};
+
+// Write the given request line without its query string, which carries credentials of presigned URLs, i.e.
+// "GET /key?X-Amz-Signature=... HTTP/1.1" is written as "GET /key HTTP/1.1".
+void WriteRequestLine(EventDataWriter &writer, const char *data, size_t size) {
+	const auto *query_start = static_cast<const char *>(std::memchr(data, '?', size));
+	if (query_start == nullptr) {
+		writer.Write(data, size);
+		return;
+	}
+	writer.Write(data, static_cast<size_t>(query_start - data));
+	const char *data_end = data + size;
+	const char *version_start = data_end;
+	while (version_start > query_start && *(version_start - 1) != ' ') {
+		--version_start;
+	}
+	if (version_start > query_start) {
+		writer.Write(version_start - 1, static_cast<size_t>(data_end - version_start + 1));
+	}
+}
+
+// Write the given text with the value of the first credential header redacted, since curl lists request headers as
+// text for HTTP/2, i.e. "[HTTP/2] [1] [authorization: ...]".
+void WriteText(EventDataWriter &writer, const char *data, size_t size) {
+	size_t name_len = 0;
+	const ptrdiff_t header_offset = FindCredentialHeader(data, size, name_len);
+	if (header_offset < 0) {
+		writer.Write(data, size);
+		return;
+	}
+	writer.Write(data, static_cast<size_t>(header_offset) + name_len + 1);
+	writer.Write(" ", 1);
+	writer.Write(REDACTED_VALUE, std::strlen(REDACTED_VALUE));
+}
+
+} // namespace
+
+const char *GetDebugEventTypeName(DebugEvent::Type type) {
+	switch (type) {
+	case DebugEvent::Type::TEXT:
+		return "text";
+	case DebugEvent::Type::HEADER_IN:
+		return "header_in";
+	case DebugEvent::Type::HEADER_OUT:
+		return "header_out";
+	}
+	return "unknown";
+}
+
+void DebugEventRing::Append(curl_infotype curl_type, const char *data, size_t size, uint64_t request_id) {
+	DebugEvent::Type type;
+	switch (curl_type) {
+	case CURLINFO_TEXT:
+		type = DebugEvent::Type::TEXT;
+		break;
+	case CURLINFO_HEADER_IN:
+		type = DebugEvent::Type::HEADER_IN;
+		break;
+	case CURLINFO_HEADER_OUT: {
+		type = DebugEvent::Type::HEADER_OUT;
+		// Outgoing headers come as one block, only the request line is kept.
+		const auto *line_end = static_cast<const char *>(std::memchr(data, '\n', size));
+		if (line_end != nullptr) {
+			size = static_cast<size_t>(line_end - data);
+		}
+		break;
+	}
+	default:
+		return;
+	}
+
+	DebugEvent event;
+	event.timestamp_us = GetSystemNowUs();
+	event.request_id = request_id;
+	event.size = static_cast<uint32_t>(size);
+	event.type = type;
+	EventDataWriter writer {event};
+	const size_t trimmed_size = TrimLineBreaks(data, size);
+	if (type == DebugEvent::Type::HEADER_OUT) {
+		WriteRequestLine(writer, data, trimmed_size);
+	} else if (type == DebugEvent::Type::TEXT) {
+		WriteText(writer, data, trimmed_size);
+	} else {
+		writer.Write(data, trimmed_size);
+	}
+	ring.Append(event);
+}
+
+vector<DebugEvent> DebugEventRing::Snapshot() const {
+	vector<DebugEvent> events;
+	// Only the latest events are still in the ring.
+	ring.Read(/*begin_position=*/0, ring.GetNextPosition(), events);
+	return events;
+}
+
+/*static*/ int DebugEventRing::DebugCallback(CURL *easy_curl, curl_infotype curl_type, char *data, size_t size,
+                                             void *userp) {
+	auto *request = static_cast<CurlRequest *>(userp);
+	if (request->debug_events != nullptr) {
+		request->debug_events->Append(curl_type, data, size, request->request_id);
+	}
+	return 0;
+}
+
+} // namespace duckdb
@@ -0,0 +1,101 @@
+#include "debug_events_query_function.hpp"
+
+#include <utility>
+
+#include "debug_event_ring.hpp"
+#include "duckdb/common/helper.hpp"
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/types/timestamp.hpp"
+#include "duckdb/common/unique_ptr.hpp"
+#include "duckdb/common/vector.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "multi_curl_manager.hpp"
+
+namespace duckdb {
+
+namespace {
+
+// Get event data as printable ASCII, since header values and truncation could break UTF-8.
+string GetPrintableData(const DebugEvent &event) {
+	string data(event.data.data(), event.data_len);
+	for (auto &cur_char : data) {
+		const auto byte = static_cast<unsigned char>(cur_char);
+		if (byte < 0x20 || byte >= 0x7f) {
+			cur_char = '?';
+		}
+	}
+	return data;
+}
+
+//===--------------------------------------------------------------------===//
+// Get debug events query function
+//===--------------------------------------------------------------------===//
+
+struct DebugEventsData : public GlobalTableFunctionState {
+	vector<DebugEvent> events;
+
+	// Used to record the progress of emission.
+	uint64_t offset = 0;
+};
+
+unique_ptr<FunctionData> GetDebugEventsFuncBind(ClientContext &context, TableFunctionBindInput &input,
+                                                vector<LogicalType> &return_types, vector<string> &names) {
+	ALWAYS_ASSERT(return_types.empty());
+	ALWAYS_ASSERT(names.empty());
+
+	auto add_column = [&](const char *name, LogicalTypeId type) {
+		names.emplace_back(name);
+		return_types.emplace_back(LogicalType {type});
+	};
+	add_column("event_loop", LogicalTypeId::UBIGINT);
+	add_column("request_id", LogicalTypeId::UBIGINT);
+	add_column("time", LogicalTypeId::TIMESTAMP);
+	add_column("type", LogicalTypeId::VARCHAR);
+	// Size of the original data, which is truncated in `data`.
+	add_column("size", LogicalTypeId::UBIGINT);
+	add_column("data", LogicalTypeId::VARCHAR);
+
+	return nullptr;
+}
+
+unique_ptr<GlobalTableFunctionState> GetDebugEventsFuncInit(ClientContext &context, TableFunctionInitInput &input) {
+	auto result = make_uniq<DebugEventsData>();
+	result->events = MultiCurlManager::GetInstance().GetDebugEvents();
+	return std::move(result);
+}
+
+void GetDebugEventsTableFunc(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+	auto &data = data_p.global_state->Cast<DebugEventsData>();
+
+	// All entries have been emitted.
+	if (data.offset >= data.events.size()) {
+		return;
+	}
+
+	// Start filling in the result buffer.
+	idx_t count = 0;
+	while (data.offset < data.events.size() && count < STANDARD_VECTOR_SIZE) {
+		auto &entry = data.events[data.offset++];
+		idx_t col_idx = 0;
+		output.SetValue(col_idx++, count, Value::UBIGINT(entry.event_loop_idx));
+		output.SetValue(col_idx++, count, Value::UBIGINT(entry.request_id));
+		output.SetValue(col_idx++, count, Value::TIMESTAMP(timestamp_t(entry.timestamp_us)));
+		output.SetValue(col_idx++, count, GetDebugEventTypeName(entry.type));
+		output.SetValue(col_idx++, count, Value::UBIGINT(entry.size));
+		output.SetValue(col_idx++, count, GetPrintableData(entry));
+		count++;
+	}
+	output.SetCardinality(count);
+}
+} // namespace
+
+TableFunction GetDebugEventsFunc() {
+	TableFunction debug_events_query_func {/*name=*/"curl_httpfs_debug_events",
+	                                       /*arguments=*/ {},
+	                                       /*function=*/GetDebugEventsTableFunc,
+	                                       /*bind=*/GetDebugEventsFuncBind,
+	                                       /*init_global=*/GetDebugEventsFuncInit};
+	return debug_events_query_func;
+}
+} // namespace duckdb
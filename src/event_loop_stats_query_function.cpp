@@ -0,0 +1,129 @@
+#include "event_loop_stats_query_function.hpp"
+
+#include <utility>
+
+#include "duckdb/common/helper.hpp"
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/unique_ptr.hpp"
+#include "duckdb/common/vector.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "event_loop_stats.hpp"
+#include "multi_curl_manager.hpp"
+
+namespace duckdb {
+
+namespace {
+
+const char *GetBackendName(EventLoopBackend backend) {
+	if (backend == EventLoopBackend::IO_URING) {
+		return "io_uring";
+	}
+	// The epoll backend runs on kqueue on macOS.
+#if defined(__APPLE__)
+	return "kqueue";
+#else
+	return "epoll";
+#endif
+}
+
+double SafeDivide(double numerator, double denominator) {
+	return denominator == 0 ? 0 : numerator / denominator;
+}
+
+//===--------------------------------------------------------------------===//
+// Get eventloop stats query function
+//===--------------------------------------------------------------------===//
+
+struct EventLoopStatsData : public GlobalTableFunctionState {
+	vector<EventLoopStatsSnapshot> snapshots;
+
+	// Used to record the progress of emission.
+	uint64_t offset = 0;
+};
+
+unique_ptr<FunctionData> GetEventLoopStatsFuncBind(ClientContext &context, TableFunctionBindInput &input,
+                                                   vector<LogicalType> &return_types, vector<string> &names) {
+	ALWAYS_ASSERT(return_types.empty());
+	ALWAYS_ASSERT(names.empty());
+
+	auto add_column = [&](const char *name, LogicalTypeId type) {
+		names.emplace_back(name);
+		return_types.emplace_back(LogicalType {type});
+	};
+	add_column("event_loop", LogicalTypeId::UBIGINT);
+	add_column("backend", LogicalTypeId::VARCHAR);
+	add_column("pending_requests", LogicalTypeId::UBIGINT);
+	add_column("queue_wait_p50_us", LogicalTypeId::UBIGINT);
+	add_column("queue_wait_p99_us", LogicalTypeId::UBIGINT);
+	add_column("queue_wait_max_us", LogicalTypeId::UBIGINT);
+	add_column("ongoing_requests", LogicalTypeId::UBIGINT);
+	add_column("still_running", LogicalTypeId::UBIGINT);
+	add_column("pending_deadlines", LogicalTypeId::UBIGINT);
+	add_column("wakeups", LogicalTypeId::UBIGINT);
+	add_column("wakeups_per_second", LogicalTypeId::DOUBLE);
+	add_column("events_per_wakeup", LogicalTypeId::DOUBLE);
+	add_column("socket_action_calls", LogicalTypeId::UBIGINT);
+	add_column("socket_action_us", LogicalTypeId::UBIGINT);
+	add_column("check_multi_calls", LogicalTypeId::UBIGINT);
+	add_column("check_multi_us", LogicalTypeId::UBIGINT);
+	// Fraction of wall time the eventloop thread spends inside curl, close to 1 means the eventloop is saturated.
+	add_column("busy_ratio", LogicalTypeId::DOUBLE);
+
+	return nullptr;
+}
+
+unique_ptr<GlobalTableFunctionState> GetEventLoopStatsFuncInit(ClientContext &context,
+                                                               TableFunctionInitInput &input) {
+	auto result = make_uniq<EventLoopStatsData>();
+	result->snapshots = MultiCurlManager::GetInstance().GetEventLoopStats();
+	return std::move(result);
+}
+
+void GetEventLoopStatsTableFunc(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+	auto &data = data_p.global_state->Cast<EventLoopStatsData>();
+
+	// All entries have been emitted.
+	if (data.offset >= data.snapshots.size()) {
+		return;
+	}
+
+	// Start filling in the result buffer.
+	idx_t count = 0;
+	while (data.offset < data.snapshots.size() && count < STANDARD_VECTOR_SIZE) {
+		auto &entry = data.snapshots[data.offset++];
+		const double uptime_s = static_cast<double>(entry.uptime_ns) / 1e9;
+		idx_t col_idx = 0;
+		output.SetValue(col_idx++, count, Value::UBIGINT(entry.event_loop_idx));
+		output.SetValue(col_idx++, count, GetBackendName(entry.backend));
+		output.SetValue(col_idx++, count, Value::UBIGINT(entry.pending_requests));
+		output.SetValue(col_idx++, count, Value::UBIGINT(entry.queue_wait.GetPercentile(0.5)));
+		output.SetValue(col_idx++, count, Value::UBIGINT(entry.queue_wait.GetPercentile(0.99)));
+		output.SetValue(col_idx++, count, Value::UBIGINT(entry.queue_wait.max_us));
+		output.SetValue(col_idx++, count, Value::UBIGINT(entry.ongoing_requests));
+		output.SetValue(col_idx++, count, Value::UBIGINT(entry.still_running));
+		output.SetValue(col_idx++, count, Value::UBIGINT(entry.pending_deadlines));
+		output.SetValue(col_idx++, count, Value::UBIGINT(entry.wakeups));
+		output.SetValue(col_idx++, count, Value::DOUBLE(SafeDivide(entry.wakeups, uptime_s)));
+		output.SetValue(col_idx++, count, Value::DOUBLE(SafeDivide(entry.events, entry.wakeups)));
+		output.SetValue(col_idx++, count, Value::UBIGINT(entry.socket_action_calls));
+		output.SetValue(col_idx++, count, Value::UBIGINT(entry.socket_action_ns / 1000));
+		output.SetValue(col_idx++, count, Value::UBIGINT(entry.check_multi_calls));
+		output.SetValue(col_idx++, count, Value::UBIGINT(entry.check_multi_ns / 1000));
+		output.SetValue(col_idx++, count,
+		                Value::DOUBLE(SafeDivide(entry.socket_action_ns + entry.check_multi_ns, entry.uptime_ns)));
+		count++;
+	}
+	output.SetCardinality(count);
+}
+} // namespace
+
+TableFunction GetEventLoopStatsFunc() {
+	TableFunction event_loop_stats_query_func {/*name=*/"curl_httpfs_event_loop_stats",
+	                                           /*arguments=*/ {},
+	                                           /*function=*/GetEventLoopStatsTableFunc,
+	                                           /*bind=*/GetEventLoopStatsFuncBind,
+	                                           /*init_global=*/GetEventLoopStatsFuncInit};
+	return event_loop_stats_query_func;
+}
+} // namespace duckdb
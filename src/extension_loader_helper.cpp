@@ -1,10 +1,23 @@
 #include "extension_loader_helper.hpp"
 
+#include "connection_stats_query_function.hpp"
+#include "debug_events_query_function.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/limits.hpp"
 #include "duckdb/main/client_context.hpp"
 #include "duckdb/main/extension/extension_loader.hpp"
+#include "event_loop_stats_query_function.hpp"
 #include "extension_config.hpp"
+#include "http_record_replay.hpp"
 #include "httpfs_client.hpp"
+#include "inflight_requests_query_function.hpp"
+#include "io_uring_ring.hpp"
+#include "metrics_exporter.hpp"
+#include "multi_curl_manager.hpp"
 #include "multi_curl_util.hpp"
+#include "request_latency_query_function.hpp"
+#include "request_trace_query_function.hpp"
+#include "slow_requests_query_function.hpp"
 #include "tcp_connection_query_function.hpp"
 
 namespace duckdb {
@@ -74,8 +87,250 @@ void LoadExtensionInternal(ExtensionLoader &loader) {
 	                          "Turn on and off curl-based http util verbose logging.", LogicalType::BOOLEAN, false,
 	                          callback_set_curl_verbose_logging);
 
+	// Number of eventloops used by multi-curl based http util, each eventloop owns a background thread.
+	auto callback_event_loop_count = [](ClientContext &context, SetScope scope, Value &parameter) {
+		const auto event_loop_count = parameter.GetValue<uint64_t>();
+		if (event_loop_count == 0 || event_loop_count > MultiCurlManager::MAX_EVENT_LOOP_COUNT) {
+			throw InvalidInputException("curl_httpfs_event_loop_count should be within [1, %d], but got %d",
+			                            MultiCurlManager::MAX_EVENT_LOOP_COUNT, event_loop_count);
+		}
+		EVENT_LOOP_COUNT = event_loop_count;
+	};
+	config.AddExtensionOption("curl_httpfs_event_loop_count",
+	                          "Number of eventloops used by multi-curl based http util, defaults to a value derived "
+	                          "from CPU core number.",
+	                          LogicalType::UBIGINT, Value::UBIGINT(MultiCurlManager::GetDefaultEventLoopCount()),
+	                          std::move(callback_event_loop_count));
+
+	// Select how requests are dispatched to eventloops.
+	auto callback_event_loop_routing = [](ClientContext &context, SetScope scope, Value &parameter) {
+		const string value = StringValue::Get(parameter);
+		if (value == "round_robin") {
+			EVENT_LOOP_ROUTING = EventLoopRouting::ROUND_ROBIN;
+			return;
+		}
+		if (value == "host") {
+			EVENT_LOOP_ROUTING = EventLoopRouting::HOST;
+			return;
+		}
+		throw InvalidInputException("Unsupported option for curl_httpfs_event_loop_routing, only `round_robin` and "
+		                            "`host` are currently supported");
+	};
+	config.AddExtensionOption("curl_httpfs_event_loop_routing",
+	                          "Select how requests are dispatched to eventloops. Supports `host` (default), which keeps "
+	                          "all requests to one host on the same connection pool, and `round_robin`.",
+	                          LogicalType {LogicalTypeId::VARCHAR}, "host",
+	                          std::move(callback_event_loop_routing));
+
+	// Provide option to stream GET response body to the caller, instead of buffering the whole response.
+	auto callback_set_streaming_read = [](ClientContext &context, SetScope scope, Value &parameter) {
+		ENABLE_STREAMING_READ = parameter.GetValue<bool>();
+	};
+	config.AddExtensionOption("curl_httpfs_enable_streaming_read",
+	                          "Stream GET response body to the reader as it arrives, instead of buffering the whole "
+	                          "response for multi-curl based http util.",
+	                          LogicalType::BOOLEAN, DEFAULT_ENABLE_STREAMING_READ, callback_set_streaming_read);
+
+	// Provide option to register sockets to epoll in edge-triggered mode, which saves wakeups for sockets staying ready.
+	auto callback_set_epoll_edge_triggered = [](ClientContext &context, SetScope scope, Value &parameter) {
+		ENABLE_EPOLL_EDGE_TRIGGERED = parameter.GetValue<bool>();
+	};
+	config.AddExtensionOption("curl_httpfs_enable_epoll_edge_triggered",
+	                          "Register sockets to epoll in edge-triggered mode, only takes effect on linux.",
+	                          LogicalType::BOOLEAN, DEFAULT_ENABLE_EPOLL_EDGE_TRIGGERED,
+	                          callback_set_epoll_edge_triggered);
+
+	// Provide option to select polling engine for eventloops.
+	auto callback_event_loop_backend = [](ClientContext &context, SetScope scope, Value &parameter) {
+		const string value = StringValue::Get(parameter);
+		if (value == "epoll") {
+			EVENT_LOOP_BACKEND = EventLoopBackend::EPOLL;
+			return;
+		}
+		if (value == "io_uring") {
+#ifdef __linux__
+			if (!IoUring::IsSupported()) {
+				throw InvalidInputException("io_uring is not supported by the kernel, which requires linux 5.11 or "
+				                            "later and not being disabled by seccomp");
+			}
+			EVENT_LOOP_BACKEND = EventLoopBackend::IO_URING;
+			return;
+#else
+			throw InvalidInputException("io_uring backend for curl_httpfs_event_loop_backend is only supported on "
+			                            "linux");
+#endif
+		}
+		throw InvalidInputException("Unsupported option for curl_httpfs_event_loop_backend, only `epoll` and "
+		                            "`io_uring` are currently supported");
+	};
+	config.AddExtensionOption("curl_httpfs_event_loop_backend",
+	                          "Select polling engine for eventloops. Supports `epoll` (default, kqueue on macOS) and "
+	                          "`io_uring` (linux only), which only takes effect for eventloops created afterwards.",
+	                          LogicalType {LogicalTypeId::VARCHAR}, "epoll", std::move(callback_event_loop_backend));
+
+	// Provide option to set deadline for requests, after which they're cancelled by eventloops.
+	auto callback_request_deadline = [](ClientContext &context, SetScope scope, Value &parameter) {
+		REQUEST_DEADLINE_MS = parameter.GetValue<uint64_t>();
+	};
+	config.AddExtensionOption("curl_httpfs_request_deadline_ms",
+	                          "Deadline in milliseconds for each request of multi-curl based http util, which covers "
+	                          "both queueing and transfer; 0 (default) means no deadline.",
+	                          LogicalType::UBIGINT, Value::UBIGINT(DEFAULT_REQUEST_DEADLINE_MS),
+	                          callback_request_deadline);
+
+	// Provide options to tune connection limits, which are applied to live eventloops without restart.
+	auto callback_max_connections_per_host = [](ClientContext &context, SetScope scope, Value &parameter) {
+		MAX_CONNECTIONS_PER_HOST = parameter.GetValue<uint64_t>();
+		MultiCurlManager::GetInstance().RefreshConnectionLimits();
+	};
+	config.AddExtensionOption("curl_httpfs_max_connections_per_host",
+	                          "Max number of connections to a single host per eventloop for multi-curl based http "
+	                          "util, requests beyond the limit are queued; 0 means no limit.",
+	                          LogicalType::UBIGINT, Value::UBIGINT(DEFAULT_MAX_CONNECTIONS_PER_HOST),
+	                          callback_max_connections_per_host);
+
+	auto callback_max_total_connections = [](ClientContext &context, SetScope scope, Value &parameter) {
+		MAX_TOTAL_CONNECTIONS = parameter.GetValue<uint64_t>();
+		MultiCurlManager::GetInstance().RefreshConnectionLimits();
+	};
+	config.AddExtensionOption("curl_httpfs_max_total_connections",
+	                          "Max number of connections per eventloop across all hosts for multi-curl based http "
+	                          "util, requests beyond the limit are queued; 0 (default) means no limit.",
+	                          LogicalType::UBIGINT, Value::UBIGINT(DEFAULT_MAX_TOTAL_CONNECTIONS),
+	                          callback_max_total_connections);
+
+	auto callback_max_connects = [](ClientContext &context, SetScope scope, Value &parameter) {
+		MAX_CONNECTS = parameter.GetValue<uint64_t>();
+		MultiCurlManager::GetInstance().RefreshConnectionLimits();
+	};
+	config.AddExtensionOption("curl_httpfs_max_connects",
+	                          "Max number of idle connections cached per eventloop for multi-curl based http util; 0 "
+	                          "(default) lets curl size the cache by the number of ongoing requests.",
+	                          LogicalType::UBIGINT, Value::UBIGINT(DEFAULT_MAX_CONNECTS), callback_max_connects);
+
+	auto callback_max_concurrent_streams = [](ClientContext &context, SetScope scope, Value &parameter) {
+		const auto max_concurrent_streams = parameter.GetValue<uint64_t>();
+		if (max_concurrent_streams == 0 || max_concurrent_streams > NumericLimits<int32_t>::Maximum()) {
+			throw InvalidInputException("curl_httpfs_max_concurrent_streams should be within [1, %d], but got %d",
+			                            NumericLimits<int32_t>::Maximum(), max_concurrent_streams);
+		}
+		MAX_CONCURRENT_STREAMS = max_concurrent_streams;
+		MultiCurlManager::GetInstance().RefreshConnectionLimits();
+	};
+	config.AddExtensionOption("curl_httpfs_max_concurrent_streams",
+	                          "Max number of concurrent streams on a single HTTP/2 connection for multi-curl based "
+	                          "http util.",
+	                          LogicalType::UBIGINT, Value::UBIGINT(DEFAULT_MAX_CONCURRENT_STREAMS),
+	                          callback_max_concurrent_streams);
+
+	// Provide option to record timeline of requests, which could be exported via `curl_httpfs_export_request_trace`.
+	auto callback_enable_request_trace = [](ClientContext &context, SetScope scope, Value &parameter) {
+		ENABLE_REQUEST_TRACE = parameter.GetValue<bool>();
+	};
+	config.AddExtensionOption("curl_httpfs_enable_request_trace",
+	                          "Record timeline of each request of multi-curl based http util into an in-memory ring, "
+	                          "which is exported by `curl_httpfs_export_request_trace(path)` in Chrome trace format.",
+	                          LogicalType::BOOLEAN, DEFAULT_ENABLE_REQUEST_TRACE, callback_enable_request_trace);
+
+	// Provide options to collect curl debug events into in-memory rings, which replaces verbose logging to stderr.
+	auto callback_enable_debug_events = [](ClientContext &context, SetScope scope, Value &parameter) {
+		ENABLE_DEBUG_EVENTS = parameter.GetValue<bool>();
+	};
+	config.AddExtensionOption("curl_httpfs_enable_debug_events",
+	                          "Collect curl debug events of multi-curl based http util into per-eventloop in-memory "
+	                          "rings, which are read by `curl_httpfs_debug_events()`.",
+	                          LogicalType::BOOLEAN, DEFAULT_ENABLE_DEBUG_EVENTS, callback_enable_debug_events);
+
+	auto callback_debug_events_sample_rate = [](ClientContext &context, SetScope scope, Value &parameter) {
+		const auto sample_rate = parameter.GetValue<double>();
+		if (!(sample_rate >= 0.0 && sample_rate <= 1.0)) {
+			throw InvalidInputException("curl_httpfs_debug_events_sample_rate should be within [0, 1], but got %f",
+			                            sample_rate);
+		}
+		DEBUG_EVENTS_SAMPLE_RATE = sample_rate;
+	};
+	config.AddExtensionOption("curl_httpfs_debug_events_sample_rate",
+	                          "Fraction of requests whose curl debug events are collected, within [0, 1].",
+	                          LogicalType::DOUBLE, Value::DOUBLE(DEFAULT_DEBUG_EVENTS_SAMPLE_RATE),
+	                          callback_debug_events_sample_rate);
+
+	// Provide option to log requests slower than the threshold, which could be queried via `curl_httpfs_slow_requests`.
+	auto callback_slow_request_threshold = [](ClientContext &context, SetScope scope, Value &parameter) {
+		SLOW_REQUEST_THRESHOLD_MS = parameter.GetValue<uint64_t>();
+	};
+	config.AddExtensionOption("curl_httpfs_slow_request_threshold_ms",
+	                          "Requests of multi-curl based http util taking longer than the threshold in milliseconds "
+	                          "are recorded into an in-memory log, which is read by `curl_httpfs_slow_requests()`; 0 "
+	                          "(default) means disabled.",
+	                          LogicalType::UBIGINT, Value::UBIGINT(DEFAULT_SLOW_REQUEST_THRESHOLD_MS),
+	                          callback_slow_request_threshold);
+
+	// Provide option to serve Prometheus metrics, on a TCP port or a Unix socket.
+	auto callback_metrics_endpoint = [](ClientContext &context, SetScope scope, Value &parameter) {
+		MetricsExporter::GetInstance().SetEndpoint(StringValue::Get(parameter));
+	};
+	config.AddExtensionOption("curl_httpfs_metrics_endpoint",
+	                          "Serve Prometheus metrics of multi-curl based http util at `/metrics` on the given "
+	                          "endpoint, either `<host>:<port>` or `unix:<path>`; empty (default) disables serving.",
+	                          LogicalType {LogicalTypeId::VARCHAR}, "", callback_metrics_endpoint);
+
+	// Provide options to record requests of multi-curl based http util into an archive, and to replay them from it.
+	// Archives are accessed through the database file system, so external access settings apply to them.
+	auto callback_http_record_path = [](ClientContext &context, SetScope scope, Value &parameter) {
+		HttpRecorder::GetInstance().SetPath(FileSystem::GetFileSystem(context), StringValue::Get(parameter));
+	};
+	config.AddExtensionOption("curl_httpfs_http_record_path",
+	                          "Record every request of multi-curl based http util and its response into an archive at "
+	                          "the given path, which truncates the existing file; empty (default) disables recording.",
+	                          LogicalType {LogicalTypeId::VARCHAR}, "", callback_http_record_path);
+	auto callback_http_replay_path = [](ClientContext &context, SetScope scope, Value &parameter) {
+		HttpReplayer::GetInstance().SetPath(FileSystem::GetFileSystem(context), StringValue::Get(parameter));
+	};
+	config.AddExtensionOption("curl_httpfs_http_replay_path",
+	                          "Serve requests of multi-curl based http util from the archive at the given path without "
+	                          "network access; empty (default) disables replaying.",
+	                          LogicalType {LogicalTypeId::VARCHAR}, "", callback_http_replay_path);
+	auto callback_http_replay_latency = [](ClientContext &context, SetScope scope, Value &parameter) {
+		const string value = StringValue::Get(parameter);
+		if (value == "recorded") {
+			REPLAY_LATENCY = ReplayLatency::RECORDED;
+			return;
+		}
+		if (value == "none") {
+			REPLAY_LATENCY = ReplayLatency::NONE;
+			return;
+		}
+		throw InvalidInputException("Unsupported option for curl_httpfs_http_replay_latency, only `recorded` and "
+		                            "`none` are currently supported");
+	};
+	config.AddExtensionOption("curl_httpfs_http_replay_latency",
+	                          "Latency of replayed responses. Supports `recorded` (default), which delays each response "
+	                          "by its recorded duration, and `none`.",
+	                          LogicalType {LogicalTypeId::VARCHAR}, "recorded", callback_http_replay_latency);
+
 	// Register TCP connection status function.
-	loader.RegisterFunction(GetTcpConnectionNumFunc());
+	loader.RegisterFunction(GetTcpConnectionFunc());
+
+	// Register request phase latency function.
+	loader.RegisterFunction(GetRequestLatencyFunc());
+
+	// Register connection reuse and handshake stats function.
+	loader.RegisterFunction(GetConnectionStatsFunc());
+
+	// Register curl debug events function.
+	loader.RegisterFunction(GetDebugEventsFunc());
+
+	// Register slow requests function.
+	loader.RegisterFunction(GetSlowRequestsFunc());
+
+	// Register eventloop health metrics function.
+	loader.RegisterFunction(GetEventLoopStatsFunc());
+
+	// Register requests in flight function.
+	loader.RegisterFunction(GetInflightRequestsFunc());
+
+	// Register request trace export function.
+	loader.RegisterFunction(GetExportRequestTraceFunc());
 }
 
 } // namespace duckdb
@@ -0,0 +1,159 @@
+#include "http_archive.hpp"
+
+#include <strings.h>
+
+#include "duckdb/common/exception.hpp"
+
+namespace duckdb {
+
+namespace {
+
+constexpr const char *ARCHIVE_MAGIC = "CHFSHAR1";
+constexpr idx_t ARCHIVE_MAGIC_LEN = 8;
+
+void AppendVarint(string &out, uint64_t value) {
+	while (value >= 0x80) {
+		out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+		value >>= 7;
+	}
+	out.push_back(static_cast<char>(value));
+}
+
+void AppendString(string &out, const string &value) {
+	AppendVarint(out, value.size());
+	out.append(value);
+}
+
+void AppendHeaders(string &out, const vector<std::pair<string, string>> &headers) {
+	AppendVarint(out, headers.size());
+	for (const auto &cur_header : headers) {
+		AppendString(out, cur_header.first);
+		AppendString(out, cur_header.second);
+	}
+}
+
+// Reads fields of an encoded entry, all reads fail once the input is exhausted.
+class EntryReader {
+public:
+	EntryReader(const char *data_p, idx_t size_p) : data(data_p), size(size_p) {
+	}
+
+	bool ReadVarint(uint64_t &value) {
+		value = 0;
+		for (idx_t shift = 0; shift < 64; shift += 7) {
+			if (offset >= size) {
+				return false;
+			}
+			const auto byte = static_cast<uint8_t>(data[offset++]);
+			value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+			if ((byte & 0x80) == 0) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool ReadString(string &value) {
+		uint64_t len = 0;
+		if (!ReadVarint(len) || len > size - offset) {
+			return false;
+		}
+		value.assign(data + offset, len);
+		offset += len;
+		return true;
+	}
+
+	bool ReadHeaders(vector<std::pair<string, string>> &headers) {
+		uint64_t count = 0;
+		if (!ReadVarint(count)) {
+			return false;
+		}
+		for (uint64_t idx = 0; idx < count; ++idx) {
+			std::pair<string, string> header;
+			if (!ReadString(header.first) || !ReadString(header.second)) {
+				return false;
+			}
+			headers.emplace_back(std::move(header));
+		}
+		return true;
+	}
+
+	bool AtEnd() const {
+		return offset == size;
+	}
+
+private:
+	const char *data;
+	const idx_t size;
+	idx_t offset = 0;
+};
+
+bool DecodeEntry(const char *data, idx_t size, HttpArchiveEntry &entry) {
+	EntryReader reader {data, size};
+	uint64_t status_code = 0;
+	if (!reader.ReadString(entry.method) || !reader.ReadString(entry.url) ||
+	    !reader.ReadHeaders(entry.request_headers) || !reader.ReadVarint(status_code) ||
+	    !reader.ReadString(entry.request_error) || !reader.ReadHeaders(entry.response_headers) ||
+	    !reader.ReadString(entry.body) || !reader.ReadVarint(entry.duration_us)) {
+		return false;
+	}
+	entry.status_code = static_cast<uint16_t>(status_code);
+	return reader.AtEnd();
+}
+
+} // namespace
+
+string HttpArchiveEntry::GetRange() const {
+	for (const auto &cur_header : request_headers) {
+		if (strcasecmp(cur_header.first.c_str(), "range") == 0) {
+			return cur_header.second;
+		}
+	}
+	return "";
+}
+
+HttpArchiveWriter::HttpArchiveWriter(FileSystem &fs, const string &path)
+    : handle(fs.OpenFile(path, FileFlags::FILE_FLAGS_WRITE | FileFlags::FILE_FLAGS_FILE_CREATE_NEW)) {
+	handle->Write(const_cast<char *>(ARCHIVE_MAGIC), ARCHIVE_MAGIC_LEN);
+}
+
+void HttpArchiveWriter::Append(const HttpArchiveEntry &entry) {
+	string encoded;
+	AppendString(encoded, entry.method);
+	AppendString(encoded, entry.url);
+	AppendHeaders(encoded, entry.request_headers);
+	AppendVarint(encoded, entry.status_code);
+	AppendString(encoded, entry.request_error);
+	AppendHeaders(encoded, entry.response_headers);
+	AppendString(encoded, entry.body);
+	AppendVarint(encoded, entry.duration_us);
+
+	string record;
+	AppendVarint(record, encoded.size());
+	record.append(encoded);
+	handle->Write(const_cast<char *>(record.data()), record.size());
+}
+
+vector<HttpArchiveEntry> ReadHttpArchive(FileSystem &fs, const string &path) {
+	auto handle = fs.OpenFile(path, FileFlags::FILE_FLAGS_READ);
+	string content(static_cast<idx_t>(handle->GetFileSize()), '\0');
+	handle->Read(&content[0], content.size(), /*location=*/0);
+	if (content.size() < ARCHIVE_MAGIC_LEN || content.compare(0, ARCHIVE_MAGIC_LEN, ARCHIVE_MAGIC) != 0) {
+		throw IOException("%s is not an HTTP archive", path);
+	}
+
+	vector<HttpArchiveEntry> entries;
+	EntryReader reader {content.data() + ARCHIVE_MAGIC_LEN, content.size() - ARCHIVE_MAGIC_LEN};
+	// Stop at the first incomplete entry, which is left by an interrupted recording.
+	string encoded;
+	while (reader.ReadString(encoded)) {
+		HttpArchiveEntry entry;
+		if (!DecodeEntry(encoded.data(), encoded.size(), entry)) {
+			throw IOException("HTTP archive %s has a corrupted entry", path);
+		}
+		entries.emplace_back(std::move(entry));
+	}
+	return entries;
+}
+
+} // namespace duckdb
@@ -0,0 +1,84 @@
+#include "http_metrics.hpp"
+
+#include <cstring>
+
+#include "connection_stats_registry.hpp"
+
+namespace duckdb {
+
+const char *GetHttpMethodName(HttpMethod method) {
+	switch (method) {
+	case HttpMethod::GET:
+		return "GET";
+	case HttpMethod::HEAD:
+		return "HEAD";
+	case HttpMethod::PUT:
+		return "PUT";
+	case HttpMethod::POST:
+		return "POST";
+	case HttpMethod::DELETE:
+		return "DELETE";
+	}
+	return "GET";
+}
+
+HttpMethod GetHttpMethod(const char *method_name) {
+	for (idx_t idx = 0; idx < HTTP_METHOD_COUNT; ++idx) {
+		const auto method = static_cast<HttpMethod>(idx);
+		if (std::strcmp(method_name, GetHttpMethodName(method)) == 0) {
+			return method;
+		}
+	}
+	return HttpMethod::GET;
+}
+
+/*static*/ HttpMetrics &HttpMetrics::GetInstance() {
+	static auto *metrics = new HttpMetrics();
+	return *metrics;
+}
+
+void HttpMetrics::RecordRequest(HttpMethod method, uint16_t status_code) {
+	const idx_t slot = status_code < STATUS_CODE_SLOTS ? status_code : 0;
+	request_counts[static_cast<idx_t>(method)][slot].fetch_add(1, std::memory_order_relaxed);
+}
+
+void HttpMetrics::RecordTransfer(HttpMethod method, const CurlTransferInfo &info, CURLcode result) {
+	const idx_t method_idx = static_cast<idx_t>(method);
+	bytes_received[method_idx].fetch_add(static_cast<uint64_t>(info.bytes_received), std::memory_order_relaxed);
+	bytes_sent[method_idx].fetch_add(static_cast<uint64_t>(info.bytes_sent), std::memory_order_relaxed);
+	if (info.new_connects > 0) {
+		connections_opened.fetch_add(static_cast<uint64_t>(info.new_connects), std::memory_order_relaxed);
+	} else if (IsConnectionReused(result, info.connect_us)) {
+		connections_reused.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+void HttpMetrics::RecordWait(int64_t wait_us) {
+	request_wait.Record(wait_us);
+}
+
+uint64_t HttpMetrics::GetRequestCount(HttpMethod method, idx_t status_code_slot) const {
+	return request_counts[static_cast<idx_t>(method)][status_code_slot].load(std::memory_order_relaxed);
+}
+
+uint64_t HttpMetrics::GetBytesReceived(HttpMethod method) const {
+	return bytes_received[static_cast<idx_t>(method)].load(std::memory_order_relaxed);
+}
+
+uint64_t HttpMetrics::GetBytesSent(HttpMethod method) const {
+	return bytes_sent[static_cast<idx_t>(method)].load(std::memory_order_relaxed);
+}
+
+uint64_t HttpMetrics::GetConnectionsOpened() const {
+	return connections_opened.load(std::memory_order_relaxed);
+}
+
+uint64_t HttpMetrics::GetConnectionsReused() const {
+	return connections_reused.load(std::memory_order_relaxed);
+}
+
+LatencyHistogram::Snapshot HttpMetrics::GetWaitSnapshot() const {
+	return request_wait.GetSnapshot();
+}
+
+} // namespace duckdb
@@ -0,0 +1,81 @@
+#include "http_profiling_state.hpp"
+
+#include <algorithm>
+
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/common/vector.hpp"
+#include "duckdb/main/query_profiler.hpp"
+#include "time_utils.hpp"
+
+namespace duckdb {
+
+namespace {
+
+// Same width as the HTTP stats box of httpfs, so both boxes line up in the profiler output.
+constexpr idx_t TOTAL_BOX_WIDTH = 39;
+
+string FormatMillis(uint64_t duration_ns) {
+	return StringUtil::Format("%.3f ms", static_cast<double>(duration_ns) / 1e6);
+}
+
+} // namespace
+
+void HTTPProfilingState::QueryBegin(ClientContext &context) {
+	Reset();
+	query_begin_ns.store(GetSteadyNowNs(), std::memory_order_relaxed);
+}
+
+void HTTPProfilingState::Reset() {
+	request_count.store(0, std::memory_order_relaxed);
+	total_wait_ns.store(0, std::memory_order_relaxed);
+	max_wait_ns.store(0, std::memory_order_relaxed);
+	total_bytes_received.store(0, std::memory_order_relaxed);
+	total_bytes_sent.store(0, std::memory_order_relaxed);
+}
+
+void HTTPProfilingState::RecordRequest(std::chrono::nanoseconds wait_time, uint64_t bytes_received,
+                                       uint64_t bytes_sent) {
+	const uint64_t wait_ns = static_cast<uint64_t>(std::max<int64_t>(wait_time.count(), 0));
+	request_count.fetch_add(1, std::memory_order_relaxed);
+	total_wait_ns.fetch_add(wait_ns, std::memory_order_relaxed);
+	total_bytes_received.fetch_add(bytes_received, std::memory_order_relaxed);
+	total_bytes_sent.fetch_add(bytes_sent, std::memory_order_relaxed);
+	uint64_t cur_max = max_wait_ns.load(std::memory_order_relaxed);
+	while (cur_max < wait_ns && !max_wait_ns.compare_exchange_weak(cur_max, wait_ns, std::memory_order_relaxed)) {
+	}
+}
+
+void HTTPProfilingState::WriteProfilingInformation(std::ostream &ss) {
+	const uint64_t cur_request_count = request_count.load(std::memory_order_relaxed);
+	if (cur_request_count == 0) {
+		return;
+	}
+	const uint64_t cur_wait_ns = total_wait_ns.load(std::memory_order_relaxed);
+	const int64_t begin_ns = query_begin_ns.load(std::memory_order_relaxed);
+	const int64_t elapsed_ns = begin_ns == 0 ? 0 : GetSteadyNowNs() - begin_ns;
+
+	vector<string> lines;
+	lines.emplace_back("#requests: " + std::to_string(cur_request_count));
+	lines.emplace_back("wait: " + FormatMillis(cur_wait_ns));
+	lines.emplace_back("max wait: " + FormatMillis(max_wait_ns.load(std::memory_order_relaxed)));
+	// Average number of threads blocked on the network; compare with the thread count to see how much of the scan
+	// is spent waiting rather than decoding.
+	if (elapsed_ns > 0) {
+		lines.emplace_back(StringUtil::Format("avg blocked threads: %.2f",
+		                                      static_cast<double>(cur_wait_ns) / static_cast<double>(elapsed_ns)));
+	}
+	lines.emplace_back("in: " + StringUtil::BytesToHumanReadableString(total_bytes_received.load()));
+	lines.emplace_back("out: " + StringUtil::BytesToHumanReadableString(total_bytes_sent.load()));
+
+	ss << "┌─────────────────────────────────────┐\n";
+	ss << "│┌───────────────────────────────────┐│\n";
+	ss << "││" + QueryProfiler::DrawPadded("Multi-curl HTTP Wait", TOTAL_BOX_WIDTH - 4) + "││\n";
+	ss << "││                                   ││\n";
+	for (const auto &cur_line : lines) {
+		ss << "││" + QueryProfiler::DrawPadded(cur_line, TOTAL_BOX_WIDTH - 4) + "││\n";
+	}
+	ss << "│└───────────────────────────────────┘│\n";
+	ss << "└─────────────────────────────────────┘\n";
+}
+
+} // namespace duckdb
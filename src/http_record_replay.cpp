@@ -0,0 +1,154 @@
+#include "http_record_replay.hpp"
+
+#include <algorithm>
+#include <thread>
+
+#include "credential_redaction.hpp"
+#include "curl_request.hpp"
+#include "duckdb/common/helper.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "extension_config.hpp"
+
+namespace duckdb {
+
+namespace {
+
+// Archived URLs have credentials redacted, so requests are matched by redacted URL; signatures of presigned URLs
+// change on every run anyway.
+string GetReplayKey(const string &method, const string &redacted_url, const string &range) {
+	return method + " " + redacted_url + " " + range;
+}
+
+// Sleep for the given duration, or until the given check reports interruption.
+void SleepUnlessInterrupted(std::chrono::microseconds duration, const CurlInterruptCheck &interrupt_check) {
+	const auto deadline = std::chrono::steady_clock::now() + duration;
+	WaitUnlessInterrupted(
+	    [&deadline](std::chrono::nanoseconds timeout) {
+		    const auto now = std::chrono::steady_clock::now();
+		    if (now >= deadline) {
+			    return true;
+		    }
+		    std::this_thread::sleep_for(std::min<std::chrono::nanoseconds>(deadline - now, timeout));
+		    return std::chrono::steady_clock::now() >= deadline;
+	    },
+	    interrupt_check);
+}
+
+} // namespace
+
+/*static*/ HttpRecorder &HttpRecorder::GetInstance() {
+	static auto *recorder = new HttpRecorder();
+	return *recorder;
+}
+
+void HttpRecorder::SetPath(FileSystem &fs, const string &path) {
+	const std::lock_guard<std::mutex> lck(mu);
+	recording = false;
+	writer.reset();
+	if (path.empty()) {
+		return;
+	}
+	writer = make_uniq<HttpArchiveWriter>(fs, path);
+	recording = true;
+}
+
+void HttpRecorder::Record(const char *method, const string &url, const curl_slist *headers,
+                          const HTTPResponse &response, std::chrono::nanoseconds duration) {
+	HttpArchiveEntry entry;
+	entry.method = method;
+	entry.url = RedactUrlCredentials(url);
+	for (const auto *cur_header = headers; cur_header != nullptr; cur_header = cur_header->next) {
+		const string header = cur_header->data;
+		const auto colon_pos = header.find(':');
+		if (colon_pos == string::npos) {
+			continue;
+		}
+		string name = header.substr(0, colon_pos);
+		string value = header.substr(colon_pos + 1);
+		StringUtil::Trim(value);
+		if (IsCredentialHeader(name.data(), name.size())) {
+			value = REDACTED_VALUE;
+		}
+		entry.request_headers.emplace_back(std::move(name), std::move(value));
+	}
+	entry.status_code = static_cast<uint16_t>(response.status);
+	if (response.HasRequestError()) {
+		entry.request_error = response.GetRequestError();
+	}
+	for (const auto &cur_header : response.headers) {
+		entry.response_headers.emplace_back(cur_header.first, cur_header.second);
+	}
+	entry.body = response.body;
+	entry.duration_us =
+	    static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+
+	const std::lock_guard<std::mutex> lck(mu);
+	// Recording could have been stopped meanwhile.
+	if (writer != nullptr) {
+		writer->Append(entry);
+	}
+}
+
+/*static*/ HttpReplayer &HttpReplayer::GetInstance() {
+	static auto *replayer = new HttpReplayer();
+	return *replayer;
+}
+
+void HttpReplayer::SetPath(FileSystem &fs, const string &path) {
+	// Read the archive before taking the lock, so ongoing replays aren't blocked by IO; the current archive is kept if
+	// the new one fails to load.
+	unordered_map<string, RecordedResponses> new_recorded_responses;
+	if (!path.empty()) {
+		for (auto &cur_entry : ReadHttpArchive(fs, path)) {
+			const string key = GetReplayKey(cur_entry.method, cur_entry.url, cur_entry.GetRange());
+			new_recorded_responses[key].entries.emplace_back(make_shared_ptr<const HttpArchiveEntry>(std::move(cur_entry)));
+		}
+	}
+	const std::lock_guard<std::mutex> lck(mu);
+	recorded_responses = std::move(new_recorded_responses);
+	replaying = !path.empty();
+}
+
+shared_ptr<const HttpArchiveEntry> HttpReplayer::GetNextEntry(const string &key) {
+	const std::lock_guard<std::mutex> lck(mu);
+	auto iter = recorded_responses.find(key);
+	if (iter == recorded_responses.end()) {
+		return nullptr;
+	}
+	auto &responses = iter->second;
+	auto entry = responses.entries[responses.next];
+	responses.next = (responses.next + 1) % responses.entries.size();
+	return entry;
+}
+
+unique_ptr<HTTPResponse> HttpReplayer::Replay(const char *method, const string &url, const curl_slist *headers,
+                                              const CurlInterruptCheck &interrupt_check) {
+	const string range = GetRangeHeader(headers);
+	const string redacted_url = RedactUrlCredentials(url);
+	auto entry = GetNextEntry(GetReplayKey(method, redacted_url, range));
+	if (entry == nullptr) {
+		const HTTPStatusCode status_code = HTTPUtil::ToStatusCode(0);
+		auto response = make_uniq<HTTPResponse>(status_code);
+		response->url = url;
+		response->reason = HTTPUtil::GetStatusMessage(status_code);
+		response->request_error = StringUtil::Format("No recorded response for %s %s%s", method, redacted_url,
+		                                             range.empty() ? "" : " with range " + range);
+		return response;
+	}
+
+	if (REPLAY_LATENCY.load(std::memory_order_relaxed) == ReplayLatency::RECORDED) {
+		SleepUnlessInterrupted(std::chrono::microseconds(entry->duration_us), interrupt_check);
+	}
+	const HTTPStatusCode status_code = HTTPUtil::ToStatusCode(entry->status_code);
+	auto response = make_uniq<HTTPResponse>(status_code);
+	response->url = url;
+	response->reason = HTTPUtil::GetStatusMessage(status_code);
+	response->request_error = entry->request_error;
+	for (const auto &cur_header : entry->response_headers) {
+		response->headers.Insert(cur_header.first, cur_header.second);
+	}
+	response->body = entry->body;
+	return response;
+}
+
+} // namespace duckdb
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <mutex>
+
+#include "duckdb/common/shared_ptr.hpp"
+#include "duckdb/common/unordered_map.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "http_state.hpp"
+
+namespace duckdb {
+
+// Records the client context each HTTP state belongs to, so HTTP clients, which only see HTTP params, could observe
+// query interruption of the client context they work for.
+//
+// HTTP state is created per client context, and registered when HTTP params are initialized for the context.
+class ClientContextRegistry {
+public:
+	static ClientContextRegistry &GetInstance();
+
+	// Disable copy / move constructor / assignment.
+	ClientContextRegistry(const ClientContextRegistry &) = delete;
+	ClientContextRegistry &operator=(const ClientContextRegistry &) = delete;
+
+	// Record the client context for the given HTTP state.
+	void Register(const HTTPState &http_state, ClientContext &context);
+	// Get the client context for the given HTTP state, return empty pointer if unknown.
+	weak_ptr<ClientContext> Get(const HTTPState &http_state);
+
+private:
+	ClientContextRegistry() = default;
+
+	std::mutex mu;
+	// Number of entries after which expired entries are pruned, grows with live entries to amortize pruning.
+	idx_t prune_threshold = 1024;
+	// Keyed by address, an entry left by destructed state gets overwritten once the address is reused.
+	unordered_map<const HTTPState *, weak_ptr<ClientContext>> client_contexts;
+};
+
+} // namespace duckdb
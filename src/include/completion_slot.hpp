@@ -0,0 +1,84 @@
+// A lightweight completion primitive, used to block wait for a single request.
+//
+// Compared with `std::promise` / `std::future`, a completion slot takes no heap allocation, mutex or condition variable
+// per request:
+// - Slots are carved out of slabs which are never freed, and recycled via a per-thread free list; a slot is always
+//   acquired and released by the waiting thread, so recycling needs no synchronization.
+// - The waiter spins for a short while, then parks on a futex (on linux); the completing thread only issues a wakeup
+//   syscall if the waiter has actually parked.
+// - Completion and wakeup are split, so the eventloop could publish all responses of one pass first, and wake up parked
+//   waiters afterwards in one batch.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "duckdb/common/http_util.hpp"
+#include "duckdb/common/unique_ptr.hpp"
+
+#ifndef __linux__
+#include <condition_variable>
+#include <mutex>
+#endif
+
+namespace duckdb {
+
+class CompletionSlot {
+public:
+	friend class CompletionSlotFreeList;
+
+	// Acquire a slot for the current thread, which should be released by the same thread after [`Wait`] returns.
+	static CompletionSlot *Acquire();
+	// Return the given slot to the current thread's free list.
+	static void Release(CompletionSlot *slot);
+
+	CompletionSlot() = default;
+	~CompletionSlot() = default;
+
+	// Disable copy / move constructor / assignment.
+	CompletionSlot(const CompletionSlot &) = delete;
+	CompletionSlot &operator=(const CompletionSlot &) = delete;
+
+	// Publish the response, return whether the waiter has parked and needs to be woken up via [`Wake`].
+	// Called by the completing thread, at most once per acquisition.
+	bool Complete(unique_ptr<HTTPResponse> response_p);
+	// Wake up the parked waiter.
+	// The slot could have been released and reacquired by then, which only leads to a spurious wakeup.
+	void Wake();
+	// Block until completed, and take the response.
+	// Called by the thread which acquires the slot.
+	unique_ptr<HTTPResponse> Wait();
+	// Block until completed or timeout, return whether completed; the response is taken via [`Wait`] afterwards.
+	// Called by the thread which acquires the slot.
+	bool WaitFor(std::chrono::nanoseconds timeout);
+
+private:
+	// Poll for completion for a short while, return whether completed.
+	bool Spin() const;
+	// Announce the waiter is about to park, unless completion happens in between.
+	void PrepareToPark();
+
+	// Number of polls before the waiter parks.
+	static constexpr int SPIN_COUNT = 64;
+
+	enum : uint32_t {
+		PENDING = 0,
+		// The waiter has parked, or is about to park.
+		PARKED = 1,
+		COMPLETED = 2,
+	};
+
+	std::atomic<uint32_t> state {PENDING};
+	// Written before [`state`] turns [`COMPLETED`], and read after.
+	unique_ptr<HTTPResponse> response;
+	// Next slot in the owning thread's free list.
+	CompletionSlot *next_free = nullptr;
+#ifndef __linux__
+	std::mutex mu;
+	std::condition_variable cv;
+#endif
+};
+
+} // namespace duckdb
@@ -0,0 +1,12 @@
+// Function which gets per-host connection reuse and handshake stats.
+
+#pragma once
+
+#include "duckdb/function/table_function.hpp"
+
+namespace duckdb {
+
+// Get the table function to get connection reuse and handshake counters per host.
+TableFunction GetConnectionStatsFunc();
+
+} // namespace duckdb
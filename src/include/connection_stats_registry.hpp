@@ -0,0 +1,55 @@
+// Per-host connection reuse and handshake counters of completed transfers, which tell how often requests pay for a
+// new TCP connection and TLS handshake instead of reusing a cached connection or HTTP/2 stream.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <curl/curl.h>
+
+#include "curl_transfer_info.hpp"
+#include "duckdb/common/string.hpp"
+#include "host_registry.hpp"
+
+namespace duckdb {
+
+// Whether a finished transfer which opened no connection has reused one, rather than failed before getting any.
+bool IsConnectionReused(CURLcode result, curl_off_t connect_us);
+
+// Connection counters of one host.
+struct HostConnectionStats {
+	// A point-in-time copy of connection counters of one host.
+	struct Snapshot {
+		string host;
+		// Number of completed transfers, including failed ones.
+		uint64_t requests = 0;
+		// Number of connections opened, a transfer could open more than one on redirects or retried connects.
+		uint64_t new_connections = 0;
+		// Number of transfers served by a cached connection, or an existing HTTP/2 connection. Transfers failing
+		// before getting a connection, i.e. on DNS resolution or connect, are neither new nor reused.
+		uint64_t reused_connections = 0;
+		// Number of TLS handshakes completed on new connections, and total time spent in them.
+		uint64_t tls_handshakes = 0;
+		uint64_t tls_handshake_us = 0;
+		// Number of transfers over HTTP/2, and those multiplexed as a stream of an existing connection.
+		uint64_t http2_requests = 0;
+		uint64_t http2_reused_streams = 0;
+	};
+
+	std::atomic<uint64_t> requests {0};
+	std::atomic<uint64_t> new_connections {0};
+	std::atomic<uint64_t> reused_connections {0};
+	std::atomic<uint64_t> tls_handshakes {0};
+	std::atomic<uint64_t> tls_handshake_us {0};
+	std::atomic<uint64_t> http2_requests {0};
+	std::atomic<uint64_t> http2_reused_streams {0};
+
+	// Record connection usage of the given finished transfer with the given result.
+	void Record(const CurlTransferInfo &info, CURLcode result);
+	// Take a snapshot of all counters, host is left empty.
+	Snapshot GetSnapshot() const;
+};
+
+using ConnectionStatsRegistry = HostRegistry<HostConnectionStats>;
+
+} // namespace duckdb
@@ -0,0 +1,25 @@
+// Redaction of credentials carried in request headers and URLs, before requests are exposed for debugging.
+
+#pragma once
+
+#include <cstddef>
+
+#include "duckdb/common/string.hpp"
+
+namespace duckdb {
+
+// Value kept in place of redacted credentials.
+constexpr const char *REDACTED_VALUE = "<redacted>";
+
+// Whether the header of the given name carries credentials, names are compared case-insensitively.
+bool IsCredentialHeader(const char *name, size_t name_len);
+
+// Find the first credential header name followed by a colon in the given data, i.e. "authorization: ..." within a
+// header dump. Return its offset and assign the length of the name to [`name_len`], return -1 if there's none.
+ptrdiff_t FindCredentialHeader(const char *data, size_t size, size_t &name_len);
+
+// Get the given URL with values of credential query parameters redacted, i.e. signatures of presigned S3 URLs and
+// Azure SAS tokens; other parameters are kept as is.
+string RedactUrlCredentials(const string &url);
+
+} // namespace duckdb
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+#include "curl_request.hpp"
+#include "duckdb/common/http_util.hpp"
+#include "duckdb/common/queue.hpp"
+#include "duckdb/common/unique_ptr.hpp"
+
+namespace duckdb {
+
+// A thread-safe queue which collects responses of asynchronously submitted requests, so a few threads are able to
+// drive a large number of concurrent requests.
+class CurlCompletionQueue {
+public:
+	struct Completion {
+		// Tag specified at request submission, used to identify the request.
+		uint64_t tag = 0;
+		unique_ptr<HTTPResponse> response;
+	};
+
+	CurlCompletionQueue() = default;
+
+	// Disable copy / move constructor / assignment.
+	CurlCompletionQueue(const CurlCompletionQueue &) = delete;
+	CurlCompletionQueue &operator=(const CurlCompletionQueue &) = delete;
+
+	// Get a completion callback, which pushes the response into the queue with the given tag.
+	// The queue should outlive all requests it's attached to.
+	CurlCompletionCallback CreateCallback(uint64_t tag);
+
+	// Push a completed response into the queue.
+	void Push(uint64_t tag, unique_ptr<HTTPResponse> response);
+	// Pop a completed response without blocking, return whether there's one.
+	bool TryPop(Completion &completion);
+	// Block until a completed response is available.
+	Completion Pop();
+	// Block until a completed response is available or timeout, return whether there's one.
+	bool PopWithTimeout(Completion &completion, std::chrono::milliseconds timeout);
+
+private:
+	std::mutex mu;
+	std::condition_variable cv;
+	queue<Completion> completions;
+};
+
+} // namespace duckdb
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <curl/curl.h>
+#include <mutex>
+
+#include "duckdb/common/unique_ptr.hpp"
+#include "duckdb/common/vector.hpp"
+#include "httpfs_curl_client.hpp"
+
+namespace duckdb {
+
+// A pool of pre-configured easy curl handles, so concurrent requests on one client each take their own handle.
+// Per-client options (i.e. TLS, proxy, timeout) are applied once to the template handle, and pooled handles are
+// duplicated from it with `curl_easy_duphandle`.
+class CurlHandlePool {
+public:
+	// RAII wrapper, which returns the easy handle to the pool on destruction.
+	class PooledHandle {
+	public:
+		PooledHandle(CurlHandlePool &pool_p, CURL *easy_curl_p);
+		~PooledHandle();
+
+		// Disable copy / move constructor / assignment.
+		PooledHandle(const PooledHandle &) = delete;
+		PooledHandle &operator=(const PooledHandle &) = delete;
+
+		CURL *Get() const {
+			return easy_curl;
+		}
+
+	private:
+		CurlHandlePool &pool;
+		CURL *easy_curl = nullptr;
+	};
+
+	explicit CurlHandlePool(unique_ptr<CURLHandle> template_handle_p);
+	~CurlHandlePool();
+
+	// Disable copy / move constructor / assignment.
+	CurlHandlePool(const CurlHandlePool &) = delete;
+	CurlHandlePool &operator=(const CurlHandlePool &) = delete;
+
+	// Take an idle handle from the pool, or duplicate a new one from the template if none is idle.
+	unique_ptr<PooledHandle> Acquire();
+
+	// Get the number of idle handles.
+	idx_t GetIdleHandleCount();
+
+private:
+	// Return the given handle to the pool.
+	void Release(CURL *easy_curl);
+
+	// Only used for duplication, never used for requests.
+	unique_ptr<CURLHandle> template_handle;
+	// Used to protect [`idle_handles`].
+	std::mutex mu;
+	// Idle handles, whose number is bounded by the peak request concurrency on the client.
+	vector<CURL *> idle_handles;
+};
+
+} // namespace duckdb
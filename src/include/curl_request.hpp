@@ -1,8 +1,10 @@
 #pragma once
 
+#include <chrono>
 #include <cstdint>
 #include <curl/curl.h>
-#include <future>
+#include <exception>
+#include <functional>
 #include <vector>
 
 #include "duckdb/common/http_util.hpp"
@@ -12,6 +14,10 @@
 
 namespace duckdb {
 
+// Forward declaration.
+class CompletionSlot;
+class DebugEventRing;
+
 struct RequestInfo {
 	string url = "";
 	string body = "";
@@ -19,26 +25,105 @@ struct RequestInfo {
 	std::vector<HTTPHeaders> header_collection;
 };
 
+// Streams successful response body to the caller as it arrives, instead of buffering the whole body.
+// Handlers are invoked in the eventloop thread; the stream is owned by the caller, which keeps it alive until request
+// completion.
+struct CurlBodyStream {
+	http_response_handler_t response_handler;
+	http_content_handler_t content_handler;
+	// Whether the response handler has been invoked for the streamed response.
+	bool response_handled = false;
+	// Whether content handler still accepts content.
+	bool accept_content = true;
+	// Error response body is buffered instead, and handled in the caller thread.
+	bool buffer_body = false;
+	// Number of body bytes received via the stream.
+	idx_t bytes_streamed = 0;
+	// Exception thrown by handlers, which should be rethrown in the caller thread.
+	std::exception_ptr exception;
+};
+
+// Invoked in the eventloop thread once the request completes, so it should be lightweight and never block.
+using CurlCompletionCallback = std::function<void(unique_ptr<HTTPResponse> response)>;
+
 struct CurlRequest {
 	unique_ptr<RequestInfo> info;
-	std::promise<unique_ptr<HTTPResponse>> response;
+	// Host of the URL, cached when the URL is set for eventloop routing and per-host stats.
+	string host;
+	CurlCompletionCallback completion_callback;
+	// Ownership doesn't lies in curl request; if set, response is delivered to the slot instead of the callback.
+	CompletionSlot *completion_slot = nullptr;
+	// Deadline for the whole request including queueing, after which it's cancelled by the eventloop.
+	std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+	// Assigned by the eventloop on submission, used to identify the request for cancellation.
+	uint64_t request_id = 0;
+	// Set by the eventloop on submission, used to measure time spent in the pending queue.
+	std::chrono::steady_clock::time_point submit_time;
+	// Set by the eventloop when the request is bound to the multi curl handle.
+	std::chrono::steady_clock::time_point add_time;
+	// Non-zero if the request is traced, see [`RequestTrace`].
+	uint64_t trace_id = 0;
+	// Thread which submits the request, only set for traced requests.
+	uint32_t caller_thread_id = 0;
 	// Ownership doesn't lies in curl request.
 	CURL *easy_curl = nullptr;
+	// Ownership doesn't lies in curl request; if unset, response body is buffered into [`info`].
+	CurlBodyStream *body_stream = nullptr;
+	// Ownership doesn't lies in curl request, which should be alive until request completion.
+	curl_slist *headers = nullptr;
+	// Value of the range header, cached when headers are set for diagnostics; empty if there's none.
+	string range;
+	// HTTP method set by the attribute setter, used for diagnostics.
+	const char *method = "GET";
+	// Ring of the eventloop handling the request, set when bound to the multi curl handle. Debug events are only
+	// reported by curl for requests sampled on construction.
+	DebugEventRing *debug_events = nullptr;
 
 	explicit CurlRequest(CURL *easy_curl_p);
 	~CurlRequest();
 
-	// Set URL.
+	// Set URL, and cache its host.
 	void SetUrl(string url);
-	// Set headers.
-	void SetHeaders(curl_slist *headers);
+	// Set headers, and cache the range header.
+	void SetHeaders(curl_slist *headers_p);
 	// Set curl attributes for GET requests.
 	void SetGetAttrs();
 	// Set curl attributes for HEAD requests.
 	void SetHeadAttrs();
+	// Set curl attributes for PUT requests, [`buffer`] should be alive until request completion.
+	void SetPutAttrs(const_data_ptr_t buffer, idx_t buffer_len);
+	// Set curl attributes for POST requests, [`buffer`] should be alive until request completion.
+	void SetPostAttrs(const_data_ptr_t buffer, idx_t buffer_len);
+	// Set curl attributes for DELETE requests.
+	void SetDeleteAttrs();
+	// Stream response body to the given stream.
+	void SetBodyStream(CurlBodyStream &stream);
+	// Set the callback to invoke on request completion.
+	void SetCompletionCallback(CurlCompletionCallback callback);
+	// Set the slot to deliver response to on request completion, used by blocking requests.
+	void SetCompletionSlot(CompletionSlot &slot);
+	// Set deadline for the request, which fails with a request error once it passes.
+	void SetDeadline(std::chrono::steady_clock::time_point deadline_p);
+	// Whether a deadline has been set.
+	bool HasDeadline() const;
+	// Whether a completion callback or slot has been set.
+	bool HasCompletion() const;
+
+	// Fill in url, reason and headers for the given response, based on request info.
+	void PopulateResponse(HTTPResponse &response) const;
+	// Build the response of the finished transfer with the given result, [`info`] should have the response code
+	// filled in. Response body is moved out of [`info`].
+	unique_ptr<HTTPResponse> BuildResponse(CURLcode result);
 
 	static size_t WriteHeader(void *contents, size_t size, size_t nmemb, void *userp);
 	static size_t WriteBody(void *contents, size_t size, size_t nmemb, void *userp);
+
+private:
+	// Forward the body chunk to [`body_stream`], return the number of bytes consumed.
+	size_t StreamBody(const_data_ptr_t data, size_t data_len);
 };
 
+// Get value of the range header in the given header list, return empty string if there's none.
+string GetRangeHeader(const curl_slist *headers);
+
 } // namespace duckdb
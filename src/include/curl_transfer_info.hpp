@@ -0,0 +1,33 @@
+// Info of a finished curl transfer, read once on completion and shared by everything the eventloop records for it.
+
+#pragma once
+
+#include <cstdint>
+#include <curl/curl.h>
+
+namespace duckdb {
+
+struct CurlTransferInfo {
+	// All timestamps are in microseconds since the start of the transfer, zero if the phase is never reached.
+	curl_off_t namelookup_us = 0;
+	curl_off_t connect_us = 0;
+	curl_off_t appconnect_us = 0;
+	curl_off_t starttransfer_us = 0;
+	curl_off_t total_us = 0;
+	// Body bytes received and sent.
+	curl_off_t bytes_received = 0;
+	curl_off_t bytes_sent = 0;
+	// Number of new connections opened by the transfer.
+	long new_connects = 0;
+	// Number of redirects followed.
+	long redirect_count = 0;
+	// HTTP version used by the transfer, `CURL_HTTP_VERSION_NONE` if no response is received.
+	long http_version = CURL_HTTP_VERSION_NONE;
+	// Connection used by the transfer, -1 if unknown.
+	int64_t connection_id = -1;
+
+	// Read info of the given finished transfer.
+	static CurlTransferInfo Read(CURL *easy_curl);
+};
+
+} // namespace duckdb
@@ -0,0 +1,76 @@
+// Collector of curl debug events, which replaces verbose logging to stderr for production use.
+//
+// Curl reports debug events via `CURLOPT_DEBUGFUNCTION` on the eventloop thread, each eventloop appends them as
+// fixed-size binary records into its own ring without locking; readers on other threads copy the latest records and
+// skip those being overwritten. Only informational text and headers are kept, body and TLS data are never recorded.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <curl/curl.h>
+
+#include "duckdb/common/typedefs.hpp"
+#include "duckdb/common/vector.hpp"
+#include "seqlock_ring.hpp"
+
+namespace duckdb {
+
+struct DebugEvent {
+	enum class Type : uint8_t {
+		// Informational text from curl, i.e. connection and TLS handshake progress. Values of credential headers listed
+		// in text are redacted.
+		TEXT,
+		// A response header line.
+		HEADER_IN,
+		// Request line of an outgoing request without its query string, other request headers are dropped since they
+		// carry credentials.
+		HEADER_OUT,
+	};
+
+	// Max length of data kept in an event, longer data is truncated.
+	static constexpr idx_t MAX_DATA_LEN = 96;
+
+	// Wall clock time in microseconds since epoch.
+	int64_t timestamp_us = 0;
+	// Request the event belongs to, see [`CurlRequest::request_id`].
+	uint64_t request_id = 0;
+	// Eventloop which records the event, only set in snapshots.
+	uint32_t event_loop_idx = 0;
+	// Size of the original data before truncation.
+	uint32_t size = 0;
+	Type type = Type::TEXT;
+	uint8_t data_len = 0;
+	std::array<char, MAX_DATA_LEN> data {};
+};
+
+// Get the name of the given event type.
+const char *GetDebugEventTypeName(DebugEvent::Type type);
+
+class DebugEventRing {
+public:
+	// Number of events kept per eventloop.
+	static constexpr idx_t CAPACITY = 1 << 12;
+
+	DebugEventRing() = default;
+
+	// Disable copy / move constructor / assignment.
+	DebugEventRing(const DebugEventRing &) = delete;
+	DebugEventRing &operator=(const DebugEventRing &) = delete;
+
+	// Record the given curl debug event of the given request, events of types not kept are ignored.
+	// Only called from the eventloop thread.
+	void Append(curl_infotype curl_type, const char *data, size_t size, uint64_t request_id);
+
+	// Copy events still in the ring, oldest first. Could be called from any thread.
+	vector<DebugEvent> Snapshot() const;
+
+	// Callback for `CURLOPT_DEBUGFUNCTION`, whose user data is the request being debugged.
+	static int DebugCallback(CURL *easy_curl, curl_infotype curl_type, char *data, size_t size, void *userp);
+
+private:
+	// Slots are allocated on the first event, so eventloops which never collect events don't pay for the ring.
+	SeqlockRing<DebugEvent, CAPACITY> ring;
+};
+
+} // namespace duckdb
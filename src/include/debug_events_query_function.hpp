@@ -0,0 +1,12 @@
+// Function which gets curl debug events recorded by eventloops.
+
+#pragma once
+
+#include "duckdb/function/table_function.hpp"
+
+namespace duckdb {
+
+// Get the table function to get the most recent curl debug events of sampled requests, most recent first.
+TableFunction GetDebugEventsFunc();
+
+} // namespace duckdb
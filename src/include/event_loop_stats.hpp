@@ -0,0 +1,70 @@
+// Health metrics of an eventloop, which tell whether the eventloop thread itself is the bottleneck rather than the
+// network.
+//
+// Counters are only written by the eventloop thread, so they're updated with plain load and store instead of atomic
+// read-modify-write; readers on other threads get a slightly stale but consistent view of each counter.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "extension_config.hpp"
+#include "latency_histogram.hpp"
+
+namespace duckdb {
+
+struct EventLoopStats {
+	// Time when the eventloop was created.
+	std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+
+	// Number of requests taken from the pending queue.
+	std::atomic<uint64_t> dequeued_requests {0};
+	// Time requests wait in the pending queue, from submission to being bound to the multi curl handle.
+	LatencyHistogram queue_wait;
+	// Number of requests bound to the multi curl handle.
+	std::atomic<uint64_t> ongoing_requests {0};
+	// Number of transfers still running as reported by curl.
+	std::atomic<uint64_t> still_running {0};
+	// Number of request deadlines tracked by the eventloop, which drops to 0 once all requests complete.
+	std::atomic<uint64_t> pending_deadlines {0};
+
+	// Number of returns from the polling engine wait, which include timeouts.
+	std::atomic<uint64_t> wakeups {0};
+	// Number of events returned by the polling engine.
+	std::atomic<uint64_t> events {0};
+
+	// Number of calls and total time spent inside `curl_multi_socket_action`.
+	std::atomic<uint64_t> socket_action_calls {0};
+	std::atomic<uint64_t> socket_action_ns {0};
+	// Number of calls and total time spent inside `CheckMulti`.
+	std::atomic<uint64_t> check_multi_calls {0};
+	std::atomic<uint64_t> check_multi_ns {0};
+
+	// Add to a counter, only called from the eventloop thread.
+	static void Add(std::atomic<uint64_t> &counter, uint64_t delta) {
+		counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+	}
+};
+
+// A point-in-time copy of an eventloop's stats.
+struct EventLoopStatsSnapshot {
+	idx_t event_loop_idx = 0;
+	EventLoopBackend backend = EventLoopBackend::EPOLL;
+	uint64_t uptime_ns = 0;
+	// Requests submitted but not yet taken by the eventloop.
+	uint64_t pending_requests = 0;
+	LatencyHistogram::Snapshot queue_wait;
+	uint64_t ongoing_requests = 0;
+	uint64_t still_running = 0;
+	uint64_t pending_deadlines = 0;
+	uint64_t wakeups = 0;
+	uint64_t events = 0;
+	uint64_t socket_action_calls = 0;
+	uint64_t socket_action_ns = 0;
+	uint64_t check_multi_calls = 0;
+	uint64_t check_multi_ns = 0;
+};
+
+} // namespace duckdb
@@ -0,0 +1,12 @@
+// Function which gets eventloop health metrics.
+
+#pragma once
+
+#include "duckdb/function/table_function.hpp"
+
+namespace duckdb {
+
+// Get the table function to get health metrics of each eventloop.
+TableFunction GetEventLoopStatsFunc();
+
+} // namespace duckdb
@@ -3,14 +3,58 @@
 #pragma once
 
 #include <atomic>
+#include <cstdint>
 
 namespace duckdb {
 
+// How requests are dispatched to eventloops.
+enum class EventLoopRouting : uint8_t {
+	// Spread requests over all eventloops evenly.
+	ROUND_ROBIN,
+	// Requests to the same host always go to the same eventloop, so they share one connection pool.
+	HOST,
+};
+
+// Polling engine which drives eventloops.
+enum class EventLoopBackend : uint8_t {
+	// epoll on linux, kqueue on macOS.
+	EPOLL,
+	// io_uring, only supported on linux.
+	IO_URING,
+};
+
+// Latency of responses replayed from an HTTP archive.
+enum class ReplayLatency : uint8_t {
+	// Each response is delayed by the duration of its recorded request.
+	RECORDED,
+	// Responses are served right away.
+	NONE,
+};
+
 //===--------------------------------------------------------------------===//
 // Default configuration
 //===--------------------------------------------------------------------===//
 
 inline constexpr bool DEFAULT_CURL_VERBOSE_LOGGING = false;
+// Eventloop count 0 means it's derived from available CPU core number.
+inline constexpr uint64_t DEFAULT_EVENT_LOOP_COUNT = 0;
+// Connection limits are applied per eventloop, so host routing keeps them per host.
+inline constexpr EventLoopRouting DEFAULT_EVENT_LOOP_ROUTING = EventLoopRouting::HOST;
+inline constexpr bool DEFAULT_ENABLE_STREAMING_READ = true;
+inline constexpr bool DEFAULT_ENABLE_EPOLL_EDGE_TRIGGERED = false;
+inline constexpr EventLoopBackend DEFAULT_EVENT_LOOP_BACKEND = EventLoopBackend::EPOLL;
+// Request deadline 0 means requests have no deadline.
+inline constexpr uint64_t DEFAULT_REQUEST_DEADLINE_MS = 0;
+// Connection limits of value 0 mean no limit, or curl's own default for max connects.
+inline constexpr uint64_t DEFAULT_MAX_CONNECTIONS_PER_HOST = 8;
+inline constexpr uint64_t DEFAULT_MAX_TOTAL_CONNECTIONS = 0;
+inline constexpr uint64_t DEFAULT_MAX_CONNECTS = 0;
+inline constexpr uint64_t DEFAULT_MAX_CONCURRENT_STREAMS = 100;
+inline constexpr bool DEFAULT_ENABLE_REQUEST_TRACE = false;
+inline constexpr bool DEFAULT_ENABLE_DEBUG_EVENTS = false;
+inline constexpr double DEFAULT_DEBUG_EVENTS_SAMPLE_RATE = 1.0;
+inline constexpr uint64_t DEFAULT_SLOW_REQUEST_THRESHOLD_MS = 0;
+inline constexpr ReplayLatency DEFAULT_REPLAY_LATENCY = ReplayLatency::RECORDED;
 
 //===--------------------------------------------------------------------===//
 // Global configuration
@@ -19,4 +63,51 @@ inline constexpr bool DEFAULT_CURL_VERBOSE_LOGGING = false;
 // Whether to enable verbose logging for curl-based http util.
 inline std::atomic<bool> ENABLE_CURL_VERBOSE_LOGGING {DEFAULT_CURL_VERBOSE_LOGGING};
 
+// Number of eventloops used by multi-curl based http util.
+inline std::atomic<uint64_t> EVENT_LOOP_COUNT {DEFAULT_EVENT_LOOP_COUNT};
+
+// How requests are dispatched to eventloops.
+inline std::atomic<EventLoopRouting> EVENT_LOOP_ROUTING {DEFAULT_EVENT_LOOP_ROUTING};
+
+// Whether to stream GET response body to the caller as it arrives, instead of buffering the whole response.
+inline std::atomic<bool> ENABLE_STREAMING_READ {DEFAULT_ENABLE_STREAMING_READ};
+
+// Whether to register sockets to epoll in edge-triggered mode, where a socket is only reported when it becomes ready
+// rather than for as long as it stays ready. Takes effect for sockets on their next registration update.
+inline std::atomic<bool> ENABLE_EPOLL_EDGE_TRIGGERED {DEFAULT_ENABLE_EPOLL_EDGE_TRIGGERED};
+
+// Polling engine for eventloops, which only takes effect for eventloops created afterwards.
+inline std::atomic<EventLoopBackend> EVENT_LOOP_BACKEND {DEFAULT_EVENT_LOOP_BACKEND};
+
+// Deadline in milliseconds for each request issued by multi-curl based http util, which covers queueing and transfer.
+inline std::atomic<uint64_t> REQUEST_DEADLINE_MS {DEFAULT_REQUEST_DEADLINE_MS};
+
+// Max number of connections to a single host per eventloop, requests beyond the limit are queued by curl.
+inline std::atomic<uint64_t> MAX_CONNECTIONS_PER_HOST {DEFAULT_MAX_CONNECTIONS_PER_HOST};
+
+// Max number of connections per eventloop across all hosts.
+inline std::atomic<uint64_t> MAX_TOTAL_CONNECTIONS {DEFAULT_MAX_TOTAL_CONNECTIONS};
+
+// Max number of idle connections kept alive in the connection cache of each eventloop.
+inline std::atomic<uint64_t> MAX_CONNECTS {DEFAULT_MAX_CONNECTS};
+
+// Max number of concurrent streams on a single HTTP/2 connection.
+inline std::atomic<uint64_t> MAX_CONCURRENT_STREAMS {DEFAULT_MAX_CONCURRENT_STREAMS};
+
+// Whether to record timeline of requests for trace export, which only takes effect for requests submitted afterwards.
+inline std::atomic<bool> ENABLE_REQUEST_TRACE {DEFAULT_ENABLE_REQUEST_TRACE};
+
+// Whether to collect curl debug events into in-memory rings, which only takes effect for requests created afterwards.
+inline std::atomic<bool> ENABLE_DEBUG_EVENTS {DEFAULT_ENABLE_DEBUG_EVENTS};
+
+// Fraction of requests whose debug events are collected, within [0, 1].
+inline std::atomic<double> DEBUG_EVENTS_SAMPLE_RATE {DEFAULT_DEBUG_EVENTS_SAMPLE_RATE};
+
+// Requests taking longer than the threshold from submission to completion are recorded into the slow request log,
+// 0 means disabled.
+inline std::atomic<uint64_t> SLOW_REQUEST_THRESHOLD_MS {DEFAULT_SLOW_REQUEST_THRESHOLD_MS};
+
+// Latency of responses replayed from an HTTP archive.
+inline std::atomic<ReplayLatency> REPLAY_LATENCY {DEFAULT_REPLAY_LATENCY};
+
 } // namespace duckdb
@@ -0,0 +1,87 @@
+// A process-wide registry of stats kept per host, i.e. latency histograms and connection counters of requests to each
+// host.
+//
+// Stats are created once per host and never destroyed, so eventloops cache references to them in a [`Cache`] and
+// recording only involves atomic operations. [`T`] should be default constructible, and provide a `Snapshot` type with
+// a `host` field, which is filled by the registry, and a `Snapshot GetSnapshot() const` method.
+
+#pragma once
+
+#include <algorithm>
+#include <mutex>
+
+#include "duckdb/common/helper.hpp"
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/unique_ptr.hpp"
+#include "duckdb/common/unordered_map.hpp"
+#include "duckdb/common/vector.hpp"
+
+namespace duckdb {
+
+template <typename T>
+class HostRegistry {
+public:
+	using Snapshot = typename T::Snapshot;
+
+	// Stats of hosts looked up by one eventloop, which avoids registry lookup under lock. It's not thread-safe.
+	class Cache {
+	public:
+		// Get stats for the given host, which are taken from the registry on first access.
+		T &Get(const string &host) {
+			auto iter = host_stats.find(host);
+			if (iter != host_stats.end()) {
+				return *iter->second;
+			}
+			auto &stats = HostRegistry::GetInstance().GetOrCreate(host);
+			host_stats.emplace(host, &stats);
+			return stats;
+		}
+
+	private:
+		unordered_map<string, T *> host_stats;
+	};
+
+	static HostRegistry &GetInstance() {
+		static auto *registry = new HostRegistry();
+		return *registry;
+	}
+
+	// Disable copy / move constructor / assignment.
+	HostRegistry(const HostRegistry &) = delete;
+	HostRegistry &operator=(const HostRegistry &) = delete;
+
+	// Get stats for the given host, create if it doesn't exist. The returned reference stays valid forever.
+	T &GetOrCreate(const string &host) {
+		const std::lock_guard<std::mutex> lck(mu);
+		auto &stats = host_stats[host];
+		if (stats == nullptr) {
+			stats = make_uniq<T>();
+		}
+		return *stats;
+	}
+
+	// Take snapshots for all hosts, sorted by host.
+	vector<Snapshot> GetSnapshots() {
+		vector<Snapshot> snapshots;
+		{
+			const std::lock_guard<std::mutex> lck(mu);
+			snapshots.reserve(host_stats.size());
+			for (const auto &cur_host_stats : host_stats) {
+				auto cur_snapshot = cur_host_stats.second->GetSnapshot();
+				cur_snapshot.host = cur_host_stats.first;
+				snapshots.emplace_back(std::move(cur_snapshot));
+			}
+		}
+		std::sort(snapshots.begin(), snapshots.end(),
+		          [](const Snapshot &lhs, const Snapshot &rhs) { return lhs.host < rhs.host; });
+		return snapshots;
+	}
+
+private:
+	HostRegistry() = default;
+
+	std::mutex mu;
+	unordered_map<string, unique_ptr<T>> host_stats;
+};
+
+} // namespace duckdb
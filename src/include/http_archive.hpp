@@ -0,0 +1,58 @@
+// Archive of recorded HTTP requests and responses, used to replay remote scans without network access.
+//
+// The archive is a flat binary file: an 8-byte magic followed by length-prefixed entries, where integers are unsigned
+// LEB128 varints and strings are varint-length-prefixed bytes. Entries are written to the file one at a time, so an
+// archive cut short by a crash is still readable up to its last complete entry.
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/typedefs.hpp"
+#include "duckdb/common/unique_ptr.hpp"
+#include "duckdb/common/vector.hpp"
+
+namespace duckdb {
+
+struct HttpArchiveEntry {
+	string method;
+	string url;
+	// Request headers in order, credentials are redacted on recording.
+	vector<std::pair<string, string>> request_headers;
+	uint16_t status_code = 0;
+	// Set if the request failed without a response.
+	string request_error;
+	vector<std::pair<string, string>> response_headers;
+	string body;
+	// From submission to completion in microseconds.
+	uint64_t duration_us = 0;
+
+	// Get value of the range request header, return empty string if there's none.
+	string GetRange() const;
+};
+
+class HttpArchiveWriter {
+public:
+	// Create the archive at the given path of the given file system, which truncates the existing file; throw
+	// IOException on failure.
+	HttpArchiveWriter(FileSystem &fs, const string &path);
+
+	// Disable copy / move constructor / assignment.
+	HttpArchiveWriter(const HttpArchiveWriter &) = delete;
+	HttpArchiveWriter &operator=(const HttpArchiveWriter &) = delete;
+
+	// Append the given entry and write it to the file; throw IOException on failure.
+	void Append(const HttpArchiveEntry &entry);
+
+private:
+	unique_ptr<FileHandle> handle;
+};
+
+// Read all complete entries of the archive at the given path of the given file system, throw IOException if it's
+// missing or not an archive.
+vector<HttpArchiveEntry> ReadHttpArchive(FileSystem &fs, const string &path);
+
+} // namespace duckdb
@@ -0,0 +1,70 @@
+// Process-wide counters of requests issued by multi-curl based http util, exported by the metrics exporter.
+//
+// Counters are plain atomics in fixed-size arrays indexed by method and status code, so recording never allocates or
+// locks on the request path.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "curl_transfer_info.hpp"
+#include "duckdb/common/typedefs.hpp"
+#include "latency_histogram.hpp"
+
+namespace duckdb {
+
+enum class HttpMethod : uint8_t {
+	GET,
+	HEAD,
+	PUT,
+	POST,
+	DELETE,
+};
+inline constexpr idx_t HTTP_METHOD_COUNT = 5;
+
+const char *GetHttpMethodName(HttpMethod method);
+// Get method by its name as set on curl requests, unknown ones are treated as GET.
+HttpMethod GetHttpMethod(const char *method_name);
+
+class HttpMetrics {
+public:
+	// Status codes are counted in slots indexed by code, slot 0 counts requests failed without a valid status code.
+	static constexpr idx_t STATUS_CODE_SLOTS = 600;
+
+	static HttpMetrics &GetInstance();
+
+	// Disable copy / move constructor / assignment.
+	HttpMetrics(const HttpMetrics &) = delete;
+	HttpMetrics &operator=(const HttpMetrics &) = delete;
+
+	// Record a completed request, status code 0 means it fails with a request error, or gets cancelled.
+	void RecordRequest(HttpMethod method, uint16_t status_code);
+	// Record bytes and connections used by the given finished transfer with the given result.
+	void RecordTransfer(HttpMethod method, const CurlTransferInfo &info, CURLcode result);
+	// Record how long a caller blocks on a request.
+	void RecordWait(int64_t wait_us);
+
+	// Get the number of completed requests with the given method and status code slot.
+	uint64_t GetRequestCount(HttpMethod method, idx_t status_code_slot) const;
+	uint64_t GetBytesReceived(HttpMethod method) const;
+	uint64_t GetBytesSent(HttpMethod method) const;
+	// Number of new connections opened, and number of transfers served by an existing connection.
+	uint64_t GetConnectionsOpened() const;
+	uint64_t GetConnectionsReused() const;
+	LatencyHistogram::Snapshot GetWaitSnapshot() const;
+
+private:
+	HttpMetrics() = default;
+
+	std::array<std::array<std::atomic<uint64_t>, STATUS_CODE_SLOTS>, HTTP_METHOD_COUNT> request_counts {};
+	std::array<std::atomic<uint64_t>, HTTP_METHOD_COUNT> bytes_received {};
+	std::array<std::atomic<uint64_t>, HTTP_METHOD_COUNT> bytes_sent {};
+	std::atomic<uint64_t> connections_opened {0};
+	std::atomic<uint64_t> connections_reused {0};
+	// Time callers block on requests, from submission to wakeup.
+	LatencyHistogram request_wait;
+};
+
+} // namespace duckdb
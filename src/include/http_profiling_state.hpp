@@ -0,0 +1,41 @@
+// Per-query HTTP stats of multi-curl based http util, reported by `EXPLAIN ANALYZE` next to the operator timings, so it
+// tells how much of a scan is spent blocked on the network rather than decoding.
+//
+// Stats are kept per client context, and reset at the beginning of every query.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+#include "duckdb/main/client_context_state.hpp"
+
+namespace duckdb {
+
+class HTTPProfilingState : public ClientContextState {
+public:
+	// Key in the client context registered state.
+	static constexpr const char *STATE_KEY = "curl_httpfs_http_profiling";
+
+	void QueryBegin(ClientContext &context) override;
+	void WriteProfilingInformation(std::ostream &ss) override;
+
+	// Record a completed request, which blocks the caller thread for the given duration.
+	void RecordRequest(std::chrono::nanoseconds wait_time, uint64_t bytes_received, uint64_t bytes_sent);
+
+private:
+	void Reset();
+
+	std::atomic<uint64_t> request_count {0};
+	// Summed over all caller threads, which could exceed query wall time when scans run in parallel.
+	std::atomic<uint64_t> total_wait_ns {0};
+	std::atomic<uint64_t> max_wait_ns {0};
+	std::atomic<uint64_t> total_bytes_received {0};
+	std::atomic<uint64_t> total_bytes_sent {0};
+	// Steady clock timestamp in nanoseconds when the current query begins.
+	std::atomic<int64_t> query_begin_ns {0};
+};
+
+} // namespace duckdb
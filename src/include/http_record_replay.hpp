@@ -0,0 +1,97 @@
+// Record and replay of requests issued by multi-curl based http util, so remote scans could be profiled and benchmarked
+// against real traces without network access, and compared deterministically across changes.
+//
+// When recording, every request and its response is appended to an HTTP archive, see [`HttpArchiveWriter`]; response
+// bodies are buffered rather than streamed, so they could be recorded as a whole; credentials in request headers and
+// URL query parameters are redacted. When replaying, requests never reach the network: each is served the recorded
+// response of the same method, redacted URL and range, with either the recorded latency or none (see
+// [`REPLAY_LATENCY`]). Identical requests get their recorded responses in turn.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <curl/curl.h>
+#include <mutex>
+
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/http_util.hpp"
+#include "duckdb/common/shared_ptr.hpp"
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/unique_ptr.hpp"
+#include "duckdb/common/unordered_map.hpp"
+#include "duckdb/common/vector.hpp"
+#include "http_archive.hpp"
+#include "multi_curl_manager.hpp"
+
+namespace duckdb {
+
+class HttpRecorder {
+public:
+	static HttpRecorder &GetInstance();
+
+	// Disable copy / move constructor / assignment.
+	HttpRecorder(const HttpRecorder &) = delete;
+	HttpRecorder &operator=(const HttpRecorder &) = delete;
+
+	// Start recording into a new archive at the given path of the given file system, or stop recording if the path is
+	// empty.
+	void SetPath(FileSystem &fs, const string &path);
+	bool IsRecording() const {
+		return recording.load(std::memory_order_relaxed);
+	}
+
+	// Record the given request and its response. Credentials in request headers and URL are redacted.
+	void Record(const char *method, const string &url, const curl_slist *headers, const HTTPResponse &response,
+	            std::chrono::nanoseconds duration);
+
+private:
+	HttpRecorder() = default;
+
+	std::atomic<bool> recording {false};
+	// Protects the archive writer.
+	std::mutex mu;
+	unique_ptr<HttpArchiveWriter> writer;
+};
+
+class HttpReplayer {
+public:
+	static HttpReplayer &GetInstance();
+
+	// Disable copy / move constructor / assignment.
+	HttpReplayer(const HttpReplayer &) = delete;
+	HttpReplayer &operator=(const HttpReplayer &) = delete;
+
+	// Start replaying the archive at the given path of the given file system, or stop replaying if the path is empty.
+	void SetPath(FileSystem &fs, const string &path);
+	bool IsReplaying() const {
+		return replaying.load(std::memory_order_relaxed);
+	}
+
+	// Serve the given request from the archive, which blocks for the recorded latency if configured, until the given
+	// check reports interruption. Identical requests get their recorded responses in turn, and start over once all of
+	// them are served. Requests never recorded fail with a request error.
+	unique_ptr<HTTPResponse> Replay(const char *method, const string &url, const curl_slist *headers,
+	                                const CurlInterruptCheck &interrupt_check = nullptr);
+
+private:
+	// Recorded responses of identical requests.
+	struct RecordedResponses {
+		vector<shared_ptr<const HttpArchiveEntry>> entries;
+		// Index of the entry to serve next.
+		idx_t next = 0;
+	};
+
+	HttpReplayer() = default;
+
+	// Get the next recorded response of the given request, return nullptr if there's none.
+	shared_ptr<const HttpArchiveEntry> GetNextEntry(const string &key);
+
+	std::atomic<bool> replaying {false};
+	// Protects recorded responses.
+	std::mutex mu;
+	// Keyed by method, redacted URL and range.
+	unordered_map<string, RecordedResponses> recorded_responses;
+};
+
+} // namespace duckdb
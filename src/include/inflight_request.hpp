@@ -0,0 +1,49 @@
+// Snapshot of a request in flight, used to find out which object or host a hanging query waits on.
+
+#pragma once
+
+#include <cstdint>
+
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/typedefs.hpp"
+
+namespace duckdb {
+
+// Progress of a request in flight, inferred from curl's transfer timings.
+enum class InflightRequestState : uint8_t {
+	// Not started by curl yet, i.e. waiting for a connection slot or DNS resolution.
+	QUEUED,
+	// Connection being established, including TLS handshake.
+	CONNECTING,
+	// Connection ready, request being sent or response being received.
+	TRANSFERRING,
+};
+
+// Get the name of the given state.
+inline const char *GetInflightRequestStateName(InflightRequestState state) {
+	switch (state) {
+	case InflightRequestState::QUEUED:
+		return "queued";
+	case InflightRequestState::CONNECTING:
+		return "connecting";
+	case InflightRequestState::TRANSFERRING:
+		return "transferring";
+	}
+	return "unknown";
+}
+
+struct InflightRequestSnapshot {
+	idx_t event_loop_idx = 0;
+	// Values of credential query parameters are redacted.
+	string url;
+	string method;
+	// Value of the range header, empty if the request has none.
+	string range;
+	InflightRequestState state = InflightRequestState::QUEUED;
+	// Response body bytes received so far.
+	uint64_t bytes_received = 0;
+	// Time since submission.
+	uint64_t elapsed_us = 0;
+};
+
+} // namespace duckdb
@@ -0,0 +1,12 @@
+// Function which gets requests in flight.
+
+#pragma once
+
+#include "duckdb/function/table_function.hpp"
+
+namespace duckdb {
+
+// Get the table function to get all requests in flight on eventloops.
+TableFunction GetInflightRequestsFunc();
+
+} // namespace duckdb
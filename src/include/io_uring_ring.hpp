@@ -0,0 +1,107 @@
+// A minimal io_uring wrapper built on raw syscalls, which only covers operations needed by the eventloop: poll
+// add/remove and read.
+//
+// Submissions are queued in the submission ring, and flushed together with the next wait in one `io_uring_enter`
+// call; wait timeout is passed via extended arguments, so no timer fd or timeout request is needed.
+
+#pragma once
+
+#ifdef __linux__
+
+#include <cstdint>
+#include <linux/io_uring.h>
+
+#include "duckdb/common/typedefs.hpp"
+#include "duckdb/common/unique_ptr.hpp"
+
+namespace duckdb {
+
+class IoUring {
+public:
+	// Create an io_uring instance with the given number of submission entries, return nullptr if io_uring is not
+	// supported by the kernel (i.e. old kernel, or disabled by seccomp).
+	static unique_ptr<IoUring> Create(uint32_t entries);
+	// Whether io_uring with all features required by the eventloop is supported.
+	static bool IsSupported();
+
+	~IoUring();
+
+	// Disable copy / move constructor / assignment.
+	IoUring(const IoUring &) = delete;
+	IoUring &operator=(const IoUring &) = delete;
+
+	// Queue a one-shot poll request on [`fd`] with [`poll_mask`] in `poll(2)` format.
+	void PrepPollAdd(int fd, uint32_t poll_mask, uint64_t user_data);
+	// Queue cancellation for the poll request tagged [`target_user_data`]; the cancelled poll completes with
+	// `-ECANCELED`.
+	void PrepPollRemove(uint64_t target_user_data, uint64_t user_data);
+	// Queue a read request.
+	void PrepRead(int fd, void *buffer, uint32_t len, uint64_t user_data);
+
+	// Submit all queued requests, and wait for at least one completion or until [`timeout_ns`] elapses; negative
+	// timeout means wait infinitely.
+	void SubmitAndWait(int64_t timeout_ns);
+
+	// Invoke [`fn`] with user data and result for all available completions, return number of completions.
+	// [`fn`] is allowed to queue new requests.
+	template <typename Fn>
+	idx_t ConsumeCompletions(Fn &&fn);
+
+private:
+	IoUring() = default;
+
+	// Get a free submission entry, flush queued requests if the submission ring is full.
+	io_uring_sqe *GetSqe();
+	// Invoke `io_uring_enter` to submit queued requests, and optionally wait for completions.
+	void Enter(bool wait, int64_t timeout_ns);
+
+	int ring_fd = -1;
+
+	// Memory mapped rings, [`cq_ring_ptr`] equals [`sq_ring_ptr`] if kernel supports single mmap.
+	void *sq_ring_ptr = nullptr;
+	size_t sq_ring_size = 0;
+	void *cq_ring_ptr = nullptr;
+	size_t cq_ring_size = 0;
+	io_uring_sqe *sqes = nullptr;
+	size_t sqes_size = 0;
+
+	// Submission ring.
+	uint32_t *sq_head = nullptr;
+	uint32_t *sq_tail = nullptr;
+	uint32_t *sq_array = nullptr;
+	uint32_t sq_mask = 0;
+	uint32_t sq_entries = 0;
+	// Tail of entries prepared locally, which is published to the kernel on submission.
+	uint32_t sqe_tail = 0;
+
+	// Completion ring.
+	uint32_t *cq_head = nullptr;
+	uint32_t *cq_tail = nullptr;
+	io_uring_cqe *cqes = nullptr;
+	uint32_t cq_mask = 0;
+};
+
+template <typename Fn>
+idx_t IoUring::ConsumeCompletions(Fn &&fn) {
+	idx_t count = 0;
+	uint32_t head = __atomic_load_n(cq_head, __ATOMIC_RELAXED);
+	while (true) {
+		const uint32_t tail = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+		if (head == tail) {
+			break;
+		}
+		const io_uring_cqe &cqe = cqes[head & cq_mask];
+		const uint64_t user_data = cqe.user_data;
+		const int32_t res = cqe.res;
+		// Release the entry before invoking callback, which could lead to new completions.
+		++head;
+		__atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+		fn(user_data, res);
+		++count;
+	}
+	return count;
+}
+
+} // namespace duckdb
+
+#endif
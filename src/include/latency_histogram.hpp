@@ -0,0 +1,61 @@
+// A lock-free histogram of latencies in microseconds, which could be recorded from multiple threads concurrently.
+//
+// Buckets are log-linear: latencies below 16us are recorded exactly, larger ones fall into one of 16 linear
+// sub-buckets per power of two, so reported percentiles are within 1/16 of the actual value.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "duckdb/common/typedefs.hpp"
+
+namespace duckdb {
+
+class LatencyHistogram {
+public:
+	// Number of linear sub-buckets per power of two, in bits.
+	static constexpr idx_t SUB_BUCKET_BITS = 4;
+	static constexpr idx_t SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+	// Largest power of two tracked, latencies beyond are recorded in the last bucket.
+	static constexpr idx_t MAX_EXPONENT = 39;
+	static constexpr idx_t BUCKET_COUNT = SUB_BUCKET_COUNT + (MAX_EXPONENT - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+	// A point-in-time copy of the histogram.
+	struct Snapshot {
+		uint64_t count = 0;
+		uint64_t sum_us = 0;
+		uint64_t max_us = 0;
+		std::array<uint64_t, BUCKET_COUNT> buckets {};
+
+		// Get the mean latency, return 0 if there's no record.
+		double GetMean() const;
+		// Get the latency at the given percentile within [0, 1], return 0 if there's no record.
+		uint64_t GetPercentile(double percentile) const;
+	};
+
+	LatencyHistogram() = default;
+
+	// Disable copy / move constructor / assignment.
+	LatencyHistogram(const LatencyHistogram &) = delete;
+	LatencyHistogram &operator=(const LatencyHistogram &) = delete;
+
+	// Record the given latency, negative latency is recorded as 0.
+	void Record(int64_t latency_us);
+
+	// Take a snapshot of the histogram. Records happening concurrently might be partially reflected.
+	Snapshot GetSnapshot() const;
+
+	// Get the bucket index for the given latency.
+	static idx_t GetBucketIndex(uint64_t latency_us);
+	// Get the largest latency falling into the given bucket.
+	static uint64_t GetBucketUpperBound(idx_t bucket_idx);
+
+private:
+	std::atomic<uint64_t> sum_us {0};
+	std::atomic<uint64_t> max_us {0};
+	std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets {};
+};
+
+} // namespace duckdb
@@ -0,0 +1,53 @@
+// Prometheus metrics exporter, which serves metrics of multi-curl based http util in text exposition format from a
+// background thread, on a TCP port or a Unix socket.
+//
+// Metrics are collected on each scrape from process-wide counters, eventloop stats and latency registry, so the exporter
+// adds no cost to the request path. Scrapes are served one at a time, which is plenty for a local scraper.
+
+#pragma once
+
+#include <mutex>
+#include <thread>
+
+#include "duckdb/common/string.hpp"
+
+namespace duckdb {
+
+class MetricsExporter {
+public:
+	static MetricsExporter &GetInstance();
+
+	// Disable copy / move constructor / assignment.
+	MetricsExporter(const MetricsExporter &) = delete;
+	MetricsExporter &operator=(const MetricsExporter &) = delete;
+
+	// Serve metrics on the given endpoint, which is either `<host>:<port>` or `unix:<path>`, replacing the current one;
+	// empty endpoint stops serving. Throw if the endpoint is malformed or cannot be listened on.
+	void SetEndpoint(const string &endpoint);
+
+	// Get the address being listened on, with port 0 resolved to the bound port; return empty string if not serving.
+	string GetListenAddress();
+
+	// Render all metrics in Prometheus text exposition format.
+	static string RenderMetrics();
+
+private:
+	MetricsExporter() = default;
+
+	// Stop serving and release the endpoint, called with [`mu`] held.
+	void Stop();
+	// Accept and serve scrapes until the stop pipe turns readable.
+	static void Serve(int server_fd, int stop_fd);
+
+	// Protects all fields below.
+	std::mutex mu;
+	std::thread serve_thread;
+	int listen_fd = -1;
+	// Written to wake up and stop the serving thread.
+	int stop_pipe[2] = {-1, -1};
+	// Path of the Unix socket being listened on, removed on stop.
+	string unix_socket_path;
+	string listen_address;
+};
+
+} // namespace duckdb
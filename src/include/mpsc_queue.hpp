@@ -0,0 +1,118 @@
+// A lock-free multi-producer single-consumer queue.
+//
+// Producers push onto an atomic linked stack with CAS, the single consumer takes the whole stack with one atomic
+// exchange and reverses it to restore FIFO order. Push reports whether the queue was empty before, which allows
+// producers to coalesce wakeups: only the producer which makes the queue non-empty needs to notify the consumer.
+
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+#include "duckdb/common/vector.hpp"
+
+namespace duckdb {
+
+template <typename T>
+class MpscQueue {
+public:
+	MpscQueue() = default;
+	~MpscQueue();
+
+	// Disable copy / move constructor / assignment.
+	MpscQueue(const MpscQueue &) = delete;
+	MpscQueue &operator=(const MpscQueue &) = delete;
+
+	// Push the given value, return whether the queue was empty before the push.
+	// Could be called by multiple threads concurrently.
+	bool Push(T value);
+	// Push all the given values atomically, return whether the queue was empty before the push.
+	// Could be called by multiple threads concurrently.
+	bool PushBatch(vector<T> values);
+
+	// Pop all values in FIFO order and invoke [`fn`] on each of them.
+	// Should only be called by the single consumer.
+	template <typename Fn>
+	void ConsumeAll(Fn &&fn);
+
+	// Whether the queue is empty at the moment.
+	bool Empty() const;
+
+private:
+	struct Node {
+		T value;
+		Node *next = nullptr;
+	};
+
+	// Link [`first`] to [`last`] onto the stack, return whether the stack was empty before.
+	bool PushList(Node *first, Node *last);
+
+	std::atomic<Node *> head {nullptr};
+};
+
+template <typename T>
+MpscQueue<T>::~MpscQueue() {
+	ConsumeAll([](T) {});
+}
+
+template <typename T>
+bool MpscQueue<T>::Push(T value) {
+	auto *node = new Node {std::move(value), nullptr};
+	return PushList(node, node);
+}
+
+template <typename T>
+bool MpscQueue<T>::PushBatch(vector<T> values) {
+	if (values.empty()) {
+		return false;
+	}
+	// Link nodes in reverse order, since the stack is reversed by the consumer.
+	Node *first = nullptr;
+	Node *last = nullptr;
+	for (auto &cur_value : values) {
+		auto *node = new Node {std::move(cur_value), first};
+		if (last == nullptr) {
+			last = node;
+		}
+		first = node;
+	}
+	return PushList(first, last);
+}
+
+template <typename T>
+bool MpscQueue<T>::PushList(Node *first, Node *last) {
+	Node *old_head = head.load(std::memory_order_relaxed);
+	do {
+		last->next = old_head;
+	} while (!head.compare_exchange_weak(old_head, first, std::memory_order_release, std::memory_order_relaxed));
+	return old_head == nullptr;
+}
+
+template <typename T>
+template <typename Fn>
+void MpscQueue<T>::ConsumeAll(Fn &&fn) {
+	Node *node = head.exchange(nullptr, std::memory_order_acquire);
+
+	// Reverse the stack to get FIFO order.
+	Node *reversed = nullptr;
+	while (node != nullptr) {
+		Node *next = node->next;
+		node->next = reversed;
+		reversed = node;
+		node = next;
+	}
+
+	while (reversed != nullptr) {
+		Node *next = reversed->next;
+		fn(std::move(reversed->value));
+		delete reversed;
+		reversed = next;
+	}
+}
+
+template <typename T>
+bool MpscQueue<T>::Empty() const {
+	return head.load(std::memory_order_acquire) == nullptr;
+}
+
+} // namespace duckdb
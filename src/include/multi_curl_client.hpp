@@ -1,9 +1,13 @@
 #pragma once
 
+#include <chrono>
+
 #include "duckdb/common/http_util.hpp"
 #include "httpfs_client.hpp"
 #include "httpfs_curl_client.hpp"
 #include "http_state.hpp"
+#include "http_profiling_state.hpp"
+#include "curl_handle_pool.hpp"
 #include "curl_request.hpp"
 
 namespace duckdb {
@@ -21,14 +25,29 @@ public:
 	unique_ptr<HTTPResponse> Delete(DeleteRequestInfo &info) override;
 	unique_ptr<HTTPResponse> Post(PostRequestInfo &info) override;
 
-private:
-	CURLRequestHeaders TransformHeadersCurl(const HTTPHeaders &header_map, const HTTPParams &params);
-	void ResetRequestInfo();
-	unique_ptr<HTTPResponse> TransformResponseCurl(CURLcode res);
+	// Transform the given headers and extra headers of the params into curl headers.
+	static CURLRequestHeaders TransformHeadersCurl(const HTTPHeaders &header_map, const HTTPParams &params);
 
-	unique_ptr<CURLHandle> curl;
+	// Number of easy handles idle in the pool.
+	idx_t GetIdleHandleCount() const {
+		return curl_handle_pool->GetIdleHandleCount();
+	}
+
+private:
+	// Perform the given request and block until completion, throw if the query gets interrupted meanwhile.
+	// Blocked time and transferred bytes are recorded to the HTTP state and the query profiler. The request is recorded
+	// or replayed instead if configured, see [`HttpRecorder`] and [`HttpReplayer`].
+	unique_ptr<HTTPResponse> PerformRequest(unique_ptr<CurlRequest> req);
+	// Record stats of a completed request, which blocks the caller for the given time.
+	void RecordRequestStats(uint64_t bytes_received, uint64_t bytes_sent, std::chrono::nanoseconds wait_time);
+
+	// Each request takes its own easy handle from the pool, so concurrent requests on the client don't contend.
+	unique_ptr<CurlHandlePool> curl_handle_pool;
 	optional_ptr<HTTPState> state;
-	unique_ptr<RequestInfo> request_info;
+	// Client context of the query which issues requests, used to cancel requests on query interruption.
+	weak_ptr<ClientContext> client_context;
+	// Per-query stats of the client context, empty if the client isn't bound to one.
+	shared_ptr<HTTPProfilingState> profiling_state;
 
 	static void InitCurlGlobal();
 	static void DestroyCurlGlobal();
@@ -1,16 +1,30 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <curl/curl.h>
+#include <functional>
 #include <future>
 #include <mutex>
 #include <thread>
 
+#include "completion_slot.hpp"
+#include "connection_stats_registry.hpp"
+#include "debug_event_ring.hpp"
 #include "curl_request.hpp"
 #include "duckdb/common/helper.hpp"
 #include "duckdb/common/http_util.hpp"
-#include "duckdb/common/queue.hpp"
 #include "duckdb/common/unique_ptr.hpp"
 #include "duckdb/common/unordered_map.hpp"
+#include "duckdb/common/vector.hpp"
+#include "event_loop_stats.hpp"
+#include "extension_config.hpp"
+#include "inflight_request.hpp"
+#include "io_uring_ring.hpp"
+#include "mpsc_queue.hpp"
+#include "request_latency_registry.hpp"
+#include "timer_wheel.hpp"
 
 namespace duckdb {
 
@@ -19,6 +33,12 @@ struct GlobalInfo {
 	int epoll_fd = -1;
 	int timer_fd = -1;
 	int event_fd = -1;
+	// Set if the eventloop is driven by io_uring instead of epoll, in which case epoll fd and timer fd are not used.
+	unique_ptr<IoUring> io_uring;
+	// Buffer for io_uring reads on the eventfd.
+	uint64_t event_fd_counter = 0;
+	// Steady clock deadline of curl timeout in nanoseconds for io_uring, negative if there's no pending timeout.
+	int64_t timeout_deadline_ns = -1;
 #elif defined(__APPLE__)
 	int kq_fd = -1;
 	// Used for event notification.
@@ -29,34 +49,189 @@ struct GlobalInfo {
 	int still_running = 0;
 	// Only accessed in the background thread.
 	unordered_map<CURL *, unique_ptr<CurlRequest>> ongoing_requests;
+	// Maps request id to easy handle for ongoing requests, used for cancellation.
+	// Only accessed in the background thread.
+	unordered_map<uint64_t, CURL *> ongoing_request_ids;
+	// Deadlines of ongoing requests, keyed by request id; entries are removed once requests complete.
+	// Only accessed in the background thread.
+	TimerWheel deadlines;
+	// Ids of requests whose deadline has expired, which are terminated after the timer wheel is advanced.
+	// Only accessed in the background thread, kept to reuse its capacity.
+	vector<uint64_t> expired_request_ids;
+	// Latency histograms of hosts requested by the eventloop.
+	// Only accessed in the background thread.
+	RequestLatencyRegistry::Cache host_latencies;
+	// Connection counters of hosts requested by the eventloop.
+	// Only accessed in the background thread.
+	ConnectionStatsRegistry::Cache host_connection_stats;
+	// Health metrics of the eventloop, only written by the background thread.
+	EventLoopStats stats;
+	// Curl debug events of sampled requests, only written by the background thread.
+	DebugEventRing debug_events;
+	// Slots whose waiters have parked, which are woken up in one batch after all completed requests are processed.
+	// Only accessed in the background thread, kept to reuse its capacity.
+	vector<CompletionSlot *> slots_to_wake;
 };
 
-class MultiCurlManager {
+class CurlEventLoop;
+
+// Identifies a submitted request, used to cancel it.
+struct CurlRequestHandle {
+	CurlEventLoop *event_loop = nullptr;
+	uint64_t request_id = 0;
+};
+
+// Checked periodically while blocking on a request, return true to cancel the request.
+using CurlInterruptCheck = std::function<bool()>;
+
+// Interval to check interruption while blocking on a request.
+constexpr auto INTERRUPT_CHECK_INTERVAL = std::chrono::milliseconds(100);
+
+// Block until [`wait_for`] returns true, which waits for at most the given timeout each time; [`interrupt_check`] is
+// checked in between. Return false once interrupted, or true if the wait completes.
+bool WaitUnlessInterrupted(const std::function<bool(std::chrono::nanoseconds)> &wait_for,
+                           const CurlInterruptCheck &interrupt_check);
+
+// A single eventloop, which owns a multi curl handle, its polling engine and the background thread driving it.
+class CurlEventLoop {
 public:
-	static MultiCurlManager &GetInstance();
-	~MultiCurlManager() = default;
+	// [`backend`] falls back to epoll if io_uring is not supported.
+	explicit CurlEventLoop(EventLoopBackend backend = EventLoopBackend::EPOLL);
+	~CurlEventLoop() = default;
 
 	// Disable copy / move constructor / assignment.
-	MultiCurlManager(const MultiCurlManager &) = delete;
-	MultiCurlManager &operator=(const MultiCurlManager &) = delete;
+	CurlEventLoop(const CurlEventLoop &) = delete;
+	CurlEventLoop &operator=(const CurlEventLoop &) = delete;
 
-	// Handle the given request, and block wait until its completion.
-	unique_ptr<HTTPResponse> HandleRequest(unique_ptr<CurlRequest> request);
+	// Enqueue the given request and wakeup the eventloop, the response is delivered via request's completion callback.
+	CurlRequestHandle SubmitRequest(unique_ptr<CurlRequest> request);
+	// Enqueue all given requests and wakeup the eventloop once, return handles in the order of requests.
+	vector<CurlRequestHandle> SubmitRequests(vector<unique_ptr<CurlRequest>> requests);
+
+	// Cancel the given request without blocking. If it's still ongoing, its transfer is aborted and it completes with a
+	// request error; otherwise it's a no-op.
+	void CancelRequest(uint64_t request_id);
+
+	// Run the given task on the eventloop thread without blocking, tasks are run in submission order.
+	void PostTask(std::function<void()> task);
+
+	// Apply connection limits from global configuration to the multi curl handle, which happens on the eventloop
+	// thread asynchronously; ongoing transfers are not affected.
+	void RefreshConnectionLimits();
+
+	// Get the polling engine actually used by the eventloop.
+	EventLoopBackend GetBackend() const;
+
+	// Take a snapshot of the eventloop's health metrics.
+	EventLoopStatsSnapshot GetStats() const;
+
+	// Copy curl debug events recorded by the eventloop, oldest first.
+	vector<DebugEvent> GetDebugEvents() const;
+
+	// Take snapshots of all requests in flight on the eventloop thread without blocking, including those still in the
+	// pending queue. The returned future never gets ready if the eventloop is blocked.
+	std::future<vector<InflightRequestSnapshot>> SnapshotInflightRequests();
 
 private:
-	MultiCurlManager();
+	// Wakeup the eventloop to process pending requests.
+	void Wakeup();
+	// Handle wakeup, which processes pending requests, cancellations and tasks.
+	void HandleWakeup();
 
 	// Eventloop implementation.
 	void HandleEvent();
+#ifdef __linux__
+	// Eventloop implementation for io_uring backend.
+	void HandleIoUringEvent();
+#endif
 	// Process all pending requests and bind easy curl handle with multi curl handle.
 	void ProcessPendingRequests();
+	// Process all pending cancellations.
+	void ProcessCancellations();
+	// Run all pending tasks.
+	void ProcessTasks();
+	// Set connection limits of the multi curl handle, only called on the eventloop thread or before it starts.
+	void ApplyConnectionLimits();
+	// Cancel requests whose deadline has passed.
+	void ExpireDeadlines();
+	// Get milliseconds to wait for the next deadline, -1 if there's none.
+	int GetDeadlineTimeoutMs() const;
+	// Take snapshots of all requests bound to the multi curl handle, only called on the eventloop thread.
+	vector<InflightRequestSnapshot> CollectInflightRequests() const;
+	// Record a return from the polling engine wait with the given number of events, and refresh request gauges.
+	void RecordWakeup(idx_t event_count);
 
 	unique_ptr<GlobalInfo> global_info;
-	// Used to protect [`pending_requests`].
-	std::mutex mu;
-	queue<unique_ptr<CurlRequest>> pending_requests;
+	// Requests submitted but not yet bound to the multi curl handle, the eventloop is only woken up when the queue
+	// turns non-empty.
+	MpscQueue<unique_ptr<CurlRequest>> pending_requests;
+	// Ids of requests to cancel, which shares wakeup with [`pending_requests`].
+	MpscQueue<uint64_t> pending_cancellations;
+	// Tasks to run on the eventloop thread, which shares wakeup with [`pending_requests`].
+	MpscQueue<std::function<void()>> pending_tasks;
+	// Used to assign request ids.
+	std::atomic<uint64_t> next_request_id {1};
 	// Background thread which keeps polling with polling engine.
 	std::thread bkg_thread;
 };
 
+class MultiCurlManager {
+public:
+	// Max number of eventloops could be created.
+	static constexpr idx_t MAX_EVENT_LOOP_COUNT = 64;
+
+	static MultiCurlManager &GetInstance();
+	~MultiCurlManager() = default;
+
+	// Disable copy / move constructor / assignment.
+	MultiCurlManager(const MultiCurlManager &) = delete;
+	MultiCurlManager &operator=(const MultiCurlManager &) = delete;
+
+	// Get the default number of eventloops, which is derived from available CPU core number.
+	static idx_t GetDefaultEventLoopCount();
+
+	// Submit the given request without blocking, its completion callback or slot must be set.
+	CurlRequestHandle SubmitRequest(unique_ptr<CurlRequest> request);
+	// Submit all given requests without blocking, their completion callbacks or slots must be set.
+	// Return handles in the order of requests.
+	vector<CurlRequestHandle> SubmitRequests(vector<unique_ptr<CurlRequest>> requests);
+
+	// Cancel the given request without blocking, see [`CurlEventLoop::CancelRequest`].
+	void CancelRequest(const CurlRequestHandle &handle);
+
+	// Take snapshots of health metrics for all created eventloops, ordered by eventloop index.
+	vector<EventLoopStatsSnapshot> GetEventLoopStats();
+
+	// Copy curl debug events recorded by all created eventloops, most recent first.
+	vector<DebugEvent> GetDebugEvents();
+
+	// Take snapshots of requests in flight for all created eventloops, ordered by eventloop index; eventloops which
+	// don't respond in time are skipped.
+	vector<InflightRequestSnapshot> GetInflightRequests();
+
+	// Apply connection limits from global configuration to all created eventloops, see
+	// [`CurlEventLoop::RefreshConnectionLimits`]. Eventloops created afterwards pick them up on creation.
+	void RefreshConnectionLimits();
+
+	// Handle the given request, and block wait until its completion.
+	// If [`interrupt_check`] is set, it's checked periodically, and the request is cancelled once it returns true.
+	unique_ptr<HTTPResponse> HandleRequest(unique_ptr<CurlRequest> request,
+	                                       const CurlInterruptCheck &interrupt_check = nullptr);
+
+private:
+	MultiCurlManager() = default;
+
+	// Get the eventloop to handle the given request, eventloops are created lazily.
+	CurlEventLoop &GetEventLoop(const CurlRequest &request);
+	// Get the eventloop at the given index, create if it doesn't exist.
+	CurlEventLoop &GetOrCreateEventLoop(idx_t loop_idx);
+
+	// Eventloops are created on demand and never destroyed, so they could be accessed without lock.
+	std::array<std::atomic<CurlEventLoop *>, MAX_EVENT_LOOP_COUNT> event_loops {};
+	// Used to protect eventloop creation.
+	std::mutex event_loop_creation_mu;
+	// Used for round-robin eventloop routing.
+	std::atomic<idx_t> next_event_loop {0};
+};
+
 } // namespace duckdb
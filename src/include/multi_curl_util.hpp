@@ -6,6 +6,8 @@ namespace duckdb {
 
 class MultiCurlUtil : public HTTPFSCurlUtil {
 public:
+	unique_ptr<HTTPParams> InitializeParameters(optional_ptr<FileOpener> opener,
+	                                            optional_ptr<FileOpenerInfo> info) override;
 	unique_ptr<HTTPClient> InitializeClient(HTTPParams &http_params, const string &proto_host_port) override;
 	string GetName() const override;
 };
@@ -0,0 +1,12 @@
+// Function which gets per-host request phase latency.
+
+#pragma once
+
+#include "duckdb/function/table_function.hpp"
+
+namespace duckdb {
+
+// Get the table function to get latency percentiles of each request phase per host.
+TableFunction GetRequestLatencyFunc();
+
+} // namespace duckdb
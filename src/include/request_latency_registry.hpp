@@ -0,0 +1,54 @@
+// Per-host latency histograms for each phase of completed requests, i.e. DNS resolution, TCP connect, TLS
+// handshake, time to first byte and transfer.
+
+#pragma once
+
+#include <array>
+
+#include "curl_transfer_info.hpp"
+#include "duckdb/common/string.hpp"
+#include "host_registry.hpp"
+#include "latency_histogram.hpp"
+
+namespace duckdb {
+
+// Phases of a request.
+enum class RequestPhase : uint8_t {
+	// DNS resolution, only recorded for requests opening new connections.
+	DNS,
+	// TCP connect after DNS resolution, only recorded for requests opening new connections.
+	CONNECT,
+	// TLS handshake after TCP connect, only recorded for requests opening new TLS connections.
+	TLS,
+	// From connection being ready to the first response byte.
+	FIRST_BYTE,
+	// From the first response byte to transfer completion.
+	TRANSFER,
+	// Whole request.
+	TOTAL,
+};
+
+inline constexpr idx_t REQUEST_PHASE_COUNT = 6;
+
+// Get the name of the given phase.
+const char *GetRequestPhaseName(RequestPhase phase);
+
+// Latency histograms of one host.
+struct HostRequestLatency {
+	// Latency snapshot of one host.
+	struct Snapshot {
+		string host;
+		std::array<LatencyHistogram::Snapshot, REQUEST_PHASE_COUNT> phases;
+	};
+
+	std::array<LatencyHistogram, REQUEST_PHASE_COUNT> phases;
+
+	// Record phase latencies of the given finished transfer.
+	void Record(const CurlTransferInfo &info);
+	// Take a snapshot of all phases, host is left empty.
+	Snapshot GetSnapshot() const;
+};
+
+using RequestLatencyRegistry = HostRegistry<HostRequestLatency>;
+
+} // namespace duckdb
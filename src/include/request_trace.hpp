@@ -0,0 +1,112 @@
+// Request tracing, which records the timeline of every request handled by eventloops and exports it in Chrome trace
+// event format, viewable in Perfetto or `chrome://tracing`.
+//
+// Records are appended to a [`SeqlockRing`] without locking, when it wraps around the oldest records are lost.
+//
+// Each request produces a record on the eventloop thread when it completes; blocking requests produce another one on
+// the caller thread once it's woken up, the two are joined by trace id on export.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/typedefs.hpp"
+#include "duckdb/common/vector.hpp"
+#include "seqlock_ring.hpp"
+
+namespace duckdb {
+
+struct RequestTraceRecord {
+	enum class Kind : uint8_t {
+		// Request completed on the eventloop.
+		COMPLETION,
+		// Caller of a blocking request woken up.
+		WAKEUP,
+	};
+
+	// Max length of strings kept in a record, longer ones are truncated.
+	static constexpr idx_t MAX_METHOD_LEN = 8;
+	static constexpr idx_t MAX_URL_LEN = 200;
+	static constexpr idx_t MAX_RANGE_LEN = 48;
+
+	Kind kind = Kind::COMPLETION;
+	// Joins records of the same request.
+	uint64_t trace_id = 0;
+	// Thread which submits the request, see [`RequestTrace::GetCurrentThreadId`].
+	uint32_t caller_thread_id = 0;
+	uint16_t status_code = 0;
+	bool failed = false;
+	uint64_t bytes_received = 0;
+
+	// Steady clock timestamps in nanoseconds, 0 means the phase didn't happen.
+	int64_t submit_ns = 0;
+	// Request bound to the multi curl handle.
+	int64_t add_ns = 0;
+	// Curl starts the transfer, which is later than [`add_ns`] if the request waits for a connection slot.
+	int64_t start_ns = 0;
+	int64_t namelookup_ns = 0;
+	int64_t connect_ns = 0;
+	int64_t appconnect_ns = 0;
+	int64_t first_byte_ns = 0;
+	int64_t complete_ns = 0;
+	// Only set for wakeup records.
+	int64_t wakeup_ns = 0;
+
+	std::array<char, MAX_METHOD_LEN> method {};
+	std::array<char, MAX_URL_LEN> url {};
+	std::array<char, MAX_RANGE_LEN> range {};
+
+	// Copy the given string into a fixed-size field, truncate if it doesn't fit.
+	template <size_t N>
+	static void SetString(std::array<char, N> &field, const string &value) {
+		const size_t len = std::min<size_t>(value.size(), N - 1);
+		value.copy(field.data(), len);
+		field[len] = '\0';
+	}
+};
+
+class RequestTrace {
+public:
+	// Number of records kept in the ring.
+	static constexpr idx_t CAPACITY = 1 << 15;
+
+	static RequestTrace &GetInstance();
+
+	// Disable copy / move constructor / assignment.
+	RequestTrace(const RequestTrace &) = delete;
+	RequestTrace &operator=(const RequestTrace &) = delete;
+
+	// Get a new trace id, which is never 0.
+	uint64_t NextTraceId();
+	// Get a small integer identifying the current thread, which reads better than native thread ids in traces.
+	static uint32_t GetCurrentThreadId();
+
+	// Append the given record without blocking.
+	void Append(const RequestTraceRecord &record);
+
+	// Take all records appended since the last drain, oldest first.
+	vector<RequestTraceRecord> Drain();
+
+	// Drain all records, and write them in Chrome trace event format to the given stream; return the number of
+	// requests written.
+	idx_t ExportChromeTrace(std::ostream &out);
+
+private:
+	RequestTrace() = default;
+
+	SeqlockRing<RequestTraceRecord, CAPACITY> ring;
+	std::atomic<uint64_t> next_trace_id {1};
+
+	// Protects draining, which only happens on export.
+	std::mutex drain_mu;
+	// Position of the first record not drained yet.
+	uint64_t drained_position = 0;
+};
+
+} // namespace duckdb
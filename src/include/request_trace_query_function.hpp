@@ -0,0 +1,12 @@
+// Function which exports request trace.
+
+#pragma once
+
+#include "duckdb/function/table_function.hpp"
+
+namespace duckdb {
+
+// Get the table function to export recorded request timelines to a Chrome trace JSON file.
+TableFunction GetExportRequestTraceFunc();
+
+} // namespace duckdb
@@ -0,0 +1,100 @@
+// A fixed-capacity ring of records, which is appended to and read without locking.
+//
+// Writers claim a position with one atomic increment, and publish the record with a per-slot sequence number, so
+// readers skip slots being written or overwritten. When the ring wraps around, the oldest records are lost. Slots are
+// allocated on the first append, so rings which are never written don't pay for them.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "duckdb/common/typedefs.hpp"
+#include "duckdb/common/vector.hpp"
+
+namespace duckdb {
+
+// [`T`] should be trivially copyable.
+template <typename T, idx_t CAPACITY>
+class SeqlockRing {
+public:
+	SeqlockRing() = default;
+	~SeqlockRing() {
+		delete[] slots.load();
+	}
+
+	// Disable copy / move constructor / assignment.
+	SeqlockRing(const SeqlockRing &) = delete;
+	SeqlockRing &operator=(const SeqlockRing &) = delete;
+
+	// Append the given record without blocking. Could be called from any thread.
+	void Append(const T &record) {
+		Slot *cur_slots = GetOrAllocateSlots();
+		const uint64_t position = next_position.fetch_add(1, std::memory_order_relaxed);
+		auto &slot = cur_slots[position % CAPACITY];
+		slot.sequence.store(2 * position + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		slot.record = record;
+		slot.sequence.store(2 * position + 2, std::memory_order_release);
+	}
+
+	// Get the position of the next record to append, which is the number of records appended so far.
+	uint64_t GetNextPosition() const {
+		return next_position.load(std::memory_order_acquire);
+	}
+
+	// Append records at positions within [`begin_position`, `end_position`) to [`records`], oldest first. Positions
+	// no longer in the ring, and records still being written are skipped.
+	void Read(uint64_t begin_position, uint64_t end_position, vector<T> &records) const {
+		const Slot *cur_slots = slots.load(std::memory_order_acquire);
+		if (cur_slots == nullptr) {
+			return;
+		}
+		uint64_t position = begin_position;
+		if (end_position - position > CAPACITY) {
+			position = end_position - CAPACITY;
+		}
+		records.reserve(records.size() + (end_position - position));
+		for (; position < end_position; ++position) {
+			const auto &slot = cur_slots[position % CAPACITY];
+			const uint64_t expected_sequence = 2 * position + 2;
+			if (slot.sequence.load(std::memory_order_acquire) != expected_sequence) {
+				// Record still being written, or already overwritten.
+				continue;
+			}
+			T record = slot.record;
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (slot.sequence.load(std::memory_order_relaxed) != expected_sequence) {
+				continue;
+			}
+			records.emplace_back(record);
+		}
+	}
+
+private:
+	struct Slot {
+		// 0 means empty, odd means being written, otherwise (2 * position + 2) of the record held.
+		std::atomic<uint64_t> sequence {0};
+		T record;
+	};
+
+	Slot *GetOrAllocateSlots() {
+		Slot *cur_slots = slots.load(std::memory_order_acquire);
+		if (cur_slots != nullptr) {
+			return cur_slots;
+		}
+		auto *new_slots = new Slot[CAPACITY];
+		if (slots.compare_exchange_strong(cur_slots, new_slots, std::memory_order_acq_rel)) {
+			return new_slots;
+		}
+		// Another writer allocated the slots first.
+		delete[] new_slots;
+		return cur_slots;
+	}
+
+	std::atomic<Slot *> slots {nullptr};
+	// Position for the next record.
+	std::atomic<uint64_t> next_position {0};
+};
+
+} // namespace duckdb
@@ -0,0 +1,80 @@
+// Log of slow requests, which catches long-tail requests without tracing every request.
+//
+// Eventloops append requests which take longer than the configured threshold from submission to completion; only the
+// latest entries are kept. Slow requests are rare, so the log is simply protected by a mutex.
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+
+#include "curl_transfer_info.hpp"
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/typedefs.hpp"
+#include "duckdb/common/vector.hpp"
+
+namespace duckdb {
+
+struct SlowRequestEntry {
+	// Wall clock time of completion in microseconds since epoch.
+	int64_t timestamp_us = 0;
+	string method;
+	// Credentials in query parameters are redacted.
+	string url;
+	// Value of the range header, empty if there's none.
+	string range;
+	uint16_t status_code = 0;
+	// Set if the request failed without a response.
+	string request_error;
+
+	// Connection used by the transfer, -1 if unknown.
+	int64_t connection_id = -1;
+	// Number of new connections opened by the transfer, 0 means a cached connection is reused.
+	uint64_t new_connections = 0;
+	// Number of redirects followed.
+	uint64_t redirects = 0;
+	uint64_t bytes_received = 0;
+
+	// Phase durations in microseconds, see [`RequestPhase`]. Connection setup phases are 0 for reused connections.
+	uint64_t queue_us = 0;
+	uint64_t dns_us = 0;
+	uint64_t connect_us = 0;
+	uint64_t tls_us = 0;
+	uint64_t first_byte_us = 0;
+	uint64_t transfer_us = 0;
+	// From submission to completion, which includes queueing.
+	uint64_t total_us = 0;
+
+	// Fill in connection info and phase durations of the given finished transfer, except queueing and total time.
+	void SetTransferInfo(const CurlTransferInfo &info);
+};
+
+class SlowRequestLog {
+public:
+	// Number of entries kept.
+	static constexpr idx_t CAPACITY = 1024;
+
+	static SlowRequestLog &GetInstance();
+
+	// Disable copy / move constructor / assignment.
+	SlowRequestLog(const SlowRequestLog &) = delete;
+	SlowRequestLog &operator=(const SlowRequestLog &) = delete;
+
+	// Append the given entry, the oldest entry is evicted if the log is full.
+	void Append(SlowRequestEntry entry);
+
+	// Copy all entries, most recent first.
+	vector<SlowRequestEntry> GetEntries();
+
+	// Remove all entries.
+	void Clear();
+
+private:
+	SlowRequestLog() = default;
+
+	std::mutex mu;
+	std::deque<SlowRequestEntry> entries;
+};
+
+} // namespace duckdb
@@ -0,0 +1,12 @@
+// Function which gets requests recorded in the slow request log.
+
+#pragma once
+
+#include "duckdb/function/table_function.hpp"
+
+namespace duckdb {
+
+// Get the table function to get requests slower than `curl_httpfs_slow_request_threshold_ms`, most recent first.
+TableFunction GetSlowRequestsFunc();
+
+} // namespace duckdb
@@ -30,4 +30,14 @@ namespace duckdb {
 		}                                                                                                              \
 	} while (0)
 
+#define SYSCALL_LOG_IF_ERROR(ret)                                                                                      \
+	do {                                                                                                               \
+		if ((ret) < 0) {                                                                                               \
+			int errnum = errno;                                                                                        \
+			const string err_msg = StringUtil::Format("Failed to execute syscall with errno %d and error message %s",  \
+			                                          errnum, std::strerror(errnum));                                  \
+			std::cerr << err_msg << std::endl;                                                                         \
+		}                                                                                                              \
+	} while (0)
+
 } // namespace duckdb
@@ -1,11 +1,36 @@
 #pragma once
 
+#include <cstdint>
+
 #include "duckdb/common/string.hpp"
-#include "duckdb/common/unordered_map.hpp"
+#include "duckdb/common/vector.hpp"
 
 namespace duckdb {
 
-// Get TCP connection number grouped by IP.
-unordered_map<string, int> GetTcpConnectionNum();
+// Status of a TCP connection.
+struct TcpConnectionInfo {
+	string local_ip;
+	uint16_t local_port = 0;
+	string remote_ip;
+	uint16_t remote_port = 0;
+	// TCP state name, i.e. `ESTABLISHED`.
+	string state;
+
+	// Whether fields below are available, which are taken from kernel's TCP_INFO.
+	bool has_tcp_info = false;
+	// Smoothed round trip time and its variance.
+	uint32_t rtt_us = 0;
+	uint32_t rtt_var_us = 0;
+	// Congestion window in segments.
+	uint32_t cwnd = 0;
+	// Total number of retransmitted segments over the connection lifetime.
+	uint32_t retransmits = 0;
+	uint64_t bytes_acked = 0;
+	uint64_t bytes_received = 0;
+};
+
+// Get TCP connections owned by the current process on linux; on macOS all TCP connections of the host are returned
+// without TCP_INFO.
+vector<TcpConnectionInfo> GetTcpConnections();
 
 } // namespace duckdb
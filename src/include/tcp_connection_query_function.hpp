@@ -6,7 +6,7 @@
 
 namespace duckdb {
 
-// Get the table function to get system TCP connection status.
-TableFunction GetTcpConnectionNumFunc();
+// Get the table function to get TCP connections of the current process, along with their TCP_INFO.
+TableFunction GetTcpConnectionFunc();
 
 } // namespace duckdb
@@ -0,0 +1,38 @@
+// Clock helpers shared by eventloops and request instrumentation.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace duckdb {
+
+// Get nanoseconds since epoch of the steady clock.
+inline int64_t ToSteadyNs(std::chrono::steady_clock::time_point time_point) {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(time_point.time_since_epoch()).count();
+}
+
+// Get current time in nanoseconds since epoch of the steady clock.
+inline int64_t GetSteadyNowNs() {
+	return ToSteadyNs(std::chrono::steady_clock::now());
+}
+
+// Get current wall clock time in microseconds since epoch.
+inline int64_t GetSystemNowUs() {
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch())
+	    .count();
+}
+
+// Get milliseconds since epoch of the steady clock, rounded down.
+inline int64_t ToSteadyMs(std::chrono::steady_clock::time_point time_point) {
+	return std::chrono::duration_cast<std::chrono::milliseconds>(time_point.time_since_epoch()).count();
+}
+
+// Get milliseconds since epoch of the steady clock, rounded up so a deadline never expires before the exact time point.
+inline int64_t ToSteadyMsCeil(std::chrono::steady_clock::time_point time_point) {
+	const auto since_epoch = time_point.time_since_epoch();
+	const int64_t floor_ms = std::chrono::duration_cast<std::chrono::milliseconds>(since_epoch).count();
+	return std::chrono::milliseconds(floor_ms) < since_epoch ? floor_ms + 1 : floor_ms;
+}
+
+} // namespace duckdb
@@ -0,0 +1,106 @@
+// A hashed timer wheel, which tracks a large number of deadlines with O(1) insertion and expiration amortized over
+// ticks.
+//
+// Deadlines are bucketed into slots by tick; a slot holds deadlines of all rounds mapped onto it, those of later
+// rounds are kept when the slot is scanned. The earliest deadline is cached, so querying the timeout on every eventloop
+// wakeup is O(1); it's only recomputed once expired. It's not thread-safe, and is meant to be owned by a single
+// eventloop.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+#include "duckdb/common/typedefs.hpp"
+#include "duckdb/common/vector.hpp"
+
+namespace duckdb {
+
+class TimerWheel {
+public:
+	// Default tick granularity.
+	static constexpr int64_t DEFAULT_TICK_MS = 10;
+	// Default slot number, which covers about 10 seconds per round with default tick.
+	static constexpr idx_t DEFAULT_SLOT_COUNT = 1024;
+
+	TimerWheel(int64_t tick_ms_p = DEFAULT_TICK_MS, idx_t slot_count = DEFAULT_SLOT_COUNT);
+
+	// Disable copy / move constructor / assignment.
+	TimerWheel(const TimerWheel &) = delete;
+	TimerWheel &operator=(const TimerWheel &) = delete;
+
+	// Add a deadline with the given id, which is reported on expiration; deadlines already passed expire on the next
+	// advance.
+	void Add(int64_t deadline_ms, uint64_t id);
+
+	// Remove the deadline added with the given deadline and id before it expires, which only scans the slot it's
+	// bucketed into. Return whether it's found.
+	bool Remove(int64_t deadline_ms, uint64_t id);
+
+	// Advance the wheel to [`now_ms`], and invoke [`fn`] with ids of all expired deadlines.
+	// [`fn`] should not add or remove deadlines.
+	template <typename Fn>
+	void Advance(int64_t now_ms, Fn &&fn);
+
+	// Get milliseconds until the earliest deadline, return -1 if there's no deadline.
+	int64_t GetTimeoutMs(int64_t now_ms);
+
+	// Get number of pending deadlines.
+	idx_t Size() const {
+		return size;
+	}
+
+private:
+	struct Entry {
+		int64_t deadline_ms = 0;
+		uint64_t id = 0;
+	};
+
+	// Find the earliest pending deadline, there should be at least one.
+	int64_t FindEarliestDeadlineMs() const;
+
+	int64_t tick_ms = 0;
+	vector<vector<Entry>> slots;
+	// Tick the wheel has advanced to, slot of which might still hold unexpired deadlines.
+	int64_t current_tick = -1;
+	idx_t size = 0;
+	// Earliest pending deadline, only meaningful if [`earliest_deadline_valid`].
+	int64_t earliest_deadline_ms = 0;
+	bool earliest_deadline_valid = false;
+};
+
+template <typename Fn>
+void TimerWheel::Advance(int64_t now_ms, Fn &&fn) {
+	const int64_t now_tick = now_ms / tick_ms;
+	if (size == 0) {
+		current_tick = now_tick;
+		return;
+	}
+	if (now_tick < current_tick) {
+		return;
+	}
+
+	// All slots are visited once at most, even if the clock jumps over multiple rounds.
+	const int64_t slot_count = static_cast<int64_t>(slots.size());
+	const int64_t last_tick = std::min(now_tick, current_tick + slot_count - 1);
+	for (int64_t tick = current_tick; tick <= last_tick; ++tick) {
+		auto &slot = slots[static_cast<idx_t>(tick % slot_count)];
+		idx_t kept = 0;
+		for (idx_t idx = 0; idx < slot.size(); ++idx) {
+			if (slot[idx].deadline_ms <= now_ms) {
+				--size;
+				fn(slot[idx].id);
+				continue;
+			}
+			slot[kept++] = slot[idx];
+		}
+		slot.resize(kept);
+	}
+	current_tick = now_tick;
+	// All deadlines up to now have expired, including the cached earliest one if it's passed.
+	if (earliest_deadline_valid && earliest_deadline_ms <= now_ms) {
+		earliest_deadline_valid = false;
+	}
+}
+
+} // namespace duckdb
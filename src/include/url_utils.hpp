@@ -0,0 +1,11 @@
+#pragma once
+
+#include "duckdb/common/string.hpp"
+
+namespace duckdb {
+
+// Get the "host[:port]" part of the given URL, for example, "https://bucket.s3.amazonaws.com/key" returns
+// "bucket.s3.amazonaws.com". Return empty string if the URL doesn't contain a host.
+string GetUrlHost(const string &url);
+
+} // namespace duckdb
@@ -0,0 +1,99 @@
+#include "inflight_requests_query_function.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include "duckdb/common/helper.hpp"
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/unique_ptr.hpp"
+#include "duckdb/common/vector.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "inflight_request.hpp"
+#include "multi_curl_manager.hpp"
+
+namespace duckdb {
+
+namespace {
+
+//===--------------------------------------------------------------------===//
+// Get inflight requests query function
+//===--------------------------------------------------------------------===//
+
+struct InflightRequestsData : public GlobalTableFunctionState {
+	vector<InflightRequestSnapshot> snapshots;
+
+	// Used to record the progress of emission.
+	uint64_t offset = 0;
+};
+
+unique_ptr<FunctionData> GetInflightRequestsFuncBind(ClientContext &context, TableFunctionBindInput &input,
+                                                     vector<LogicalType> &return_types, vector<string> &names) {
+	ALWAYS_ASSERT(return_types.empty());
+	ALWAYS_ASSERT(names.empty());
+
+	auto add_column = [&](const char *name, LogicalTypeId type) {
+		names.emplace_back(name);
+		return_types.emplace_back(LogicalType {type});
+	};
+	add_column("event_loop", LogicalTypeId::UBIGINT);
+	add_column("url", LogicalTypeId::VARCHAR);
+	add_column("method", LogicalTypeId::VARCHAR);
+	add_column("range", LogicalTypeId::VARCHAR);
+	add_column("state", LogicalTypeId::VARCHAR);
+	add_column("bytes_received", LogicalTypeId::UBIGINT);
+	add_column("elapsed_ms", LogicalTypeId::DOUBLE);
+
+	return nullptr;
+}
+
+unique_ptr<GlobalTableFunctionState> GetInflightRequestsFuncInit(ClientContext &context,
+                                                                 TableFunctionInitInput &input) {
+	auto result = make_uniq<InflightRequestsData>();
+	auto &snapshots = result->snapshots;
+	snapshots = MultiCurlManager::GetInstance().GetInflightRequests();
+
+	// Longest running requests first, which are most likely the ones a hanging query waits on.
+	std::sort(snapshots.begin(), snapshots.end(),
+	          [](const InflightRequestSnapshot &lhs, const InflightRequestSnapshot &rhs) {
+		          return lhs.elapsed_us > rhs.elapsed_us;
+	          });
+
+	return std::move(result);
+}
+
+void GetInflightRequestsTableFunc(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+	auto &data = data_p.global_state->Cast<InflightRequestsData>();
+
+	// All entries have been emitted.
+	if (data.offset >= data.snapshots.size()) {
+		return;
+	}
+
+	// Start filling in the result buffer.
+	idx_t count = 0;
+	while (data.offset < data.snapshots.size() && count < STANDARD_VECTOR_SIZE) {
+		auto &entry = data.snapshots[data.offset++];
+		idx_t col_idx = 0;
+		output.SetValue(col_idx++, count, Value::UBIGINT(entry.event_loop_idx));
+		output.SetValue(col_idx++, count, entry.url);
+		output.SetValue(col_idx++, count, entry.method);
+		output.SetValue(col_idx++, count, entry.range.empty() ? Value() : Value(entry.range));
+		output.SetValue(col_idx++, count, GetInflightRequestStateName(entry.state));
+		output.SetValue(col_idx++, count, Value::UBIGINT(entry.bytes_received));
+		output.SetValue(col_idx++, count, Value::DOUBLE(static_cast<double>(entry.elapsed_us) / 1000));
+		count++;
+	}
+	output.SetCardinality(count);
+}
+} // namespace
+
+TableFunction GetInflightRequestsFunc() {
+	TableFunction inflight_requests_query_func {/*name=*/"curl_httpfs_inflight_requests",
+	                                            /*arguments=*/ {},
+	                                            /*function=*/GetInflightRequestsTableFunc,
+	                                            /*bind=*/GetInflightRequestsFuncBind,
+	                                            /*init_global=*/GetInflightRequestsFuncInit};
+	return inflight_requests_query_func;
+}
+} // namespace duckdb
@@ -0,0 +1,195 @@
+#include "io_uring_ring.hpp"
+
+#ifdef __linux__
+
+#include <algorithm>
+#include <csignal>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "duckdb/common/helper.hpp"
+#include "syscall_macros.hpp"
+
+namespace duckdb {
+
+namespace {
+
+int IoUringSetup(uint32_t entries, io_uring_params *params) {
+	return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int IoUringEnter(int ring_fd, uint32_t to_submit, uint32_t min_complete, uint32_t flags, void *arg, size_t arg_size) {
+	return static_cast<int>(syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, arg, arg_size));
+}
+
+} // namespace
+
+/*static*/ unique_ptr<IoUring> IoUring::Create(uint32_t entries) {
+	io_uring_params params;
+	memset(&params, 0, sizeof(params));
+	const int ring_fd = IoUringSetup(entries, &params);
+	if (ring_fd < 0) {
+		return nullptr;
+	}
+	// Wait timeout is passed via extended arguments, which requires linux 5.11.
+	if ((params.features & IORING_FEAT_EXT_ARG) == 0) {
+		close(ring_fd);
+		return nullptr;
+	}
+
+	auto ring = unique_ptr<IoUring>(new IoUring());
+	ring->ring_fd = ring_fd;
+
+	ring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+	ring->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+	const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+	if (single_mmap) {
+		ring->sq_ring_size = std::max(ring->sq_ring_size, ring->cq_ring_size);
+		ring->cq_ring_size = ring->sq_ring_size;
+	}
+
+	ring->sq_ring_ptr = mmap(nullptr, ring->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd,
+	                         IORING_OFF_SQ_RING);
+	if (ring->sq_ring_ptr == MAP_FAILED) {
+		ring->sq_ring_ptr = nullptr;
+		return nullptr;
+	}
+	if (single_mmap) {
+		ring->cq_ring_ptr = ring->sq_ring_ptr;
+	} else {
+		ring->cq_ring_ptr = mmap(nullptr, ring->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+		                         ring_fd, IORING_OFF_CQ_RING);
+		if (ring->cq_ring_ptr == MAP_FAILED) {
+			ring->cq_ring_ptr = nullptr;
+			return nullptr;
+		}
+	}
+	ring->sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+	void *sqes_ptr =
+	    mmap(nullptr, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+	if (sqes_ptr == MAP_FAILED) {
+		return nullptr;
+	}
+	ring->sqes = static_cast<io_uring_sqe *>(sqes_ptr);
+
+	auto *sq_base = static_cast<uint8_t *>(ring->sq_ring_ptr);
+	ring->sq_head = reinterpret_cast<uint32_t *>(sq_base + params.sq_off.head);
+	ring->sq_tail = reinterpret_cast<uint32_t *>(sq_base + params.sq_off.tail);
+	ring->sq_array = reinterpret_cast<uint32_t *>(sq_base + params.sq_off.array);
+	ring->sq_mask = *reinterpret_cast<uint32_t *>(sq_base + params.sq_off.ring_mask);
+	ring->sq_entries = *reinterpret_cast<uint32_t *>(sq_base + params.sq_off.ring_entries);
+	ring->sqe_tail = *ring->sq_tail;
+
+	auto *cq_base = static_cast<uint8_t *>(ring->cq_ring_ptr);
+	ring->cq_head = reinterpret_cast<uint32_t *>(cq_base + params.cq_off.head);
+	ring->cq_tail = reinterpret_cast<uint32_t *>(cq_base + params.cq_off.tail);
+	ring->cqes = reinterpret_cast<io_uring_cqe *>(cq_base + params.cq_off.cqes);
+	ring->cq_mask = *reinterpret_cast<uint32_t *>(cq_base + params.cq_off.ring_mask);
+
+	return ring;
+}
+
+/*static*/ bool IoUring::IsSupported() {
+	return IoUring::Create(/*entries=*/1) != nullptr;
+}
+
+IoUring::~IoUring() {
+	if (sqes != nullptr) {
+		munmap(sqes, sqes_size);
+	}
+	if (cq_ring_ptr != nullptr && cq_ring_ptr != sq_ring_ptr) {
+		munmap(cq_ring_ptr, cq_ring_size);
+	}
+	if (sq_ring_ptr != nullptr) {
+		munmap(sq_ring_ptr, sq_ring_size);
+	}
+	if (ring_fd >= 0) {
+		close(ring_fd);
+	}
+}
+
+io_uring_sqe *IoUring::GetSqe() {
+	// Kernel consumes all submitted entries within `io_uring_enter`, so flushing always frees up space.
+	if (sqe_tail - __atomic_load_n(sq_head, __ATOMIC_ACQUIRE) >= sq_entries) {
+		Enter(/*wait=*/false, /*timeout_ns=*/-1);
+	}
+	const uint32_t index = sqe_tail & sq_mask;
+	io_uring_sqe *sqe = &sqes[index];
+	memset(sqe, 0, sizeof(*sqe));
+	sq_array[index] = index;
+	++sqe_tail;
+	return sqe;
+}
+
+void IoUring::PrepPollAdd(int fd, uint32_t poll_mask, uint64_t user_data) {
+	auto *sqe = GetSqe();
+	sqe->opcode = IORING_OP_POLL_ADD;
+	sqe->fd = fd;
+	sqe->poll32_events = poll_mask;
+	sqe->user_data = user_data;
+}
+
+void IoUring::PrepPollRemove(uint64_t target_user_data, uint64_t user_data) {
+	auto *sqe = GetSqe();
+	sqe->opcode = IORING_OP_POLL_REMOVE;
+	sqe->fd = -1;
+	sqe->addr = target_user_data;
+	sqe->user_data = user_data;
+}
+
+void IoUring::PrepRead(int fd, void *buffer, uint32_t len, uint64_t user_data) {
+	auto *sqe = GetSqe();
+	sqe->opcode = IORING_OP_READ;
+	sqe->fd = fd;
+	sqe->addr = reinterpret_cast<uint64_t>(buffer);
+	sqe->len = len;
+	sqe->off = 0;
+	sqe->user_data = user_data;
+}
+
+void IoUring::SubmitAndWait(int64_t timeout_ns) {
+	Enter(/*wait=*/true, timeout_ns);
+}
+
+void IoUring::Enter(bool wait, int64_t timeout_ns) {
+	// Publish prepared entries to the kernel.
+	__atomic_store_n(sq_tail, sqe_tail, __ATOMIC_RELEASE);
+
+	__kernel_timespec ts;
+	io_uring_getevents_arg arg;
+	memset(&arg, 0, sizeof(arg));
+	arg.sigmask_sz = _NSIG / 8;
+	if (timeout_ns >= 0) {
+		ts.tv_sec = timeout_ns / 1000000000;
+		ts.tv_nsec = timeout_ns % 1000000000;
+		arg.ts = reinterpret_cast<uint64_t>(&ts);
+	}
+
+	while (true) {
+		const uint32_t to_submit = sqe_tail - __atomic_load_n(sq_head, __ATOMIC_ACQUIRE);
+		if (!wait && to_submit == 0) {
+			return;
+		}
+		const uint32_t flags = wait ? (IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG) : IORING_ENTER_EXT_ARG;
+		const int ret = IoUringEnter(ring_fd, to_submit, /*min_complete=*/wait ? 1 : 0, flags, &arg, sizeof(arg));
+		if (ret >= 0) {
+			// Entries might be partially consumed on resource shortage, retry submitting the rest.
+			if (!wait && sqe_tail != __atomic_load_n(sq_head, __ATOMIC_ACQUIRE)) {
+				continue;
+			}
+			return;
+		}
+		// Timeout, interruption and completion ring overflow all return control to the eventloop, which re-checks
+		// its state and waits again.
+		if (errno == ETIME || errno == EINTR || errno == EBUSY || errno == EAGAIN) {
+			return;
+		}
+		SYSCALL_THROW_IF_ERROR(ret);
+	}
+}
+
+} // namespace duckdb
+
+#endif
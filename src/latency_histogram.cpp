@@ -0,0 +1,75 @@
+#include "latency_histogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace duckdb {
+
+/*static*/ idx_t LatencyHistogram::GetBucketIndex(uint64_t latency_us) {
+	if (latency_us < SUB_BUCKET_COUNT) {
+		return static_cast<idx_t>(latency_us);
+	}
+	const idx_t exponent = 63 - static_cast<idx_t>(__builtin_clzll(latency_us));
+	if (exponent > MAX_EXPONENT) {
+		return BUCKET_COUNT - 1;
+	}
+	const idx_t sub_bucket = (latency_us >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKET_COUNT - 1);
+	return SUB_BUCKET_COUNT + (exponent - SUB_BUCKET_BITS) * SUB_BUCKET_COUNT + sub_bucket;
+}
+
+/*static*/ uint64_t LatencyHistogram::GetBucketUpperBound(idx_t bucket_idx) {
+	if (bucket_idx < SUB_BUCKET_COUNT) {
+		return bucket_idx;
+	}
+	const idx_t exponent = (bucket_idx - SUB_BUCKET_COUNT) / SUB_BUCKET_COUNT + SUB_BUCKET_BITS;
+	const idx_t sub_bucket = (bucket_idx - SUB_BUCKET_COUNT) % SUB_BUCKET_COUNT;
+	const idx_t shift = exponent - SUB_BUCKET_BITS;
+	return ((SUB_BUCKET_COUNT + sub_bucket + 1) << shift) - 1;
+}
+
+void LatencyHistogram::Record(int64_t latency_us) {
+	const uint64_t value = static_cast<uint64_t>(std::max<int64_t>(latency_us, 0));
+	buckets[GetBucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+	sum_us.fetch_add(value, std::memory_order_relaxed);
+	uint64_t cur_max = max_us.load(std::memory_order_relaxed);
+	while (value > cur_max && !max_us.compare_exchange_weak(cur_max, value, std::memory_order_relaxed)) {
+	}
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::GetSnapshot() const {
+	Snapshot snapshot;
+	snapshot.sum_us = sum_us.load(std::memory_order_relaxed);
+	snapshot.max_us = max_us.load(std::memory_order_relaxed);
+	// Count is derived from buckets, so percentiles are consistent with it.
+	for (idx_t idx = 0; idx < BUCKET_COUNT; ++idx) {
+		snapshot.buckets[idx] = buckets[idx].load(std::memory_order_relaxed);
+		snapshot.count += snapshot.buckets[idx];
+	}
+	return snapshot;
+}
+
+double LatencyHistogram::Snapshot::GetMean() const {
+	if (count == 0) {
+		return 0;
+	}
+	return static_cast<double>(sum_us) / static_cast<double>(count);
+}
+
+uint64_t LatencyHistogram::Snapshot::GetPercentile(double percentile) const {
+	if (count == 0) {
+		return 0;
+	}
+	const double clamped = std::min(std::max(percentile, 0.0), 1.0);
+	const uint64_t rank = std::max<uint64_t>(static_cast<uint64_t>(std::ceil(clamped * count)), 1);
+	uint64_t seen = 0;
+	for (idx_t idx = 0; idx < BUCKET_COUNT; ++idx) {
+		seen += buckets[idx];
+		if (seen >= rank) {
+			// Bucket upper bound overestimates latency, which is capped by the actual max.
+			return std::min(GetBucketUpperBound(idx), max_us);
+		}
+	}
+	return max_us;
+}
+
+} // namespace duckdb
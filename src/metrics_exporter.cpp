@@ -0,0 +1,440 @@
+#include "metrics_exporter.hpp"
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sstream>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/common/vector.hpp"
+#include "http_metrics.hpp"
+#include "latency_histogram.hpp"
+#include "multi_curl_manager.hpp"
+#include "request_latency_registry.hpp"
+
+namespace duckdb {
+
+namespace {
+
+constexpr const char *UNIX_ENDPOINT_PREFIX = "unix:";
+constexpr int LISTEN_BACKLOG = 16;
+// Max size of a scrape request, which only needs the request line.
+constexpr idx_t MAX_REQUEST_SIZE = 8192;
+// Timeout for a scraper to send its request and to read the response, so a stuck scraper doesn't block others, or
+// stopping the exporter, forever.
+constexpr int IO_TIMEOUT_SEC = 1;
+// Upper bound for sending a whole response, which a scraper reading slowly could otherwise extend send by send.
+constexpr auto SEND_DEADLINE = std::chrono::seconds(5);
+
+// Upper bounds of exported histogram buckets in microseconds, and their labels in seconds.
+struct HistogramBound {
+	uint64_t upper_bound_us;
+	const char *label;
+};
+constexpr HistogramBound HISTOGRAM_BOUNDS[] = {
+    {500, "0.0005"},   {1000, "0.001"},   {2500, "0.0025"},  {5000, "0.005"},       {10000, "0.01"},
+    {25000, "0.025"},  {50000, "0.05"},   {100000, "0.1"},   {250000, "0.25"},      {500000, "0.5"},
+    {1000000, "1"},    {2500000, "2.5"},  {5000000, "5"},    {10000000, "10"},      {30000000, "30"},
+};
+
+// Format microseconds as seconds without losing precision.
+string FormatSeconds(uint64_t duration_us) {
+	const string fraction = std::to_string(duration_us % 1000000);
+	return std::to_string(duration_us / 1000000) + "." + string(6 - fraction.size(), '0') + fraction;
+}
+
+string EscapeLabelValue(const string &value) {
+	string escaped;
+	escaped.reserve(value.size());
+	for (char cur_char : value) {
+		if (cur_char == '\\' || cur_char == '"') {
+			escaped += '\\';
+			escaped += cur_char;
+		} else if (cur_char == '\n') {
+			escaped += "\\n";
+		} else {
+			escaped += cur_char;
+		}
+	}
+	return escaped;
+}
+
+void WriteHeader(std::ostream &out, const char *name, const char *type, const char *help) {
+	out << "# HELP " << name << ' ' << help << '\n';
+	out << "# TYPE " << name << ' ' << type << '\n';
+}
+
+// Write a histogram with the given labels, which are either empty or end with a comma.
+void WriteHistogram(std::ostream &out, const char *name, const string &labels,
+                    const LatencyHistogram::Snapshot &snapshot) {
+	// Buckets of the latency histogram are much finer, each is accumulated into the first exported bucket covering it.
+	idx_t bucket_idx = 0;
+	uint64_t cumulative_count = 0;
+	for (const auto &cur_bound : HISTOGRAM_BOUNDS) {
+		while (bucket_idx < LatencyHistogram::BUCKET_COUNT &&
+		       LatencyHistogram::GetBucketUpperBound(bucket_idx) <= cur_bound.upper_bound_us) {
+			cumulative_count += snapshot.buckets[bucket_idx];
+			++bucket_idx;
+		}
+		out << name << "_bucket{" << labels << "le=\"" << cur_bound.label << "\"} " << cumulative_count << '\n';
+	}
+	out << name << "_bucket{" << labels << "le=\"+Inf\"} " << snapshot.count << '\n';
+	const string plain_labels = labels.empty() ? string() : "{" + labels.substr(0, labels.size() - 1) + "}";
+	out << name << "_sum" << plain_labels << ' ' << FormatSeconds(snapshot.sum_us) << '\n';
+	out << name << "_count" << plain_labels << ' ' << snapshot.count << '\n';
+}
+
+void WriteRequestMetrics(std::ostream &out) {
+	auto &metrics = HttpMetrics::GetInstance();
+	WriteHeader(out, "curl_httpfs_requests_total", "counter",
+	            "Completed requests by method and status code, code \"error\" for requests failed without response.");
+	for (idx_t method_idx = 0; method_idx < HTTP_METHOD_COUNT; ++method_idx) {
+		const auto method = static_cast<HttpMethod>(method_idx);
+		for (idx_t slot = 0; slot < HttpMetrics::STATUS_CODE_SLOTS; ++slot) {
+			const uint64_t count = metrics.GetRequestCount(method, slot);
+			if (count == 0) {
+				continue;
+			}
+			out << "curl_httpfs_requests_total{method=\"" << GetHttpMethodName(method) << "\",code=\""
+			    << (slot == 0 ? string("error") : std::to_string(slot)) << "\"} " << count << '\n';
+		}
+	}
+
+	WriteHeader(out, "curl_httpfs_received_bytes_total", "counter", "Response bytes received by method.");
+	for (idx_t method_idx = 0; method_idx < HTTP_METHOD_COUNT; ++method_idx) {
+		const auto method = static_cast<HttpMethod>(method_idx);
+		out << "curl_httpfs_received_bytes_total{method=\"" << GetHttpMethodName(method) << "\"} "
+		    << metrics.GetBytesReceived(method) << '\n';
+	}
+	WriteHeader(out, "curl_httpfs_sent_bytes_total", "counter", "Request bytes sent by method.");
+	for (idx_t method_idx = 0; method_idx < HTTP_METHOD_COUNT; ++method_idx) {
+		const auto method = static_cast<HttpMethod>(method_idx);
+		out << "curl_httpfs_sent_bytes_total{method=\"" << GetHttpMethodName(method) << "\"} "
+		    << metrics.GetBytesSent(method) << '\n';
+	}
+
+	WriteHeader(out, "curl_httpfs_connections_opened_total", "counter", "New connections opened by transfers.");
+	out << "curl_httpfs_connections_opened_total " << metrics.GetConnectionsOpened() << '\n';
+	WriteHeader(out, "curl_httpfs_connections_reused_total", "counter", "Transfers served by an existing connection.");
+	out << "curl_httpfs_connections_reused_total " << metrics.GetConnectionsReused() << '\n';
+
+	WriteHeader(out, "curl_httpfs_request_wait_seconds", "histogram",
+	            "Time callers block on a request, from submission to wakeup.");
+	WriteHistogram(out, "curl_httpfs_request_wait_seconds", string(), metrics.GetWaitSnapshot());
+}
+
+void WriteEventLoopMetrics(std::ostream &out) {
+	const auto stats = MultiCurlManager::GetInstance().GetEventLoopStats();
+	WriteHeader(out, "curl_httpfs_inflight_requests", "gauge",
+	            "Requests in flight by eventloop, either pending in its queue or bound to its multi handle.");
+	for (const auto &cur_stats : stats) {
+		const string event_loop = std::to_string(cur_stats.event_loop_idx);
+		out << "curl_httpfs_inflight_requests{event_loop=\"" << event_loop << "\",state=\"pending\"} "
+		    << cur_stats.pending_requests << '\n';
+		out << "curl_httpfs_inflight_requests{event_loop=\"" << event_loop << "\",state=\"ongoing\"} "
+		    << cur_stats.ongoing_requests << '\n';
+	}
+	WriteHeader(out, "curl_httpfs_running_transfers", "gauge", "Transfers still running as reported by curl.");
+	for (const auto &cur_stats : stats) {
+		out << "curl_httpfs_running_transfers{event_loop=\"" << cur_stats.event_loop_idx << "\"} "
+		    << cur_stats.still_running << '\n';
+	}
+}
+
+void WriteLatencyMetrics(std::ostream &out) {
+	WriteHeader(out, "curl_httpfs_request_phase_seconds", "histogram",
+	            "Latency of successful requests by host and phase.");
+	for (const auto &cur_host : RequestLatencyRegistry::GetInstance().GetSnapshots()) {
+		const string host = EscapeLabelValue(cur_host.host);
+		for (idx_t phase_idx = 0; phase_idx < REQUEST_PHASE_COUNT; ++phase_idx) {
+			const string labels = StringUtil::Format("host=\"%s\",phase=\"%s\",", host,
+			                                         GetRequestPhaseName(static_cast<RequestPhase>(phase_idx)));
+			WriteHistogram(out, "curl_httpfs_request_phase_seconds", labels, cur_host.phases[phase_idx]);
+		}
+	}
+}
+
+// Send the whole buffer, return false if the peer goes away or stops reading.
+bool SendAll(int fd, const string &data) {
+	const auto deadline = std::chrono::steady_clock::now() + SEND_DEADLINE;
+	idx_t offset = 0;
+	while (offset < data.size()) {
+		if (std::chrono::steady_clock::now() > deadline) {
+			return false;
+		}
+#ifdef MSG_NOSIGNAL
+		const ssize_t sent = send(fd, data.data() + offset, data.size() - offset, MSG_NOSIGNAL);
+#else
+		const ssize_t sent = send(fd, data.data() + offset, data.size() - offset, 0);
+#endif
+		if (sent < 0 && errno == EINTR) {
+			continue;
+		}
+		if (sent <= 0) {
+			return false;
+		}
+		offset += static_cast<idx_t>(sent);
+	}
+	return true;
+}
+
+// Serve a single scrape on the given connection, which is closed by the caller.
+void HandleConnection(int conn_fd) {
+	struct timeval io_timeout {};
+	io_timeout.tv_sec = IO_TIMEOUT_SEC;
+	setsockopt(conn_fd, SOL_SOCKET, SO_RCVTIMEO, &io_timeout, sizeof(io_timeout));
+	setsockopt(conn_fd, SOL_SOCKET, SO_SNDTIMEO, &io_timeout, sizeof(io_timeout));
+#ifdef SO_NOSIGPIPE
+	const int one = 1;
+	setsockopt(conn_fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+
+	string request;
+	char buf[1024];
+	while (request.find("\r\n\r\n") == string::npos && request.size() < MAX_REQUEST_SIZE) {
+		const ssize_t received = recv(conn_fd, buf, sizeof(buf), 0);
+		if (received < 0 && errno == EINTR) {
+			continue;
+		}
+		if (received <= 0) {
+			return;
+		}
+		request.append(buf, static_cast<size_t>(received));
+	}
+
+	// Request line looks like `GET /metrics HTTP/1.1`.
+	const auto line_end = request.find("\r\n");
+	const auto request_line = StringUtil::Split(request.substr(0, line_end), ' ');
+	const bool is_head = !request_line.empty() && request_line[0] == "HEAD";
+	const bool is_get = !request_line.empty() && request_line[0] == "GET";
+	const string path = request_line.size() > 1 ? request_line[1] : string();
+
+	string status_line;
+	string body;
+	if (!is_get && !is_head) {
+		status_line = "HTTP/1.1 405 Method Not Allowed";
+	} else if (path == "/metrics" || path == "/") {
+		status_line = "HTTP/1.1 200 OK";
+		body = MetricsExporter::RenderMetrics();
+	} else {
+		status_line = "HTTP/1.1 404 Not Found";
+	}
+	string response = status_line + "\r\n";
+	response += "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n";
+	response += "Content-Length: " + std::to_string(body.size()) + "\r\n";
+	response += "Connection: close\r\n\r\n";
+	if (!is_head) {
+		response += body;
+	}
+	SendAll(conn_fd, response);
+}
+
+// Split `<host>:<port>` endpoint, host could be a bracketed IPv6 address.
+void ParseHostPort(const string &endpoint, string &host, string &port) {
+	const auto colon = endpoint.rfind(':');
+	if (colon == string::npos || colon == 0 || colon + 1 == endpoint.size()) {
+		throw InvalidInputException(
+		    "curl_httpfs_metrics_endpoint should be `<host>:<port>` or `unix:<path>`, but got '%s'", endpoint);
+	}
+	host = endpoint.substr(0, colon);
+	port = endpoint.substr(colon + 1);
+	if (host.size() >= 2 && host.front() == '[' && host.back() == ']') {
+		host = host.substr(1, host.size() - 2);
+	}
+	for (char cur_char : port) {
+		if (cur_char < '0' || cur_char > '9') {
+			throw InvalidInputException("curl_httpfs_metrics_endpoint has invalid port '%s'", port);
+		}
+	}
+	if (port.size() > 5 || std::stoi(port) > 65535) {
+		throw InvalidInputException("curl_httpfs_metrics_endpoint has invalid port '%s'", port);
+	}
+}
+
+string GetErrnoMessage(const string &action, const string &endpoint) {
+	const int errnum = errno;
+	return StringUtil::Format("Failed to %s metrics endpoint '%s' with errno %d and error message %s", action,
+	                          endpoint, errnum, std::strerror(errnum));
+}
+
+} // namespace
+
+/*static*/ MetricsExporter &MetricsExporter::GetInstance() {
+	static auto *exporter = new MetricsExporter();
+	return *exporter;
+}
+
+/*static*/ string MetricsExporter::RenderMetrics() {
+	std::ostringstream out;
+	WriteRequestMetrics(out);
+	WriteEventLoopMetrics(out);
+	WriteLatencyMetrics(out);
+	return out.str();
+}
+
+void MetricsExporter::SetEndpoint(const string &endpoint) {
+	const std::lock_guard<std::mutex> lck(mu);
+	Stop();
+	if (endpoint.empty()) {
+		return;
+	}
+
+	int server_fd = -1;
+	string new_unix_socket_path;
+	string new_listen_address;
+	if (StringUtil::StartsWith(endpoint, UNIX_ENDPOINT_PREFIX)) {
+		new_unix_socket_path = endpoint.substr(std::strlen(UNIX_ENDPOINT_PREFIX));
+		struct sockaddr_un addr {};
+		if (new_unix_socket_path.empty() || new_unix_socket_path.size() >= sizeof(addr.sun_path)) {
+			throw InvalidInputException("curl_httpfs_metrics_endpoint has invalid Unix socket path '%s'",
+			                            new_unix_socket_path);
+		}
+		addr.sun_family = AF_UNIX;
+		new_unix_socket_path.copy(addr.sun_path, new_unix_socket_path.size());
+		// Socket file left by a previous process would fail the bind, other files are never removed.
+		struct stat file_stat {};
+		if (lstat(new_unix_socket_path.c_str(), &file_stat) == 0 && S_ISSOCK(file_stat.st_mode)) {
+			unlink(new_unix_socket_path.c_str());
+		}
+		server_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (server_fd < 0) {
+			throw IOException(GetErrnoMessage("create socket for", endpoint));
+		}
+		if (bind(server_fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0) {
+			const string err_msg = GetErrnoMessage("bind", endpoint);
+			close(server_fd);
+			throw IOException(err_msg);
+		}
+		new_listen_address = endpoint;
+	} else {
+		string host;
+		string port;
+		ParseHostPort(endpoint, host, port);
+		struct addrinfo hints {};
+		hints.ai_family = AF_UNSPEC;
+		hints.ai_socktype = SOCK_STREAM;
+		hints.ai_flags = AI_PASSIVE | AI_NUMERICSERV;
+		struct addrinfo *addrs = nullptr;
+		const int ret = getaddrinfo(host.c_str(), port.c_str(), &hints, &addrs);
+		if (ret != 0) {
+			throw IOException("Failed to resolve metrics endpoint '%s': %s", endpoint, gai_strerror(ret));
+		}
+		server_fd = socket(addrs->ai_family, addrs->ai_socktype, addrs->ai_protocol);
+		if (server_fd < 0) {
+			freeaddrinfo(addrs);
+			throw IOException(GetErrnoMessage("create socket for", endpoint));
+		}
+		const int one = 1;
+		setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+		const int bind_ret = bind(server_fd, addrs->ai_addr, addrs->ai_addrlen);
+		freeaddrinfo(addrs);
+		if (bind_ret < 0) {
+			const string err_msg = GetErrnoMessage("bind", endpoint);
+			close(server_fd);
+			throw IOException(err_msg);
+		}
+
+		// Report the bound port, which differs from the given one for port 0.
+		struct sockaddr_storage bound_addr {};
+		socklen_t bound_addr_len = sizeof(bound_addr);
+		getsockname(server_fd, reinterpret_cast<struct sockaddr *>(&bound_addr), &bound_addr_len);
+		char bound_host[INET6_ADDRSTRLEN] = {};
+		uint16_t bound_port = 0;
+		if (bound_addr.ss_family == AF_INET6) {
+			auto &addr6 = reinterpret_cast<struct sockaddr_in6 &>(bound_addr);
+			inet_ntop(AF_INET6, &addr6.sin6_addr, bound_host, sizeof(bound_host));
+			bound_port = ntohs(addr6.sin6_port);
+			new_listen_address = StringUtil::Format("[%s]:%d", bound_host, bound_port);
+		} else {
+			auto &addr4 = reinterpret_cast<struct sockaddr_in &>(bound_addr);
+			inet_ntop(AF_INET, &addr4.sin_addr, bound_host, sizeof(bound_host));
+			bound_port = ntohs(addr4.sin_port);
+			new_listen_address = StringUtil::Format("%s:%d", bound_host, bound_port);
+		}
+	}
+	fcntl(server_fd, F_SETFD, FD_CLOEXEC);
+
+	if (listen(server_fd, LISTEN_BACKLOG) < 0 || pipe(stop_pipe) < 0) {
+		const string err_msg = GetErrnoMessage("listen on", endpoint);
+		close(server_fd);
+		if (!new_unix_socket_path.empty()) {
+			unlink(new_unix_socket_path.c_str());
+		}
+		throw IOException(err_msg);
+	}
+	listen_fd = server_fd;
+	unix_socket_path = std::move(new_unix_socket_path);
+	listen_address = std::move(new_listen_address);
+	serve_thread = std::thread(&MetricsExporter::Serve, listen_fd, stop_pipe[0]);
+}
+
+string MetricsExporter::GetListenAddress() {
+	const std::lock_guard<std::mutex> lck(mu);
+	return listen_address;
+}
+
+void MetricsExporter::Stop() {
+	if (!serve_thread.joinable()) {
+		return;
+	}
+	const char stop_signal = 0;
+	while (write(stop_pipe[1], &stop_signal, 1) < 0 && errno == EINTR) {
+	}
+	serve_thread.join();
+	close(listen_fd);
+	close(stop_pipe[0]);
+	close(stop_pipe[1]);
+	listen_fd = -1;
+	stop_pipe[0] = -1;
+	stop_pipe[1] = -1;
+	if (!unix_socket_path.empty()) {
+		unlink(unix_socket_path.c_str());
+		unix_socket_path.clear();
+	}
+	listen_address.clear();
+}
+
+/*static*/ void MetricsExporter::Serve(int server_fd, int stop_fd) {
+	struct pollfd fds[2] {};
+	fds[0].fd = server_fd;
+	fds[0].events = POLLIN;
+	fds[1].fd = stop_fd;
+	fds[1].events = POLLIN;
+	while (true) {
+		const int ret = poll(fds, 2, /*timeout=*/-1);
+		if (ret < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return;
+		}
+		if (fds[1].revents != 0) {
+			return;
+		}
+		// The listener is broken, polling it again would return immediately forever.
+		if ((fds[0].revents & (POLLERR | POLLNVAL)) != 0) {
+			return;
+		}
+		if ((fds[0].revents & POLLIN) == 0) {
+			continue;
+		}
+		const int conn_fd = accept(server_fd, nullptr, nullptr);
+		if (conn_fd < 0) {
+			continue;
+		}
+		HandleConnection(conn_fd);
+		close(conn_fd);
+	}
+}
+
+} // namespace duckdb
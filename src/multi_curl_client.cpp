@@ -3,10 +3,17 @@
 #define CPPHTTPLIB_OPENSSL_SUPPORT
 
 #include <atomic>
+#include <chrono>
 #include <curl/curl.h>
 #include <sys/stat.h>
 
+#include "duckdb/common/exception.hpp"
 #include "duckdb/common/exception/http_exception.hpp"
+#include "client_context_registry.hpp"
+#include "curl_handle_pool.hpp"
+#include "extension_config.hpp"
+#include "http_metrics.hpp"
+#include "http_record_replay.hpp"
 #include "multi_curl_manager.hpp"
 
 namespace duckdb {
@@ -29,44 +36,6 @@ static std::string SelectCURLCertPath() {
 	return std::string();
 }
 
-static size_t RequestWriteCallback(void *contents, size_t size, size_t nmemb, void *userp) {
-	size_t total_size = size * nmemb;
-	std::string *str = static_cast<std::string *>(userp);
-	str->append(static_cast<char *>(contents), total_size);
-	return total_size;
-}
-
-static size_t RequestHeaderCallback(void *contents, size_t size, size_t nmemb, void *userp) {
-	size_t total_size = size * nmemb;
-	std::string header(static_cast<char *>(contents), total_size);
-	HeaderCollector *header_collection = static_cast<HeaderCollector *>(userp);
-
-	if (!header.empty() && header.back() == '\n') {
-		header.pop_back();
-		if (!header.empty() && header.back() == '\r') {
-			header.pop_back();
-		}
-	}
-
-	if (header.rfind("HTTP/", 0) == 0) {
-		header_collection->header_collection.push_back(HTTPHeaders());
-		header_collection->header_collection.back().Insert("__RESPONSE_STATUS__", header);
-	}
-
-	size_t colonPos = header.find(':');
-
-	if (colonPos != std::string::npos) {
-		std::string part1 = header.substr(0, colonPos);
-		std::string part2 = header.substr(colonPos + 1);
-		if (part2.at(0) == ' ') {
-			part2.erase(0, 1);
-		}
-		header_collection->header_collection.back().Insert(part1, part2);
-	}
-
-	return total_size;
-}
-
 } // namespace
 
 MultiCurlClient::MultiCurlClient(HTTPFSParams &http_params, const string &proto_host_port) {
@@ -80,6 +49,13 @@ void MultiCurlClient::Initialize(HTTPParams &http_p) {
 		bearer_token = http_params.bearer_token.c_str();
 	}
 	state = http_params.state;
+	if (http_params.state) {
+		client_context = ClientContextRegistry::GetInstance().Get(*http_params.state);
+	}
+	auto context = client_context.lock();
+	if (context != nullptr) {
+		profiling_state = context->registered_state->Get<HTTPProfilingState>(HTTPProfilingState::STATE_KEY);
+	}
 
 	InitCurlGlobal();
 
@@ -89,8 +65,7 @@ void MultiCurlClient::Initialize(HTTPParams &http_p) {
 	} else {
 		cert_file_path = SelectCURLCertPath();
 	}
-	curl = make_uniq<CURLHandle>(bearer_token, cert_file_path);
-	request_info = make_uniq<RequestInfo>();
+	auto curl = make_uniq<CURLHandle>(bearer_token, cert_file_path);
 
 	curl_easy_setopt(*curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2_0);
 	curl_easy_setopt(*curl, CURLOPT_FOLLOWLOCATION, 1L);
@@ -111,11 +86,6 @@ void MultiCurlClient::Initialize(HTTPParams &http_p) {
 	curl_easy_setopt(*curl, CURLOPT_CONNECTTIMEOUT, http_params.timeout);
 	curl_easy_setopt(*curl, CURLOPT_ACCEPT_ENCODING, "identity");
 
-	curl_easy_setopt(*curl, CURLOPT_HEADERFUNCTION, RequestHeaderCallback);
-	curl_easy_setopt(*curl, CURLOPT_HEADERDATA, &request_info->header_collection);
-	curl_easy_setopt(*curl, CURLOPT_WRITEFUNCTION, RequestWriteCallback);
-	curl_easy_setopt(*curl, CURLOPT_WRITEDATA, &request_info->body);
-
 	if (!http_params.http_proxy.empty()) {
 		curl_easy_setopt(*curl, CURLOPT_PROXY,
 		                 StringUtil::Format("%s:%s", http_params.http_proxy, http_params.http_proxy_port).c_str());
@@ -125,6 +95,9 @@ void MultiCurlClient::Initialize(HTTPParams &http_p) {
 			curl_easy_setopt(*curl, CURLOPT_PROXYPASSWORD, http_params.http_proxy_password.c_str());
 		}
 	}
+
+	// All options above are applied once, and cloned to the pooled handles.
+	curl_handle_pool = make_uniq<CurlHandlePool>(std::move(curl));
 }
 
 MultiCurlClient::~MultiCurlClient() {
@@ -139,14 +112,28 @@ unique_ptr<HTTPResponse> MultiCurlClient::Get(GetRequestInfo &info) {
 	auto curl_headers = TransformHeadersCurl(info.headers, info.params);
 	string url = info.url;
 
-	auto req = make_uniq<CurlRequest>(*curl);
+	auto curl = curl_handle_pool->Acquire();
+	auto req = make_uniq<CurlRequest>(curl->Get());
 	req->SetUrl(std::move(url));
 	req->SetHeaders(curl_headers.headers);
 	req->SetGetAttrs();
 
-	auto response = MultiCurlManager::GetInstance().HandleRequest(std::move(req));
-	if (state) {
-		state->total_bytes_received += response->body.size();
+	// Stream successful response body to the content handler as it arrives, so the whole body is never buffered.
+	CurlBodyStream body_stream;
+	// Recording needs the whole body, so it's buffered instead.
+	if (ENABLE_STREAMING_READ && info.content_handler && !HttpRecorder::GetInstance().IsRecording()) {
+		body_stream.response_handler = info.response_handler;
+		body_stream.content_handler = info.content_handler;
+		req->SetBodyStream(body_stream);
+	}
+
+	auto response = PerformRequest(std::move(req));
+	if (body_stream.exception) {
+		std::rethrow_exception(body_stream.exception);
+	}
+	// Handlers have already been invoked by the stream.
+	if (body_stream.response_handled) {
+		return response;
 	}
 	if (info.response_handler) {
 		if (!info.response_handler(*response)) {
@@ -162,25 +149,19 @@ unique_ptr<HTTPResponse> MultiCurlClient::Get(GetRequestInfo &info) {
 unique_ptr<HTTPResponse> MultiCurlClient::Put(PutRequestInfo &info) {
 	if (state) {
 		state->put_count++;
-		state->total_bytes_sent += info.buffer_in_len;
 	}
 
 	auto curl_headers = TransformHeadersCurl(info.headers, info.params);
 	curl_headers.Add("Content-Type: " + info.content_type);
-	request_info->url = info.url;
-
-	CURLcode res;
-	{
-		curl_easy_setopt(*curl, CURLOPT_URL, request_info->url.c_str());
-		curl_easy_setopt(*curl, CURLOPT_CUSTOMREQUEST, "PUT");
-		curl_easy_setopt(*curl, CURLOPT_POSTFIELDS, const_char_ptr_cast(info.buffer_in));
-		curl_easy_setopt(*curl, CURLOPT_POSTFIELDSIZE, info.buffer_in_len);
-		curl_easy_setopt(*curl, CURLOPT_HTTPHEADER, curl_headers ? curl_headers.headers : nullptr);
-		res = curl->Execute();
-	}
+	string url = info.url;
 
-	curl_easy_getinfo(*curl, CURLINFO_RESPONSE_CODE, &request_info->response_code);
-	return TransformResponseCurl(res);
+	auto curl = curl_handle_pool->Acquire();
+	auto req = make_uniq<CurlRequest>(curl->Get());
+	req->SetUrl(std::move(url));
+	req->SetHeaders(curl_headers.headers);
+	req->SetPutAttrs(info.buffer_in, info.buffer_in_len);
+
+	return PerformRequest(std::move(req));
 }
 
 unique_ptr<HTTPResponse> MultiCurlClient::Head(HeadRequestInfo &info) {
@@ -191,13 +172,13 @@ unique_ptr<HTTPResponse> MultiCurlClient::Head(HeadRequestInfo &info) {
 	auto curl_headers = TransformHeadersCurl(info.headers, info.params);
 	string url = info.url;
 
-	auto req = make_uniq<CurlRequest>(*curl);
+	auto curl = curl_handle_pool->Acquire();
+	auto req = make_uniq<CurlRequest>(curl->Get());
 	req->SetUrl(std::move(url));
 	req->SetHeaders(curl_headers.headers);
 	req->SetHeadAttrs();
 
-	auto response = MultiCurlManager::GetInstance().HandleRequest(std::move(req));
-	return response;
+	return PerformRequest(std::move(req));
 }
 
 unique_ptr<HTTPResponse> MultiCurlClient::Delete(DeleteRequestInfo &info) {
@@ -206,45 +187,105 @@ unique_ptr<HTTPResponse> MultiCurlClient::Delete(DeleteRequestInfo &info) {
 	}
 
 	auto curl_headers = TransformHeadersCurl(info.headers, info.params);
-	request_info->url = info.url;
-
-	CURLcode res;
-	{
-		curl_easy_setopt(*curl, CURLOPT_URL, request_info->url.c_str());
-		curl_easy_setopt(*curl, CURLOPT_CUSTOMREQUEST, "DELETE");
-		curl_easy_setopt(*curl, CURLOPT_FOLLOWLOCATION, 1L);
-		curl_easy_setopt(*curl, CURLOPT_HTTPHEADER, curl_headers ? curl_headers.headers : nullptr);
-		res = curl->Execute();
-	}
+	string url = info.url;
 
-	curl_easy_getinfo(*curl, CURLINFO_RESPONSE_CODE, &request_info->response_code);
-	return TransformResponseCurl(res);
+	auto curl = curl_handle_pool->Acquire();
+	auto req = make_uniq<CurlRequest>(curl->Get());
+	req->SetUrl(std::move(url));
+	req->SetHeaders(curl_headers.headers);
+	req->SetDeleteAttrs();
+
+	return PerformRequest(std::move(req));
 }
 
 unique_ptr<HTTPResponse> MultiCurlClient::Post(PostRequestInfo &info) {
 	if (state) {
 		state->post_count++;
-		state->total_bytes_sent += info.buffer_in_len;
 	}
 
 	auto curl_headers = TransformHeadersCurl(info.headers, info.params);
 	const string content_type = "Content-Type: application/octet-stream";
 	curl_headers.Add(content_type.c_str());
-	request_info->url = info.url;
-
-	CURLcode res;
-	{
-		curl_easy_setopt(*curl, CURLOPT_URL, request_info->url.c_str());
-		curl_easy_setopt(*curl, CURLOPT_POST, 1L);
-		curl_easy_setopt(*curl, CURLOPT_POSTFIELDS, const_char_ptr_cast(info.buffer_in));
-		curl_easy_setopt(*curl, CURLOPT_POSTFIELDSIZE, info.buffer_in_len);
-		curl_easy_setopt(*curl, CURLOPT_HTTPHEADER, curl_headers ? curl_headers.headers : nullptr);
-		res = curl->Execute();
+	string url = info.url;
+
+	auto curl = curl_handle_pool->Acquire();
+	auto req = make_uniq<CurlRequest>(curl->Get());
+	req->SetUrl(std::move(url));
+	req->SetHeaders(curl_headers.headers);
+	req->SetPostAttrs(info.buffer_in, info.buffer_in_len);
+
+	auto response = PerformRequest(std::move(req));
+	info.buffer_out = response->body;
+	return response;
+}
+
+unique_ptr<HTTPResponse> MultiCurlClient::PerformRequest(unique_ptr<CurlRequest> req) {
+	auto context = client_context.lock();
+	const auto wait_start = std::chrono::steady_clock::now();
+	auto &replayer = HttpReplayer::GetInstance();
+	if (replayer.IsReplaying()) {
+		CurlInterruptCheck interrupt_check;
+		if (context != nullptr) {
+			interrupt_check = [&context]() { return context->interrupted.load(); };
+		}
+		auto response = replayer.Replay(req->method, req->info->url, req->headers, interrupt_check);
+		RecordRequestStats(response->body.size(), /*bytes_sent=*/0, std::chrono::steady_clock::now() - wait_start);
+		if (context != nullptr && context->interrupted) {
+			throw InterruptException();
+		}
+		return response;
+	}
+
+	const uint64_t deadline_ms = REQUEST_DEADLINE_MS.load();
+	if (deadline_ms > 0) {
+		req->SetDeadline(std::chrono::steady_clock::now() + std::chrono::milliseconds(deadline_ms));
+	}
+
+	// The easy handle and headers are owned by the caller and outlive the request, so they stay valid after completion.
+	CURL *easy_curl = req->easy_curl;
+	const curl_slist *headers = req->headers;
+	const char *method = req->method;
+	auto &recorder = HttpRecorder::GetInstance();
+	const string url = recorder.IsRecording() ? req->info->url : string();
+	unique_ptr<HTTPResponse> response;
+	if (context == nullptr) {
+		response = MultiCurlManager::GetInstance().HandleRequest(std::move(req));
+	} else {
+		response = MultiCurlManager::GetInstance().HandleRequest(
+		    std::move(req), [&context]() { return context->interrupted.load(); });
+	}
+	const auto wait_time = std::chrono::steady_clock::now() - wait_start;
+
+	// Count bytes actually transferred, which covers streamed body, and failed or partial transfers of every method.
+	curl_off_t bytes_received = 0;
+	curl_off_t bytes_sent = 0;
+	curl_easy_getinfo(easy_curl, CURLINFO_SIZE_DOWNLOAD_T, &bytes_received);
+	curl_easy_getinfo(easy_curl, CURLINFO_SIZE_UPLOAD_T, &bytes_sent);
+	RecordRequestStats(static_cast<uint64_t>(bytes_received), static_cast<uint64_t>(bytes_sent), wait_time);
+	// Recording could have been started meanwhile, in which case the URL isn't captured.
+	if (!url.empty() && recorder.IsRecording()) {
+		recorder.Record(method, url, headers, *response, wait_time);
+	}
+	if (context == nullptr) {
+		return response;
+	}
+	// The request has been cancelled, or completed right before cancellation; either way the query is aborted.
+	if (context->interrupted) {
+		throw InterruptException();
 	}
+	return response;
+}
 
-	curl_easy_getinfo(*curl, CURLINFO_RESPONSE_CODE, &request_info->response_code);
-	info.buffer_out = request_info->body;
-	return TransformResponseCurl(res);
+void MultiCurlClient::RecordRequestStats(uint64_t bytes_received, uint64_t bytes_sent,
+                                         std::chrono::nanoseconds wait_time) {
+	HttpMetrics::GetInstance().RecordWait(std::chrono::duration_cast<std::chrono::microseconds>(wait_time).count());
+	if (state) {
+		state->total_bytes_received += static_cast<idx_t>(bytes_received);
+		state->total_bytes_sent += static_cast<idx_t>(bytes_sent);
+	}
+	if (profiling_state) {
+		profiling_state->RecordRequest(wait_time, bytes_received, bytes_sent);
+	}
 }
 
 CURLRequestHeaders MultiCurlClient::TransformHeadersCurl(const HTTPHeaders &header_map, const HTTPParams &params) {
@@ -267,36 +308,6 @@ CURLRequestHeaders MultiCurlClient::TransformHeadersCurl(const HTTPHeaders &head
 	return curl_headers;
 }
 
-void MultiCurlClient::ResetRequestInfo() {
-	request_info->header_collection.clear();
-	request_info->body = "";
-	request_info->url = "";
-	request_info->response_code = 0;
-}
-
-unique_ptr<HTTPResponse> MultiCurlClient::TransformResponseCurl(CURLcode res) {
-	auto status_code = HTTPStatusCode(request_info->response_code);
-	auto response = make_uniq<HTTPResponse>(status_code);
-	if (res != CURLcode::CURLE_OK) {
-		if (!request_info->header_collection.empty() &&
-		    request_info->header_collection.back().HasHeader("__RESPONSE_STATUS__")) {
-			response->request_error = request_info->header_collection.back().GetHeaderValue("__RESPONSE_STATUS__");
-		} else {
-			response->request_error = curl_easy_strerror(res);
-		}
-		return response;
-	}
-	response->body = request_info->body;
-	response->url = request_info->url;
-	if (!request_info->header_collection.empty()) {
-		for (auto &header : request_info->header_collection.back()) {
-			response->headers.Insert(header.first, header.second);
-		}
-	}
-	ResetRequestInfo();
-	return response;
-}
-
 void MultiCurlClient::InitCurlGlobal() {
 	std::call_once(multi_curl_client_flag, []() { curl_global_init(CURL_GLOBAL_DEFAULT); });
 }
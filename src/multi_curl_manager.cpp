@@ -1,15 +1,28 @@
 #include "multi_curl_manager.hpp"
 
+#include <algorithm>
 #include <array>
+#include <chrono>
 #include <cstring>
+#include <future>
+#include <limits>
 #include <unistd.h>
 
+#include "credential_redaction.hpp"
+#include "curl_transfer_info.hpp"
 #include "duckdb/common/helper.hpp"
 #include "duckdb/common/unique_ptr.hpp"
+#include "extension_config.hpp"
+#include "http_metrics.hpp"
+#include "request_trace.hpp"
+#include "slow_request_log.hpp"
 #include "syscall_macros.hpp"
+#include "thread_utils.hpp"
+#include "time_utils.hpp"
 
 // Platform headers
 #ifdef __linux__
+#include <poll.h>
 #include <sys/epoll.h>
 #include <sys/eventfd.h>
 #include <sys/timerfd.h>
@@ -22,17 +35,163 @@ namespace duckdb {
 
 namespace {
 
-// Max number of TCP connections established per host.
-constexpr long DEFAULT_MAX_CONN_PER_HOST = 8;
+// Number of CPU cores served by one eventloop by default.
+constexpr int CPU_CORES_PER_EVENT_LOOP = 8;
+
+#ifdef __linux__
+// Number of io_uring submission entries, the ring is flushed earlier when full.
+constexpr uint32_t IO_URING_ENTRIES = 256;
+// User data for io_uring requests not bound to sockets, which never collides with socket info addresses.
+constexpr uint64_t IO_URING_EVENT_FD_READ = 1;
+constexpr uint64_t IO_URING_POLL_REMOVE = 2;
+#endif
+
+// Max time to wait for an eventloop to take snapshot of requests in flight.
+constexpr auto INFLIGHT_SNAPSHOT_TIMEOUT = std::chrono::milliseconds(1000);
+// Request errors for requests terminated by the eventloop.
+constexpr const char *REQUEST_CANCELLED_ERROR = "Request cancelled";
+constexpr const char *REQUEST_DEADLINE_EXCEEDED_ERROR = "Request deadline exceeded";
 
 struct SockInfo {
 	curl_socket_t sockfd = 0;
 	CURL *easy = nullptr;
 	int action = 0;
+	// Events registered to the polling engine.
+	uint32_t events = 0;
 	GlobalInfo *global = nullptr;
 };
 
+// Record timeline of the given traced request, which is finishing with the given response.
+void TraceRequestCompletion(const CurlRequest &req, const CurlTransferInfo &info, const HTTPResponse &resp) {
+	RequestTraceRecord record;
+	record.kind = RequestTraceRecord::Kind::COMPLETION;
+	record.trace_id = req.trace_id;
+	record.caller_thread_id = req.caller_thread_id;
+	record.status_code = static_cast<uint16_t>(resp.status);
+	record.failed = resp.HasRequestError();
+	record.submit_ns = ToSteadyNs(req.submit_time);
+	record.add_ns = ToSteadyNs(req.add_time);
+	record.complete_ns = GetSteadyNowNs();
+	RequestTraceRecord::SetString(record.method, req.method);
+	RequestTraceRecord::SetString(record.url, RedactUrlCredentials(req.info->url));
+	RequestTraceRecord::SetString(record.range, req.range);
+
+	// Curl timings are relative to the start of the transfer, which is derived from total time.
+	record.bytes_received = static_cast<uint64_t>(info.bytes_received);
+	record.start_ns = std::max(record.complete_ns - info.total_us * 1000, record.add_ns);
+	auto to_timestamp = [&record](curl_off_t offset_us) {
+		return offset_us > 0 ? record.start_ns + offset_us * 1000 : 0;
+	};
+	record.namelookup_ns = to_timestamp(info.namelookup_us);
+	record.connect_ns = to_timestamp(info.connect_us);
+	record.appconnect_ns = to_timestamp(info.appconnect_us);
+	record.first_byte_ns = to_timestamp(info.starttransfer_us);
+	RequestTrace::GetInstance().Append(record);
+}
+
+// Record the given request into the slow request log if it has taken longer than the threshold.
+void RecordSlowRequest(const CurlRequest &req, const CurlTransferInfo &info, const HTTPResponse &resp) {
+	const uint64_t threshold_ms = SLOW_REQUEST_THRESHOLD_MS.load(std::memory_order_relaxed);
+	if (threshold_ms == 0) {
+		return;
+	}
+	const auto now = std::chrono::steady_clock::now();
+	const auto total_us = std::chrono::duration_cast<std::chrono::microseconds>(now - req.submit_time).count();
+	if (total_us < static_cast<int64_t>(threshold_ms) * 1000) {
+		return;
+	}
+
+	SlowRequestEntry entry;
+	entry.timestamp_us = GetSystemNowUs();
+	entry.method = req.method;
+	entry.url = RedactUrlCredentials(req.info->url);
+	entry.range = req.range;
+	entry.status_code = static_cast<uint16_t>(resp.status);
+	if (resp.HasRequestError()) {
+		entry.request_error = resp.request_error;
+	}
+	entry.SetTransferInfo(info);
+	entry.queue_us = static_cast<uint64_t>(
+	    std::chrono::duration_cast<std::chrono::microseconds>(req.add_time - req.submit_time).count());
+	entry.total_us = static_cast<uint64_t>(total_us);
+	SlowRequestLog::GetInstance().Append(std::move(entry));
+}
+
+// Detach the given easy handle from multi handle, and deliver response to the request's completion. [`info`] is the
+// transfer info read right before.
+void FinishRequest(GlobalInfo *g, CURL *easy, const CurlTransferInfo &info, unique_ptr<HTTPResponse> resp) {
+	// Detach easy handle before completion, since it could be reused for another request right after.
+	curl_multi_remove_handle(g->multi, easy);
+	auto iter = g->ongoing_requests.find(easy);
+	ALWAYS_ASSERT(iter != g->ongoing_requests.end());
+	auto completed_request = std::move(iter->second);
+	g->ongoing_requests.erase(iter);
+	g->ongoing_request_ids.erase(completed_request->request_id);
+	if (completed_request->HasDeadline()) {
+		g->deadlines.Remove(ToSteadyMsCeil(completed_request->deadline), completed_request->request_id);
+	}
+	HttpMetrics::GetInstance().RecordRequest(GetHttpMethod(completed_request->method),
+	                                         resp->HasRequestError() ? 0 : static_cast<uint16_t>(resp->status));
+	if (completed_request->trace_id != 0) {
+		TraceRequestCompletion(*completed_request, info, *resp);
+	}
+	RecordSlowRequest(*completed_request, info, *resp);
+	if (completed_request->completion_slot != nullptr) {
+		auto *slot = completed_request->completion_slot;
+		if (slot->Complete(std::move(resp))) {
+			g->slots_to_wake.emplace_back(slot);
+		}
+	} else {
+		completed_request->completion_callback(std::move(resp));
+	}
+}
+
+// Waiters are woken up after all responses are published, so a pass completing many transfers doesn't interleave
+// wakeup syscalls with response construction; waiters which haven't parked yet pick up responses without any.
+void WakeParkedWaiters(GlobalInfo *g) {
+	for (auto *cur_slot : g->slots_to_wake) {
+		cur_slot->Wake();
+	}
+	g->slots_to_wake.clear();
+}
+
+// Abort the ongoing request with the given id, which completes with the given request error.
+// Return whether the request is still ongoing.
+bool TerminateRequest(GlobalInfo *g, uint64_t request_id, const char *request_error) {
+	auto id_iter = g->ongoing_request_ids.find(request_id);
+	if (id_iter == g->ongoing_request_ids.end()) {
+		return false;
+	}
+	CURL *easy = id_iter->second;
+	auto &req = g->ongoing_requests.at(easy);
+	const HTTPStatusCode status_code = HTTPUtil::ToStatusCode(0);
+	auto resp = make_uniq<HTTPResponse>(status_code);
+	resp->url = req->info->url;
+	resp->reason = HTTPUtil::GetStatusMessage(status_code);
+	resp->request_error = request_error;
+	// Removing an unfinished transfer closes its connection, which frees up the connection slot for the host.
+	FinishRequest(g, easy, CurlTransferInfo::Read(easy), std::move(resp));
+	return true;
+}
+
+// Assign trace id to the given request if it doesn't have one.
+void AssignTraceId(CurlRequest &request) {
+	if (request.trace_id == 0) {
+		request.trace_id = RequestTrace::GetInstance().NextTraceId();
+		request.caller_thread_id = RequestTrace::GetCurrentThreadId();
+	}
+}
+
+// Drive curl with the given socket action, and record time spent inside.
+void SocketAction(GlobalInfo *g, curl_socket_t fd, int action) {
+	const int64_t start_ns = GetSteadyNowNs();
+	curl_multi_socket_action(g->multi, fd, action, &g->still_running);
+	EventLoopStats::Add(g->stats.socket_action_calls, 1);
+	EventLoopStats::Add(g->stats.socket_action_ns, static_cast<uint64_t>(GetSteadyNowNs() - start_ns));
+}
+
 void CheckMulti(GlobalInfo *g) {
+	const int64_t start_ns = GetSteadyNowNs();
 	CURLMsg *msg = nullptr;
 	int msgs_left = 0;
 
@@ -49,35 +208,23 @@ void CheckMulti(GlobalInfo *g) {
 		req->info->response_code = static_cast<uint16_t>(response_code);
 
 		const CURLcode res = msg->data.result;
-		HTTPStatusCode status_code = HTTPUtil::ToStatusCode(req->info->response_code);
-		auto resp = make_uniq<HTTPResponse>(status_code);
-		resp->url = req->info->url;
-		resp->reason = HTTPUtil::GetStatusMessage(status_code);
-		if (res != CURLcode::CURLE_OK) {
-			if (!req->info->header_collection.empty() &&
-			    req->info->header_collection.back().HasHeader("__RESPONSE_STATUS__")) {
-				resp->request_error = req->info->header_collection.back().GetHeaderValue("__RESPONSE_STATUS__");
-			} else {
-				resp->request_error = curl_easy_strerror(res);
-			}
-		} else {
-			resp->body = std::move(req->info->body);
-			if (!req->info->header_collection.empty()) {
-				for (auto &header : req->info->header_collection.back()) {
-					if (header.first == "__RESPONSE_STATUS__") {
-						continue;
-					}
-					resp->headers.Insert(header.first, header.second);
-				}
-			}
+		const auto info = CurlTransferInfo::Read(easy);
+		// Connections are opened and reused by failed transfers as well.
+		g->host_connection_stats.Get(req->host).Record(info, res);
+
+		auto resp = req->BuildResponse(res);
+		if (res == CURLcode::CURLE_OK) {
+			// Only successful transfers are recorded, phases of failed ones are incomplete.
+			g->host_latencies.Get(req->host).Record(info);
 		}
-		req->response.set_value(std::move(resp));
+		// Transfer info is only valid for transfers run by curl, so it's not recorded for terminated requests.
+		HttpMetrics::GetInstance().RecordTransfer(GetHttpMethod(req->method), info, res);
 
-		curl_multi_remove_handle(g->multi, easy);
-		auto iter = g->ongoing_requests.find(easy);
-		ALWAYS_ASSERT(iter != g->ongoing_requests.end());
-		g->ongoing_requests.erase(iter);
+		FinishRequest(g, easy, info, std::move(resp));
 	}
+	WakeParkedWaiters(g);
+	EventLoopStats::Add(g->stats.check_multi_calls, 1);
+	EventLoopStats::Add(g->stats.check_multi_ns, static_cast<uint64_t>(GetSteadyNowNs() - start_ns));
 }
 
 #ifdef __linux__
@@ -86,16 +233,20 @@ void TimerCallback(GlobalInfo *g, int revents) {
 	uint64_t count = 0;
 	// Epoll leverages reactor model, need to read active bytes out.
 	const int bytes_read = read(g->timer_fd, &count, sizeof(uint64_t));
+	// The timer could be re-armed by events processed earlier in the same epoll batch, which resets expiration.
+	if (bytes_read < 0 && errno == EAGAIN) {
+		return;
+	}
 	ALWAYS_ASSERT(bytes_read == sizeof(uint64_t));
 
-	curl_multi_socket_action(g->multi, CURL_SOCKET_TIMEOUT, 0, &g->still_running);
+	SocketAction(g, CURL_SOCKET_TIMEOUT, 0);
 	CheckMulti(g);
 }
 
 void EventCallback(GlobalInfo *g, int fd, int revents) {
 	int action = ((revents & EPOLLIN) ? CURL_CSELECT_IN : 0) | ((revents & EPOLLOUT) ? CURL_CSELECT_OUT : 0);
 
-	curl_multi_socket_action(g->multi, fd, action, &g->still_running);
+	SocketAction(g, fd, action);
 	CheckMulti(g);
 
 	if (g->still_running <= 0) {
@@ -116,22 +267,56 @@ void RemoveSockInfo(SockInfo *f, GlobalInfo *g) {
 	delete f;
 }
 
+// Register the socket to epoll. On failure the socket is left unregistered, so the next update of the same socket
+// retries registration instead of being skipped as unchanged; meanwhile the request only progresses on curl timeouts.
+void AddToEpoll(SockInfo *f, curl_socket_t s, struct epoll_event &ev, GlobalInfo *g) {
+	const int ret = epoll_ctl(g->epoll_fd, EPOLL_CTL_ADD, s, &ev);
+	SYSCALL_LOG_IF_ERROR(ret);
+	if (ret < 0) {
+		f->sockfd = 0;
+		f->events = 0;
+	}
+}
+
 void SetSockInfo(SockInfo *f, curl_socket_t s, CURL *e, int act, GlobalInfo *g) {
+	uint32_t kind = ((act & CURL_POLL_IN) ? EPOLLIN : 0) | ((act & CURL_POLL_OUT) ? EPOLLOUT : 0);
+	if (ENABLE_EPOLL_EDGE_TRIGGERED) {
+		kind |= EPOLLET;
+	}
+	f->easy = e;
+	f->action = act;
+
+	// Nothing changed for the registered socket, skip the syscall.
+	if (f->sockfd == s && f->events == kind) {
+		return;
+	}
+
 	struct epoll_event ev;
-	int kind = ((act & CURL_POLL_IN) ? EPOLLIN : 0) | ((act & CURL_POLL_OUT) ? EPOLLOUT : 0);
+	ev.events = kind;
+	ev.data.fd = s;
 
-	if (f->sockfd) {
-		const int ret = epoll_ctl(g->epoll_fd, EPOLL_CTL_DEL, f->sockfd, NULL);
+	// Modify the registration in place if the socket is already registered.
+	if (f->sockfd == s) {
+		f->events = kind;
+		const int ret = epoll_ctl(g->epoll_fd, EPOLL_CTL_MOD, s, &ev);
+		// Fallback to re-register if the socket has been implicitly removed from epoll, which happens when the file
+		// description is closed and the fd number reused.
+		if (ret < 0 && errno == ENOENT) {
+			AddToEpoll(f, s, ev, g);
+			return;
+		}
 		SYSCALL_THROW_IF_ERROR(ret);
+		return;
 	}
 
+	// Socket changed, which rarely happens, re-register the new one.
+	if (f->sockfd != 0) {
+		const int ret = epoll_ctl(g->epoll_fd, EPOLL_CTL_DEL, f->sockfd, NULL);
+		SYSCALL_THROW_IF_ERROR(ret);
+	}
 	f->sockfd = s;
-	f->action = act;
-	f->easy = e;
-
-	ev.events = kind;
-	ev.data.fd = s;
-	epoll_ctl(g->epoll_fd, EPOLL_CTL_ADD, s, &ev);
+	f->events = kind;
+	AddToEpoll(f, s, ev, g);
 }
 
 void AddSockInfo(curl_socket_t s, CURL *easy, int action, GlobalInfo *g) {
@@ -178,6 +363,122 @@ int MultiTimerCallback(CURLM *multi, long timeout_ms, GlobalInfo *g) {
 	return 0;
 }
 
+// io_uring backend.
+//
+// Polls are one-shot, and re-armed after curl handles the readiness; a socket info is referenced by its in-flight poll
+// via user data, so it's only released after the poll completes.
+
+struct UringSockInfo {
+	curl_socket_t sockfd = 0;
+	// Latest action requested by curl.
+	int action = 0;
+	// Poll mask of the in-flight poll.
+	uint32_t poll_mask = 0;
+	bool poll_in_flight = false;
+	bool cancel_in_flight = false;
+	// Whether curl is handling readiness of the socket, during which it could be updated or removed.
+	bool dispatching = false;
+	// Whether curl has removed the socket.
+	bool removed = false;
+};
+
+uint32_t ToPollMask(int action) {
+	return ((action & CURL_POLL_IN) ? POLLIN : 0) | ((action & CURL_POLL_OUT) ? POLLOUT : 0);
+}
+
+void UringArmPoll(UringSockInfo *f, GlobalInfo *g) {
+	if (f->removed || f->poll_in_flight || f->dispatching) {
+		return;
+	}
+	const uint32_t poll_mask = ToPollMask(f->action);
+	if (poll_mask == 0) {
+		return;
+	}
+	g->io_uring->PrepPollAdd(f->sockfd, poll_mask, reinterpret_cast<uint64_t>(f));
+	f->poll_mask = poll_mask;
+	f->poll_in_flight = true;
+}
+
+void UringCancelPoll(UringSockInfo *f, GlobalInfo *g) {
+	if (f->cancel_in_flight) {
+		return;
+	}
+	// Cancellation is processed in submission order, so it never hits a poll re-armed afterwards.
+	g->io_uring->PrepPollRemove(reinterpret_cast<uint64_t>(f), IO_URING_POLL_REMOVE);
+	f->cancel_in_flight = true;
+}
+
+int UringSocketCallback(CURL *e, curl_socket_t s, int what, void *cbp, void *sockp) {
+	auto *g = static_cast<GlobalInfo *>(cbp);
+	auto *f = static_cast<UringSockInfo *>(sockp);
+
+	if (what == CURL_POLL_REMOVE) {
+		if (f == nullptr) {
+			return 0;
+		}
+		f->removed = true;
+		// Released on poll completion or after dispatching.
+		if (f->poll_in_flight) {
+			UringCancelPoll(f, g);
+		} else if (!f->dispatching) {
+			delete f;
+		}
+		return 0;
+	}
+
+	if (f == nullptr) {
+		f = new UringSockInfo();
+		f->sockfd = s;
+		curl_multi_assign(g->multi, s, f);
+	}
+	f->action = what;
+	if (f->poll_in_flight) {
+		if (f->poll_mask != ToPollMask(what)) {
+			UringCancelPoll(f, g);
+		}
+		return 0;
+	}
+	UringArmPoll(f, g);
+	return 0;
+}
+
+int UringTimerCallback(CURLM *multi, long timeout_ms, GlobalInfo *g) {
+	if (timeout_ms < 0) {
+		g->timeout_deadline_ns = -1;
+		return 0;
+	}
+	g->timeout_deadline_ns = GetSteadyNowNs() + static_cast<int64_t>(timeout_ms) * 1000 * 1000;
+	return 0;
+}
+
+void UringPollCallback(UringSockInfo *f, int32_t res, GlobalInfo *g) {
+	f->poll_in_flight = false;
+	f->cancel_in_flight = false;
+
+	// Cancelled polls are re-armed with the latest mask below.
+	if (!f->removed && res != -ECANCELED) {
+		int action = 0;
+		if (res < 0) {
+			action = CURL_CSELECT_ERR;
+		} else {
+			action = ((res & POLLIN) ? CURL_CSELECT_IN : 0) | ((res & POLLOUT) ? CURL_CSELECT_OUT : 0) |
+			         ((res & (POLLERR | POLLHUP)) ? CURL_CSELECT_ERR : 0);
+		}
+		// Completing transfers could close connections and remove this socket, so keep dispatching until done; the
+		// socket is then only released below.
+		f->dispatching = true;
+		SocketAction(g, f->sockfd, action);
+		CheckMulti(g);
+		f->dispatching = false;
+	}
+
+	if (f->removed) {
+		delete f;
+		return;
+	}
+	UringArmPoll(f, g);
+}
+
 #elif defined(__APPLE__)
 
 void EventCallback(GlobalInfo *g, int fd, int filter) {
@@ -188,7 +489,7 @@ void EventCallback(GlobalInfo *g, int fd, int filter) {
 	if (filter == EVFILT_WRITE) {
 		action |= CURL_CSELECT_OUT;
 	}
-	curl_multi_socket_action(g->multi, fd, action, &g->still_running);
+	SocketAction(g, fd, action);
 	CheckMulti(g);
 }
 
@@ -206,16 +507,18 @@ void RemoveSockInfo(SockInfo *f, GlobalInfo *g) {
 }
 
 void SetSockInfo(SockInfo *f, curl_socket_t s, CURL *e, int act, GlobalInfo *g) {
+	// Filters registered before, which are to be updated in one kevent call.
+	const int old_act = f->sockfd == s ? f->action : 0;
 	f->sockfd = s;
 	f->action = act;
 	f->easy = e;
 	struct kevent ev[2];
 	int n = 0;
-	if (act & CURL_POLL_IN) {
-		EV_SET(&ev[n++], s, EVFILT_READ, EV_ADD | EV_ENABLE, 0, 0, nullptr);
+	if ((act & CURL_POLL_IN) != (old_act & CURL_POLL_IN)) {
+		EV_SET(&ev[n++], s, EVFILT_READ, (act & CURL_POLL_IN) ? (EV_ADD | EV_ENABLE) : EV_DELETE, 0, 0, nullptr);
 	}
-	if (act & CURL_POLL_OUT) {
-		EV_SET(&ev[n++], s, EVFILT_WRITE, EV_ADD | EV_ENABLE, 0, 0, nullptr);
+	if ((act & CURL_POLL_OUT) != (old_act & CURL_POLL_OUT)) {
+		EV_SET(&ev[n++], s, EVFILT_WRITE, (act & CURL_POLL_OUT) ? (EV_ADD | EV_ENABLE) : EV_DELETE, 0, 0, nullptr);
 	}
 	if (n > 0) {
 		kevent(g->kq_fd, ev, n, nullptr, 0, nullptr);
@@ -261,46 +564,53 @@ int MultiTimerCallback(CURLM *multi, long timeout_ms, GlobalInfo *g) {
 
 } // namespace
 
-/*static*/ MultiCurlManager &MultiCurlManager::GetInstance() {
-	static auto *manager = new MultiCurlManager();
-	return *manager;
-}
-
-MultiCurlManager::MultiCurlManager() : global_info(make_uniq<GlobalInfo>()) {
+CurlEventLoop::CurlEventLoop(EventLoopBackend backend) : global_info(make_uniq<GlobalInfo>()) {
 #ifdef __linux__
-	int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
-	SYSCALL_EXIT_IF_ERROR(epoll_fd);
+	if (backend == EventLoopBackend::IO_URING) {
+		global_info->io_uring = IoUring::Create(IO_URING_ENTRIES);
+	}
 
-	// Create timerfd and add to epoll.
-	//
-	// Use CLOCK_BOOTTIME instead of CLOCK_MONOTONIC, since the former considers system suspension time.
-	int timer_fd = timerfd_create(CLOCK_BOOTTIME, TFD_NONBLOCK | TFD_CLOEXEC);
-	SYSCALL_EXIT_IF_ERROR(timer_fd);
+	// io_uring handles socket polls, curl timeout and eventfd all by itself.
+	if (global_info->io_uring != nullptr) {
+		// Eventfd is read via io_uring, which parks the read request until wakeup if the eventfd is blocking.
+		int event_fd = eventfd(0, EFD_CLOEXEC);
+		SYSCALL_EXIT_IF_ERROR(event_fd);
+		global_info->event_fd = event_fd;
+	} else {
+		int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+		SYSCALL_EXIT_IF_ERROR(epoll_fd);
 
-	struct itimerspec its;
-	memset(&its, 0, sizeof(its));
-	its.it_value.tv_sec = 1;
-	timerfd_settime(timer_fd, 0, &its, NULL);
+		// Create timerfd and add to epoll.
+		//
+		// Use CLOCK_BOOTTIME instead of CLOCK_MONOTONIC, since the former considers system suspension time.
+		int timer_fd = timerfd_create(CLOCK_BOOTTIME, TFD_NONBLOCK | TFD_CLOEXEC);
+		SYSCALL_EXIT_IF_ERROR(timer_fd);
 
-	struct epoll_event ev;
-	ev.events = EPOLLIN;
-	ev.data.fd = timer_fd;
-	int ret = epoll_ctl(epoll_fd, EPOLL_CTL_ADD, timer_fd, &ev);
-	SYSCALL_EXIT_IF_ERROR(ret);
+		struct itimerspec its;
+		memset(&its, 0, sizeof(its));
+		its.it_value.tv_sec = 1;
+		timerfd_settime(timer_fd, 0, &its, NULL);
+
+		struct epoll_event ev;
+		ev.events = EPOLLIN;
+		ev.data.fd = timer_fd;
+		int ret = epoll_ctl(epoll_fd, EPOLL_CTL_ADD, timer_fd, &ev);
+		SYSCALL_EXIT_IF_ERROR(ret);
 
-	// Create eventfd and add to epoll.
-	int event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
-	SYSCALL_EXIT_IF_ERROR(event_fd);
+		// Create eventfd and add to epoll.
+		int event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+		SYSCALL_EXIT_IF_ERROR(event_fd);
 
-	ev.events = EPOLLIN;
-	ev.data.fd = event_fd;
-	ret = epoll_ctl(epoll_fd, EPOLL_CTL_ADD, event_fd, &ev);
-	SYSCALL_EXIT_IF_ERROR(ret);
+		ev.events = EPOLLIN;
+		ev.data.fd = event_fd;
+		ret = epoll_ctl(epoll_fd, EPOLL_CTL_ADD, event_fd, &ev);
+		SYSCALL_EXIT_IF_ERROR(ret);
 
-	// Assign global info.
-	global_info->epoll_fd = epoll_fd;
-	global_info->timer_fd = timer_fd;
-	global_info->event_fd = event_fd;
+		// Assign global info.
+		global_info->epoll_fd = epoll_fd;
+		global_info->timer_fd = timer_fd;
+		global_info->event_fd = event_fd;
+	}
 
 	// Create and initialize multi-curl.
 #elif defined(__APPLE__)
@@ -318,26 +628,118 @@ MultiCurlManager::MultiCurlManager() : global_info(make_uniq<GlobalInfo>()) {
 	global_info->multi = curl_multi_init();
 	// IO multiplexing requires HTTP/2 or HTTP/3.
 	curl_multi_setopt(global_info->multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
-	curl_multi_setopt(global_info->multi, CURLMOPT_MAX_HOST_CONNECTIONS, DEFAULT_MAX_CONN_PER_HOST);
+	ApplyConnectionLimits();
 	curl_multi_setopt(global_info->multi, CURLMOPT_SOCKETFUNCTION, SocketCallback);
 	curl_multi_setopt(global_info->multi, CURLMOPT_SOCKETDATA, global_info.get());
 	curl_multi_setopt(global_info->multi, CURLMOPT_TIMERFUNCTION, MultiTimerCallback);
 	curl_multi_setopt(global_info->multi, CURLMOPT_TIMERDATA, global_info.get());
+#ifdef __linux__
+	if (global_info->io_uring != nullptr) {
+		curl_multi_setopt(global_info->multi, CURLMOPT_SOCKETFUNCTION, UringSocketCallback);
+		curl_multi_setopt(global_info->multi, CURLMOPT_TIMERFUNCTION, UringTimerCallback);
+	}
+#endif
 
 	bkg_thread = std::thread([this]() { HandleEvent(); });
 }
 
-void MultiCurlManager::HandleEvent() {
+EventLoopBackend CurlEventLoop::GetBackend() const {
 #ifdef __linux__
+	if (global_info->io_uring != nullptr) {
+		return EventLoopBackend::IO_URING;
+	}
+#endif
+	return EventLoopBackend::EPOLL;
+}
+
+EventLoopStatsSnapshot CurlEventLoop::GetStats() const {
+	const auto &stats = global_info->stats;
+	EventLoopStatsSnapshot snapshot;
+	snapshot.backend = GetBackend();
+	snapshot.uptime_ns = static_cast<uint64_t>(
+	    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - stats.start_time)
+	        .count());
+	// Request ids are assigned sequentially from 1 on submission.
+	const uint64_t submitted_requests = next_request_id.load(std::memory_order_relaxed) - 1;
+	const uint64_t dequeued_requests = stats.dequeued_requests.load(std::memory_order_relaxed);
+	snapshot.pending_requests = submitted_requests > dequeued_requests ? submitted_requests - dequeued_requests : 0;
+	snapshot.queue_wait = stats.queue_wait.GetSnapshot();
+	snapshot.ongoing_requests = stats.ongoing_requests.load(std::memory_order_relaxed);
+	snapshot.still_running = stats.still_running.load(std::memory_order_relaxed);
+	snapshot.pending_deadlines = stats.pending_deadlines.load(std::memory_order_relaxed);
+	snapshot.wakeups = stats.wakeups.load(std::memory_order_relaxed);
+	snapshot.events = stats.events.load(std::memory_order_relaxed);
+	snapshot.socket_action_calls = stats.socket_action_calls.load(std::memory_order_relaxed);
+	snapshot.socket_action_ns = stats.socket_action_ns.load(std::memory_order_relaxed);
+	snapshot.check_multi_calls = stats.check_multi_calls.load(std::memory_order_relaxed);
+	snapshot.check_multi_ns = stats.check_multi_ns.load(std::memory_order_relaxed);
+	return snapshot;
+}
+
+#ifdef __linux__
+void CurlEventLoop::HandleIoUringEvent() {
+	auto *g = global_info.get();
+	auto &ring = *g->io_uring;
+	ring.PrepRead(g->event_fd, &g->event_fd_counter, sizeof(g->event_fd_counter), IO_URING_EVENT_FD_READ);
+
+	while (true) {
+		// Queued polls are submitted together with the wait.
+		int64_t timeout_ns = -1;
+		if (g->timeout_deadline_ns >= 0) {
+			timeout_ns = std::max<int64_t>(g->timeout_deadline_ns - GetSteadyNowNs(), 0);
+		}
+		const int deadline_timeout_ms = GetDeadlineTimeoutMs();
+		if (deadline_timeout_ms >= 0) {
+			const int64_t deadline_timeout_ns = static_cast<int64_t>(deadline_timeout_ms) * 1000 * 1000;
+			timeout_ns = timeout_ns < 0 ? deadline_timeout_ns : std::min(timeout_ns, deadline_timeout_ns);
+		}
+		ring.SubmitAndWait(timeout_ns);
+
+		const idx_t completion_count = ring.ConsumeCompletions([this, g, &ring](uint64_t user_data, int32_t res) {
+			if (user_data == IO_URING_EVENT_FD_READ) {
+				HandleWakeup();
+				ring.PrepRead(g->event_fd, &g->event_fd_counter, sizeof(g->event_fd_counter), IO_URING_EVENT_FD_READ);
+				return;
+			}
+			// Result of cancellation is reflected by the cancelled poll.
+			if (user_data == IO_URING_POLL_REMOVE) {
+				return;
+			}
+			UringPollCallback(reinterpret_cast<UringSockInfo *>(user_data), res, g);
+		});
+
+		if (g->timeout_deadline_ns >= 0 && GetSteadyNowNs() >= g->timeout_deadline_ns) {
+			g->timeout_deadline_ns = -1;
+			SocketAction(g, CURL_SOCKET_TIMEOUT, 0);
+			CheckMulti(g);
+		}
+		ExpireDeadlines();
+		RecordWakeup(completion_count);
+	}
+}
+#endif
+
+void CurlEventLoop::HandleEvent() {
+#ifdef __linux__
+	if (global_info->io_uring != nullptr) {
+		HandleIoUringEvent();
+		return;
+	}
 	std::array<epoll_event, 32> events {};
 #elif defined(__APPLE__)
 	std::array<struct kevent, 32> events {};
 #endif
 	while (true) {
+		// Curl timeout is driven by timer fd, only request deadlines need to be considered.
+		const int timeout_ms = GetDeadlineTimeoutMs();
 #ifdef __linux__
-		const int nfds = epoll_wait(global_info->epoll_fd, events.data(), events.size(), /*timeout=*/-1);
+		const int nfds = epoll_wait(global_info->epoll_fd, events.data(), events.size(), timeout_ms);
 #elif defined(__APPLE__)
-		const int nfds = kevent(global_info->kq_fd, nullptr, 0, events.data(), events.size(), nullptr);
+		struct timespec timeout;
+		timeout.tv_sec = timeout_ms / 1000;
+		timeout.tv_nsec = (timeout_ms % 1000) * 1000 * 1000;
+		const int nfds = kevent(global_info->kq_fd, nullptr, 0, events.data(), events.size(),
+		                        timeout_ms >= 0 ? &timeout : nullptr);
 #endif
 		if (nfds < 0) {
 			if (errno == EINTR) {
@@ -353,56 +755,222 @@ void MultiCurlManager::HandleEvent() {
 				uint64_t unused = 0;
 				const int ret = read(global_info->event_fd, &unused, sizeof(unused));
 				ALWAYS_ASSERT(ret == sizeof(unused));
-				ProcessPendingRequests();
+				HandleWakeup();
 			} else {
 				EventCallback(global_info.get(), events[idx].data.fd, events[idx].events);
 			}
 #elif defined(__APPLE__)
 			auto &ev = events[idx];
 			if (ev.filter == EVFILT_TIMER) {
-				curl_multi_socket_action(global_info->multi, CURL_SOCKET_TIMEOUT, 0, &global_info->still_running);
+				SocketAction(global_info.get(), CURL_SOCKET_TIMEOUT, 0);
 				CheckMulti(global_info.get());
 			} else if (ev.filter == EVFILT_USER && ev.ident == global_info->event_ident) {
-				ProcessPendingRequests();
+				HandleWakeup();
 			} else if (ev.filter == EVFILT_READ || ev.filter == EVFILT_WRITE) {
 				EventCallback(global_info.get(), (int)ev.ident, ev.filter);
 			}
 #endif
 		}
+		ExpireDeadlines();
+		RecordWakeup(static_cast<idx_t>(nfds));
 	}
 }
 
-void MultiCurlManager::ProcessPendingRequests() {
-	while (true) {
-		unique_ptr<CurlRequest> curl_request;
-		{
-			const std::lock_guard<std::mutex> lck(mu);
-			if (pending_requests.empty()) {
-				return;
-			}
-			curl_request = std::move(pending_requests.front());
-			pending_requests.pop();
-		}
+void CurlEventLoop::ProcessPendingRequests() {
+	auto &stats = global_info->stats;
+	const auto now = std::chrono::steady_clock::now();
+	pending_requests.ConsumeAll([this, &stats, now](unique_ptr<CurlRequest> curl_request) {
+		curl_request->add_time = now;
+		EventLoopStats::Add(stats.dequeued_requests, 1);
+		stats.queue_wait.Record(
+		    std::chrono::duration_cast<std::chrono::microseconds>(now - curl_request->submit_time).count());
 
 		auto *curl_request_ptr = curl_request.get();
 		CURL *easy_curl = curl_request->easy_curl;
 		auto iter = global_info->ongoing_requests.find(easy_curl);
 		ALWAYS_ASSERT(iter == global_info->ongoing_requests.end());
 		global_info->ongoing_requests[easy_curl] = std::move(curl_request);
+		global_info->ongoing_request_ids[curl_request_ptr->request_id] = easy_curl;
+		if (curl_request_ptr->HasDeadline()) {
+			global_info->deadlines.Add(ToSteadyMsCeil(curl_request_ptr->deadline), curl_request_ptr->request_id);
+		}
 
+		curl_request_ptr->debug_events = &global_info->debug_events;
 		curl_easy_setopt(easy_curl, CURLOPT_PRIVATE, curl_request_ptr);
 		curl_multi_add_handle(global_info->multi, easy_curl);
+	});
+}
+
+void CurlEventLoop::ProcessCancellations() {
+	vector<uint64_t> request_ids;
+	pending_cancellations.ConsumeAll([&request_ids](uint64_t request_id) { request_ids.emplace_back(request_id); });
+	if (request_ids.empty()) {
+		return;
+	}
+
+	// A request is always submitted before its cancellation, bind requests submitted in between so none is missed.
+	ProcessPendingRequests();
+	for (auto cur_request_id : request_ids) {
+		TerminateRequest(global_info.get(), cur_request_id, REQUEST_CANCELLED_ERROR);
 	}
+	WakeParkedWaiters(global_info.get());
 }
 
-unique_ptr<HTTPResponse> MultiCurlManager::HandleRequest(unique_ptr<CurlRequest> request) {
-	auto resp_fut = request->response.get_future();
-	CURL *easy_curl = request->easy_curl;
-	{
-		const std::lock_guard<std::mutex> lck(mu);
-		pending_requests.emplace(std::move(request));
+void CurlEventLoop::ExpireDeadlines() {
+	auto *g = global_info.get();
+	if (g->deadlines.Size() == 0) {
+		return;
 	}
+	// Terminated requests remove their deadlines, which can't happen while the timer wheel is advancing.
+	g->deadlines.Advance(ToSteadyMs(std::chrono::steady_clock::now()),
+	                     [g](uint64_t request_id) { g->expired_request_ids.emplace_back(request_id); });
+	for (uint64_t cur_request_id : g->expired_request_ids) {
+		TerminateRequest(g, cur_request_id, REQUEST_DEADLINE_EXCEEDED_ERROR);
+	}
+	g->expired_request_ids.clear();
+	WakeParkedWaiters(g);
+}
+
+vector<DebugEvent> CurlEventLoop::GetDebugEvents() const {
+	return global_info->debug_events.Snapshot();
+}
+
+vector<InflightRequestSnapshot> CurlEventLoop::CollectInflightRequests() const {
+	const auto now = std::chrono::steady_clock::now();
+	vector<InflightRequestSnapshot> snapshots;
+	snapshots.reserve(global_info->ongoing_requests.size());
+	for (const auto &cur_request : global_info->ongoing_requests) {
+		CURL *easy_curl = cur_request.first;
+		const auto &req = *cur_request.second;
+		InflightRequestSnapshot snapshot;
+		snapshot.url = RedactUrlCredentials(req.info->url);
+		snapshot.method = req.method;
+		snapshot.range = req.range;
+		snapshot.elapsed_us = static_cast<uint64_t>(
+		    std::chrono::duration_cast<std::chrono::microseconds>(now - req.submit_time).count());
+
+		// Timings are only recorded once the corresponding phase finishes.
+		curl_off_t namelookup_us = 0;
+		curl_off_t connect_us = 0;
+		curl_off_t pretransfer_us = 0;
+		curl_off_t bytes_received = 0;
+		curl_easy_getinfo(easy_curl, CURLINFO_NAMELOOKUP_TIME_T, &namelookup_us);
+		curl_easy_getinfo(easy_curl, CURLINFO_CONNECT_TIME_T, &connect_us);
+		curl_easy_getinfo(easy_curl, CURLINFO_PRETRANSFER_TIME_T, &pretransfer_us);
+		curl_easy_getinfo(easy_curl, CURLINFO_SIZE_DOWNLOAD_T, &bytes_received);
+		if (pretransfer_us > 0) {
+			snapshot.state = InflightRequestState::TRANSFERRING;
+		} else if (namelookup_us > 0 || connect_us > 0) {
+			snapshot.state = InflightRequestState::CONNECTING;
+		} else {
+			snapshot.state = InflightRequestState::QUEUED;
+		}
+		snapshot.bytes_received = static_cast<uint64_t>(bytes_received);
+		snapshots.emplace_back(std::move(snapshot));
+	}
+	return snapshots;
+}
+
+void CurlEventLoop::RecordWakeup(idx_t event_count) {
+	auto &stats = global_info->stats;
+	EventLoopStats::Add(stats.wakeups, 1);
+	EventLoopStats::Add(stats.events, event_count);
+	stats.ongoing_requests.store(global_info->ongoing_requests.size(), std::memory_order_relaxed);
+	stats.still_running.store(static_cast<uint64_t>(std::max(global_info->still_running, 0)),
+	                          std::memory_order_relaxed);
+	stats.pending_deadlines.store(global_info->deadlines.Size(), std::memory_order_relaxed);
+}
+
+int CurlEventLoop::GetDeadlineTimeoutMs() const {
+	const int64_t timeout_ms = global_info->deadlines.GetTimeoutMs(ToSteadyMs(std::chrono::steady_clock::now()));
+	return static_cast<int>(std::min<int64_t>(timeout_ms, std::numeric_limits<int>::max()));
+}
+
+void CurlEventLoop::ProcessTasks() {
+	pending_tasks.ConsumeAll([](std::function<void()> task) { task(); });
+}
+
+void CurlEventLoop::ApplyConnectionLimits() {
+	// Curl takes limits as long, and clamps concurrent streams into [1, 2^31 - 1] by itself.
+	auto to_long = [](uint64_t value) {
+		return static_cast<long>(std::min<uint64_t>(value, std::numeric_limits<long>::max()));
+	};
+	auto *multi = global_info->multi;
+	curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS, to_long(MAX_CONNECTIONS_PER_HOST.load()));
+	curl_multi_setopt(multi, CURLMOPT_MAX_TOTAL_CONNECTIONS, to_long(MAX_TOTAL_CONNECTIONS.load()));
+	// Max connects 0 lets curl size the connection cache by the number of easy handles added.
+	curl_multi_setopt(multi, CURLMOPT_MAXCONNECTS, to_long(MAX_CONNECTS.load()));
+	curl_multi_setopt(multi, CURLMOPT_MAX_CONCURRENT_STREAMS, to_long(MAX_CONCURRENT_STREAMS.load()));
+}
+
+void CurlEventLoop::HandleWakeup() {
+	ProcessPendingRequests();
+	ProcessCancellations();
+	ProcessTasks();
+}
+
+vector<CurlRequestHandle> CurlEventLoop::SubmitRequests(vector<unique_ptr<CurlRequest>> requests) {
+	vector<CurlRequestHandle> handles;
+	handles.reserve(requests.size());
+	const auto submit_time = std::chrono::steady_clock::now();
+	const bool enable_trace = ENABLE_REQUEST_TRACE.load(std::memory_order_relaxed);
+	for (auto &cur_request : requests) {
+		cur_request->submit_time = submit_time;
+		if (enable_trace) {
+			AssignTraceId(*cur_request);
+		}
+		cur_request->request_id = next_request_id.fetch_add(1, std::memory_order_relaxed);
+		handles.emplace_back(CurlRequestHandle {this, cur_request->request_id});
+	}
+	// Eventloop drains all pending requests on wakeup, so only the submission which makes queue non-empty notifies.
+	if (pending_requests.PushBatch(std::move(requests))) {
+		Wakeup();
+	}
+	return handles;
+}
+
+CurlRequestHandle CurlEventLoop::SubmitRequest(unique_ptr<CurlRequest> request) {
+	request->submit_time = std::chrono::steady_clock::now();
+	if (ENABLE_REQUEST_TRACE.load(std::memory_order_relaxed)) {
+		AssignTraceId(*request);
+	}
+	request->request_id = next_request_id.fetch_add(1, std::memory_order_relaxed);
+	const CurlRequestHandle handle {this, request->request_id};
+	if (pending_requests.Push(std::move(request))) {
+		Wakeup();
+	}
+	return handle;
+}
+
+void CurlEventLoop::CancelRequest(uint64_t request_id) {
+	if (pending_cancellations.Push(request_id)) {
+		Wakeup();
+	}
+}
+
+void CurlEventLoop::PostTask(std::function<void()> task) {
+	if (pending_tasks.Push(std::move(task))) {
+		Wakeup();
+	}
+}
 
+std::future<vector<InflightRequestSnapshot>> CurlEventLoop::SnapshotInflightRequests() {
+	// Shared with the task, which might still run after the caller gives up waiting.
+	auto snapshot_promise = std::make_shared<std::promise<vector<InflightRequestSnapshot>>>();
+	auto snapshot_future = snapshot_promise->get_future();
+	PostTask([this, snapshot_promise]() {
+		// Bind requests still in the pending queue, which the eventloop would do on this wakeup anyway.
+		ProcessPendingRequests();
+		snapshot_promise->set_value(CollectInflightRequests());
+	});
+	return snapshot_future;
+}
+
+void CurlEventLoop::RefreshConnectionLimits() {
+	PostTask([this]() { ApplyConnectionLimits(); });
+}
+
+void CurlEventLoop::Wakeup() {
 	// Notify epoll to wakeup and process request.
 #ifdef __linux__
 	uint64_t one = 1;
@@ -413,8 +981,194 @@ unique_ptr<HTTPResponse> MultiCurlManager::HandleRequest(unique_ptr<CurlRequest>
 	EV_SET(&ev, global_info->event_ident, EVFILT_USER, 0, NOTE_TRIGGER, 0, nullptr);
 	kevent(global_info->kq_fd, &ev, 1, nullptr, 0, nullptr);
 #endif
+}
+
+/*static*/ MultiCurlManager &MultiCurlManager::GetInstance() {
+	static auto *manager = new MultiCurlManager();
+	return *manager;
+}
+
+/*static*/ idx_t MultiCurlManager::GetDefaultEventLoopCount() {
+	const int loop_count = GetCpuCoreCount() / CPU_CORES_PER_EVENT_LOOP;
+	if (loop_count <= 0) {
+		return 1;
+	}
+	return std::min<idx_t>(static_cast<idx_t>(loop_count), MAX_EVENT_LOOP_COUNT);
+}
+
+CurlEventLoop &MultiCurlManager::GetOrCreateEventLoop(idx_t loop_idx) {
+	auto *event_loop = event_loops[loop_idx].load(std::memory_order_acquire);
+	if (event_loop != nullptr) {
+		return *event_loop;
+	}
+
+	const std::lock_guard<std::mutex> lck(event_loop_creation_mu);
+	event_loop = event_loops[loop_idx].load(std::memory_order_acquire);
+	if (event_loop == nullptr) {
+		// Eventloops live as long as the process, same as the manager itself.
+		event_loop = new CurlEventLoop(EVENT_LOOP_BACKEND.load());
+		event_loops[loop_idx].store(event_loop, std::memory_order_release);
+	}
+	return *event_loop;
+}
+
+CurlEventLoop &MultiCurlManager::GetEventLoop(const CurlRequest &request) {
+	idx_t loop_count = EVENT_LOOP_COUNT.load();
+	if (loop_count == 0) {
+		loop_count = GetDefaultEventLoopCount();
+	}
+	loop_count = std::min<idx_t>(loop_count, MAX_EVENT_LOOP_COUNT);
+
+	idx_t loop_idx = 0;
+	if (EVENT_LOOP_ROUTING.load() == EventLoopRouting::HOST) {
+		loop_idx = std::hash<string> {}(request.host) % loop_count;
+	} else {
+		loop_idx = next_event_loop.fetch_add(1, std::memory_order_relaxed) % loop_count;
+	}
+	return GetOrCreateEventLoop(loop_idx);
+}
+
+CurlRequestHandle MultiCurlManager::SubmitRequest(unique_ptr<CurlRequest> request) {
+	D_ASSERT(request->HasCompletion());
+	auto &event_loop = GetEventLoop(*request);
+	return event_loop.SubmitRequest(std::move(request));
+}
+
+vector<CurlRequestHandle> MultiCurlManager::SubmitRequests(vector<unique_ptr<CurlRequest>> requests) {
+	// Group requests by eventloop, so each eventloop is only woken up once.
+	unordered_map<CurlEventLoop *, vector<unique_ptr<CurlRequest>>> requests_per_loop;
+	unordered_map<CurlEventLoop *, vector<idx_t>> request_indices_per_loop;
+	for (idx_t idx = 0; idx < requests.size(); ++idx) {
+		auto &cur_request = requests[idx];
+		D_ASSERT(cur_request->HasCompletion());
+		auto &event_loop = GetEventLoop(*cur_request);
+		requests_per_loop[&event_loop].emplace_back(std::move(cur_request));
+		request_indices_per_loop[&event_loop].emplace_back(idx);
+	}
+
+	vector<CurlRequestHandle> handles(requests.size());
+	for (auto &cur_loop_requests : requests_per_loop) {
+		auto *event_loop = cur_loop_requests.first;
+		auto loop_handles = event_loop->SubmitRequests(std::move(cur_loop_requests.second));
+		const auto &request_indices = request_indices_per_loop[event_loop];
+		for (idx_t idx = 0; idx < loop_handles.size(); ++idx) {
+			handles[request_indices[idx]] = loop_handles[idx];
+		}
+	}
+	return handles;
+}
+
+void MultiCurlManager::CancelRequest(const CurlRequestHandle &handle) {
+	D_ASSERT(handle.event_loop != nullptr);
+	handle.event_loop->CancelRequest(handle.request_id);
+}
 
-	return resp_fut.get();
+vector<EventLoopStatsSnapshot> MultiCurlManager::GetEventLoopStats() {
+	vector<EventLoopStatsSnapshot> snapshots;
+	for (idx_t idx = 0; idx < MAX_EVENT_LOOP_COUNT; ++idx) {
+		auto *event_loop = event_loops[idx].load(std::memory_order_acquire);
+		if (event_loop == nullptr) {
+			continue;
+		}
+		auto snapshot = event_loop->GetStats();
+		snapshot.event_loop_idx = idx;
+		snapshots.emplace_back(std::move(snapshot));
+	}
+	return snapshots;
+}
+
+vector<DebugEvent> MultiCurlManager::GetDebugEvents() {
+	vector<DebugEvent> events;
+	for (idx_t idx = 0; idx < MAX_EVENT_LOOP_COUNT; ++idx) {
+		auto *event_loop = event_loops[idx].load(std::memory_order_acquire);
+		if (event_loop == nullptr) {
+			continue;
+		}
+		for (auto &cur_event : event_loop->GetDebugEvents()) {
+			cur_event.event_loop_idx = static_cast<uint32_t>(idx);
+			events.emplace_back(cur_event);
+		}
+	}
+	std::stable_sort(events.begin(), events.end(), [](const DebugEvent &lhs, const DebugEvent &rhs) {
+		return lhs.timestamp_us > rhs.timestamp_us;
+	});
+	return events;
+}
+
+vector<InflightRequestSnapshot> MultiCurlManager::GetInflightRequests() {
+	// Snapshots are taken by all eventloops concurrently, and share one deadline.
+	vector<std::pair<idx_t, std::future<vector<InflightRequestSnapshot>>>> loop_snapshots;
+	for (idx_t idx = 0; idx < MAX_EVENT_LOOP_COUNT; ++idx) {
+		auto *event_loop = event_loops[idx].load(std::memory_order_acquire);
+		if (event_loop != nullptr) {
+			loop_snapshots.emplace_back(idx, event_loop->SnapshotInflightRequests());
+		}
+	}
+
+	const auto deadline = std::chrono::steady_clock::now() + INFLIGHT_SNAPSHOT_TIMEOUT;
+	vector<InflightRequestSnapshot> snapshots;
+	for (auto &cur_loop_snapshots : loop_snapshots) {
+		auto &snapshot_future = cur_loop_snapshots.second;
+		if (snapshot_future.wait_until(deadline) != std::future_status::ready) {
+			continue;
+		}
+		for (auto &cur_snapshot : snapshot_future.get()) {
+			cur_snapshot.event_loop_idx = cur_loop_snapshots.first;
+			snapshots.emplace_back(std::move(cur_snapshot));
+		}
+	}
+	return snapshots;
+}
+
+void MultiCurlManager::RefreshConnectionLimits() {
+	for (auto &cur_event_loop : event_loops) {
+		auto *event_loop = cur_event_loop.load(std::memory_order_acquire);
+		if (event_loop != nullptr) {
+			event_loop->RefreshConnectionLimits();
+		}
+	}
+}
+
+bool WaitUnlessInterrupted(const std::function<bool(std::chrono::nanoseconds)> &wait_for,
+                           const CurlInterruptCheck &interrupt_check) {
+	while (!wait_for(INTERRUPT_CHECK_INTERVAL)) {
+		if (interrupt_check && interrupt_check()) {
+			return false;
+		}
+	}
+	return true;
+}
+
+unique_ptr<HTTPResponse> MultiCurlManager::HandleRequest(unique_ptr<CurlRequest> request,
+                                                         const CurlInterruptCheck &interrupt_check) {
+	auto *completion_slot = CompletionSlot::Acquire();
+	request->SetCompletionSlot(*completion_slot);
+	// Trace id is assigned ahead of submission, so the caller's wakeup could be joined with the request.
+	uint64_t trace_id = 0;
+	if (ENABLE_REQUEST_TRACE.load(std::memory_order_relaxed)) {
+		AssignTraceId(*request);
+		trace_id = request->trace_id;
+	}
+	const auto handle = SubmitRequest(std::move(request));
+	if (interrupt_check) {
+		auto wait_for = [completion_slot](std::chrono::nanoseconds timeout) {
+			return completion_slot->WaitFor(timeout);
+		};
+		if (!WaitUnlessInterrupted(wait_for, interrupt_check)) {
+			// Request still completes via the slot, with a cancelled status unless it finishes in between.
+			CancelRequest(handle);
+		}
+	}
+	auto response = completion_slot->Wait();
+	CompletionSlot::Release(completion_slot);
+	if (trace_id != 0) {
+		RequestTraceRecord record;
+		record.kind = RequestTraceRecord::Kind::WAKEUP;
+		record.trace_id = trace_id;
+		record.wakeup_ns = GetSteadyNowNs();
+		RequestTrace::GetInstance().Append(record);
+	}
+	return response;
 }
 
 } // namespace duckdb
@@ -1,9 +1,26 @@
 #include "multi_curl_util.hpp"
 
+#include "client_context_registry.hpp"
+#include "duckdb/common/file_opener.hpp"
+#include "http_profiling_state.hpp"
 #include "multi_curl_client.hpp"
 
 namespace duckdb {
 
+unique_ptr<HTTPParams> MultiCurlUtil::InitializeParameters(optional_ptr<FileOpener> opener,
+                                                           optional_ptr<FileOpenerInfo> info) {
+	auto params = HTTPFSCurlUtil::InitializeParameters(opener, info);
+	// Record which client context the HTTP state belongs to, so clients could cancel requests on query interruption,
+	// and report HTTP wait time to its profiler.
+	auto client_context = FileOpener::TryGetClientContext(opener);
+	auto &httpfs_params = params->Cast<HTTPFSParams>();
+	if (client_context && httpfs_params.state) {
+		ClientContextRegistry::GetInstance().Register(*httpfs_params.state, *client_context);
+		client_context->registered_state->GetOrCreate<HTTPProfilingState>(HTTPProfilingState::STATE_KEY);
+	}
+	return params;
+}
+
 unique_ptr<HTTPClient> MultiCurlUtil::InitializeClient(HTTPParams &http_params, const string &proto_host_port) {
 	auto client = make_uniq<MultiCurlClient>(http_params.Cast<HTTPFSParams>(), proto_host_port);
 	return std::move(client);
@@ -0,0 +1,119 @@
+#include "request_latency_query_function.hpp"
+
+#include <array>
+#include <utility>
+
+#include "duckdb/common/helper.hpp"
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/unique_ptr.hpp"
+#include "duckdb/common/vector.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "request_latency_registry.hpp"
+
+namespace duckdb {
+
+namespace {
+
+// Percentiles reported as columns.
+constexpr std::array<double, 4> PERCENTILES = {0.5, 0.9, 0.99, 0.999};
+constexpr std::array<const char *, 4> PERCENTILE_COLUMN_NAMES = {"p50_us", "p90_us", "p99_us", "p999_us"};
+
+struct RequestLatencyEntry {
+	string host;
+	RequestPhase phase;
+	LatencyHistogram::Snapshot snapshot;
+};
+
+//===--------------------------------------------------------------------===//
+// Get request latency query function
+//===--------------------------------------------------------------------===//
+
+struct RequestLatencyData : public GlobalTableFunctionState {
+	vector<RequestLatencyEntry> entries;
+
+	// Used to record the progress of emission.
+	uint64_t offset = 0;
+};
+
+unique_ptr<FunctionData> GetRequestLatencyFuncBind(ClientContext &context, TableFunctionBindInput &input,
+                                                   vector<LogicalType> &return_types, vector<string> &names) {
+	ALWAYS_ASSERT(return_types.empty());
+	ALWAYS_ASSERT(names.empty());
+
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+	names.emplace_back("host");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+	names.emplace_back("phase");
+	return_types.emplace_back(LogicalType {LogicalTypeId::UBIGINT});
+	names.emplace_back("count");
+	return_types.emplace_back(LogicalType {LogicalTypeId::DOUBLE});
+	names.emplace_back("mean_us");
+	for (const auto *cur_column_name : PERCENTILE_COLUMN_NAMES) {
+		return_types.emplace_back(LogicalType {LogicalTypeId::UBIGINT});
+		names.emplace_back(cur_column_name);
+	}
+	return_types.emplace_back(LogicalType {LogicalTypeId::UBIGINT});
+	names.emplace_back("max_us");
+
+	return nullptr;
+}
+
+unique_ptr<GlobalTableFunctionState> GetRequestLatencyFuncInit(ClientContext &context, TableFunctionInitInput &input) {
+	auto result = make_uniq<RequestLatencyData>();
+	auto &entries = result->entries;
+
+	// Snapshots are sorted by host, phases are emitted in the order of a request; phases never recorded are skipped.
+	auto snapshots = RequestLatencyRegistry::GetInstance().GetSnapshots();
+	for (auto &cur_snapshot : snapshots) {
+		for (idx_t idx = 0; idx < REQUEST_PHASE_COUNT; ++idx) {
+			if (cur_snapshot.phases[idx].count == 0) {
+				continue;
+			}
+			RequestLatencyEntry cur_entry;
+			cur_entry.host = cur_snapshot.host;
+			cur_entry.phase = static_cast<RequestPhase>(idx);
+			cur_entry.snapshot = cur_snapshot.phases[idx];
+			entries.emplace_back(std::move(cur_entry));
+		}
+	}
+
+	return std::move(result);
+}
+
+void GetRequestLatencyTableFunc(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+	auto &data = data_p.global_state->Cast<RequestLatencyData>();
+
+	// All entries have been emitted.
+	if (data.offset >= data.entries.size()) {
+		return;
+	}
+
+	// Start filling in the result buffer.
+	idx_t count = 0;
+	while (data.offset < data.entries.size() && count < STANDARD_VECTOR_SIZE) {
+		auto &entry = data.entries[data.offset++];
+		idx_t col_idx = 0;
+		output.SetValue(col_idx++, count, entry.host);
+		output.SetValue(col_idx++, count, GetRequestPhaseName(entry.phase));
+		output.SetValue(col_idx++, count, Value::UBIGINT(entry.snapshot.count));
+		output.SetValue(col_idx++, count, Value::DOUBLE(entry.snapshot.GetMean()));
+		for (double cur_percentile : PERCENTILES) {
+			output.SetValue(col_idx++, count, Value::UBIGINT(entry.snapshot.GetPercentile(cur_percentile)));
+		}
+		output.SetValue(col_idx++, count, Value::UBIGINT(entry.snapshot.max_us));
+		count++;
+	}
+	output.SetCardinality(count);
+}
+} // namespace
+
+TableFunction GetRequestLatencyFunc() {
+	TableFunction request_latency_query_func {/*name=*/"curl_httpfs_request_latency",
+	                                          /*arguments=*/ {},
+	                                          /*function=*/GetRequestLatencyTableFunc,
+	                                          /*bind=*/GetRequestLatencyFuncBind,
+	                                          /*init_global=*/GetRequestLatencyFuncInit};
+	return request_latency_query_func;
+}
+} // namespace duckdb
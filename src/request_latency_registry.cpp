@@ -0,0 +1,51 @@
+#include "request_latency_registry.hpp"
+
+#include <algorithm>
+
+namespace duckdb {
+
+const char *GetRequestPhaseName(RequestPhase phase) {
+	switch (phase) {
+	case RequestPhase::DNS:
+		return "dns";
+	case RequestPhase::CONNECT:
+		return "connect";
+	case RequestPhase::TLS:
+		return "tls";
+	case RequestPhase::FIRST_BYTE:
+		return "first_byte";
+	case RequestPhase::TRANSFER:
+		return "transfer";
+	case RequestPhase::TOTAL:
+		return "total";
+	}
+	return "unknown";
+}
+
+void HostRequestLatency::Record(const CurlTransferInfo &info) {
+	auto record = [this](RequestPhase phase, int64_t latency_us) {
+		phases[static_cast<idx_t>(phase)].Record(latency_us);
+	};
+	// Connection setup phases of reused connections are close to zero, which would skew their distribution.
+	if (info.new_connects > 0) {
+		record(RequestPhase::DNS, info.namelookup_us);
+		record(RequestPhase::CONNECT, info.connect_us - info.namelookup_us);
+		if (info.appconnect_us > 0) {
+			record(RequestPhase::TLS, info.appconnect_us - info.connect_us);
+		}
+	}
+	const curl_off_t connection_ready_us = std::max(info.connect_us, info.appconnect_us);
+	record(RequestPhase::FIRST_BYTE, info.starttransfer_us - connection_ready_us);
+	record(RequestPhase::TRANSFER, info.total_us - info.starttransfer_us);
+	record(RequestPhase::TOTAL, info.total_us);
+}
+
+HostRequestLatency::Snapshot HostRequestLatency::GetSnapshot() const {
+	Snapshot snapshot;
+	for (idx_t idx = 0; idx < REQUEST_PHASE_COUNT; ++idx) {
+		snapshot.phases[idx] = phases[idx].GetSnapshot();
+	}
+	return snapshot;
+}
+
+} // namespace duckdb
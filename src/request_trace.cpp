@@ -0,0 +1,164 @@
+#include "request_trace.hpp"
+
+#include <cinttypes>
+#include <cstdio>
+
+#include "duckdb/common/unordered_map.hpp"
+
+namespace duckdb {
+
+namespace {
+
+// Used to assign thread ids in traces.
+std::atomic<uint32_t> next_thread_id {1};
+
+// Write the given string as a JSON string literal.
+void WriteJsonString(std::ostream &out, const char *value) {
+	out << '"';
+	for (const char *cur = value; *cur != '\0'; ++cur) {
+		const char ch = *cur;
+		if (ch == '"' || ch == '\\') {
+			out << '\\' << ch;
+		} else if (static_cast<unsigned char>(ch) < 0x20) {
+			char escaped[8];
+			snprintf(escaped, sizeof(escaped), "\\u%04x", ch);
+			out << escaped;
+		} else {
+			out << ch;
+		}
+	}
+	out << '"';
+}
+
+// Writes async nestable events of requests, each request is a track keyed by its trace id.
+class ChromeTraceWriter {
+public:
+	ChromeTraceWriter(std::ostream &out_p, int64_t base_ns_p) : out(out_p), base_ns(base_ns_p) {
+		out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+		out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"curl_httpfs\"}}";
+	}
+	~ChromeTraceWriter() {
+		out << "]}\n";
+	}
+
+	// Write the whole timeline of one request, [`wakeup_ns`] is 0 if the caller doesn't block.
+	void WriteRequest(const RequestTraceRecord &record, int64_t wakeup_ns) {
+		const int64_t end_ns = std::max(record.complete_ns, wakeup_ns);
+		WriteEvent("request", 'b', record, record.submit_ns, /*with_args=*/true);
+		WritePhase("queue", record, record.submit_ns, record.add_ns);
+		// Curl starts transfers on its next timeout, and keeps them pending while connection limits are reached.
+		if (record.start_ns > record.add_ns) {
+			WritePhase("pending", record, record.add_ns, record.start_ns);
+		}
+		int64_t ready_ns = record.start_ns;
+		if (record.namelookup_ns > 0) {
+			WritePhase("dns", record, record.start_ns, record.namelookup_ns);
+		}
+		if (record.connect_ns > 0) {
+			WritePhase("connect", record, std::max(record.start_ns, record.namelookup_ns), record.connect_ns);
+			ready_ns = record.connect_ns;
+		}
+		if (record.appconnect_ns > 0) {
+			WritePhase("tls", record, ready_ns, record.appconnect_ns);
+			ready_ns = record.appconnect_ns;
+		}
+		if (record.first_byte_ns > 0) {
+			WritePhase("wait_first_byte", record, ready_ns, record.first_byte_ns);
+			WritePhase("transfer", record, record.first_byte_ns, record.complete_ns);
+		}
+		if (wakeup_ns > 0) {
+			WritePhase("wakeup", record, record.complete_ns, wakeup_ns);
+		}
+		WriteEvent("request", 'e', record, end_ns, /*with_args=*/false);
+	}
+
+private:
+	void WritePhase(const char *name, const RequestTraceRecord &record, int64_t begin_ns, int64_t end_ns) {
+		WriteEvent(name, 'b', record, begin_ns, /*with_args=*/false);
+		WriteEvent(name, 'e', record, std::max(begin_ns, end_ns), /*with_args=*/false);
+	}
+
+	void WriteEvent(const char *name, char phase, const RequestTraceRecord &record, int64_t ts_ns, bool with_args) {
+		char buffer[192];
+		snprintf(buffer, sizeof(buffer),
+		         ",{\"name\":\"%s\",\"cat\":\"http\",\"ph\":\"%c\",\"id\":\"0x%" PRIx64
+		         "\",\"pid\":1,\"tid\":%u,\"ts\":%.3f",
+		         name, phase, record.trace_id, record.caller_thread_id,
+		         static_cast<double>(ts_ns - base_ns) / 1000.0);
+		out << buffer;
+		if (with_args) {
+			out << ",\"args\":{\"method\":";
+			WriteJsonString(out, record.method.data());
+			out << ",\"url\":";
+			WriteJsonString(out, record.url.data());
+			out << ",\"range\":";
+			WriteJsonString(out, record.range.data());
+			out << ",\"status\":" << record.status_code << ",\"failed\":" << (record.failed ? "true" : "false")
+			    << ",\"bytes_received\":" << record.bytes_received << "}";
+		}
+		out << "}";
+	}
+
+	std::ostream &out;
+	// Timestamps are written relative to the earliest request.
+	int64_t base_ns = 0;
+};
+
+} // namespace
+
+/*static*/ RequestTrace &RequestTrace::GetInstance() {
+	static auto *request_trace = new RequestTrace();
+	return *request_trace;
+}
+
+uint64_t RequestTrace::NextTraceId() {
+	return next_trace_id.fetch_add(1, std::memory_order_relaxed);
+}
+
+/*static*/ uint32_t RequestTrace::GetCurrentThreadId() {
+	thread_local uint32_t thread_id = next_thread_id.fetch_add(1, std::memory_order_relaxed);
+	return thread_id;
+}
+
+void RequestTrace::Append(const RequestTraceRecord &record) {
+	ring.Append(record);
+}
+
+vector<RequestTraceRecord> RequestTrace::Drain() {
+	const std::lock_guard<std::mutex> lck(drain_mu);
+	const uint64_t end_position = ring.GetNextPosition();
+	vector<RequestTraceRecord> records;
+	ring.Read(drained_position, end_position, records);
+	drained_position = end_position;
+	return records;
+}
+
+idx_t RequestTrace::ExportChromeTrace(std::ostream &out) {
+	auto records = Drain();
+
+	unordered_map<uint64_t, int64_t> wakeup_times;
+	int64_t base_ns = 0;
+	for (const auto &cur_record : records) {
+		if (cur_record.kind == RequestTraceRecord::Kind::WAKEUP) {
+			wakeup_times[cur_record.trace_id] = cur_record.wakeup_ns;
+			continue;
+		}
+		if (base_ns == 0 || cur_record.submit_ns < base_ns) {
+			base_ns = cur_record.submit_ns;
+		}
+	}
+
+	idx_t request_count = 0;
+	ChromeTraceWriter writer(out, base_ns);
+	for (const auto &cur_record : records) {
+		if (cur_record.kind != RequestTraceRecord::Kind::COMPLETION) {
+			continue;
+		}
+		auto iter = wakeup_times.find(cur_record.trace_id);
+		writer.WriteRequest(cur_record, iter == wakeup_times.end() ? 0 : iter->second);
+		++request_count;
+	}
+	return request_count;
+}
+
+} // namespace duckdb
@@ -0,0 +1,87 @@
+#include "request_trace_query_function.hpp"
+
+#include <sstream>
+#include <utility>
+
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/helper.hpp"
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/unique_ptr.hpp"
+#include "duckdb/common/vector.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "request_trace.hpp"
+
+namespace duckdb {
+
+namespace {
+
+//===--------------------------------------------------------------------===//
+// Export request trace query function
+//===--------------------------------------------------------------------===//
+
+struct ExportRequestTraceBindData : public TableFunctionData {
+	string path;
+};
+
+struct ExportRequestTraceData : public GlobalTableFunctionState {
+	idx_t request_count = 0;
+	bool emitted = false;
+};
+
+unique_ptr<FunctionData> ExportRequestTraceFuncBind(ClientContext &context, TableFunctionBindInput &input,
+                                                    vector<LogicalType> &return_types, vector<string> &names) {
+	ALWAYS_ASSERT(return_types.empty());
+	ALWAYS_ASSERT(names.empty());
+
+	auto result = make_uniq<ExportRequestTraceBindData>();
+	result->path = StringValue::Get(input.inputs[0]);
+
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+	names.emplace_back("path");
+	return_types.emplace_back(LogicalType {LogicalTypeId::UBIGINT});
+	names.emplace_back("request_count");
+
+	return std::move(result);
+}
+
+unique_ptr<GlobalTableFunctionState> ExportRequestTraceFuncInit(ClientContext &context,
+                                                                TableFunctionInitInput &input) {
+	const auto &bind_data = input.bind_data->Cast<ExportRequestTraceBindData>();
+	auto result = make_uniq<ExportRequestTraceData>();
+
+	std::ostringstream out;
+	result->request_count = RequestTrace::GetInstance().ExportChromeTrace(out);
+	const string trace = out.str();
+
+	// Written through the database file system, which enforces external access and allowed directories.
+	auto &fs = FileSystem::GetFileSystem(context);
+	auto handle = fs.OpenFile(bind_data.path, FileFlags::FILE_FLAGS_WRITE | FileFlags::FILE_FLAGS_FILE_CREATE_NEW);
+	handle->Write(const_cast<char *>(trace.data()), static_cast<int64_t>(trace.size()));
+	handle->Close();
+
+	return std::move(result);
+}
+
+void ExportRequestTraceTableFunc(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+	auto &data = data_p.global_state->Cast<ExportRequestTraceData>();
+	if (data.emitted) {
+		return;
+	}
+	const auto &bind_data = data_p.bind_data->Cast<ExportRequestTraceBindData>();
+	output.SetValue(/*col_idx=*/0, /*index=*/0, bind_data.path);
+	output.SetValue(/*col_idx=*/1, /*index=*/0, Value::UBIGINT(data.request_count));
+	output.SetCardinality(1);
+	data.emitted = true;
+}
+} // namespace
+
+TableFunction GetExportRequestTraceFunc() {
+	TableFunction export_request_trace_func {/*name=*/"curl_httpfs_export_request_trace",
+	                                         /*arguments=*/ {LogicalType {LogicalTypeId::VARCHAR}},
+	                                         /*function=*/ExportRequestTraceTableFunc,
+	                                         /*bind=*/ExportRequestTraceFuncBind,
+	                                         /*init_global=*/ExportRequestTraceFuncInit};
+	return export_request_trace_func;
+}
+} // namespace duckdb
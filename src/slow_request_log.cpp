@@ -0,0 +1,59 @@
+#include "slow_request_log.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace duckdb {
+
+namespace {
+
+uint64_t GetDuration(curl_off_t begin_us, curl_off_t end_us) {
+	return end_us > begin_us ? static_cast<uint64_t>(end_us - begin_us) : 0;
+}
+
+} // namespace
+
+void SlowRequestEntry::SetTransferInfo(const CurlTransferInfo &info) {
+	connection_id = info.connection_id;
+	new_connections = static_cast<uint64_t>(std::max<long>(info.new_connects, 0));
+	redirects = static_cast<uint64_t>(std::max<long>(info.redirect_count, 0));
+	bytes_received = static_cast<uint64_t>(std::max<curl_off_t>(info.bytes_received, 0));
+	if (info.new_connects > 0) {
+		dns_us = GetDuration(0, info.namelookup_us);
+		connect_us = GetDuration(info.namelookup_us, info.connect_us);
+		if (info.appconnect_us > 0) {
+			tls_us = GetDuration(info.connect_us, info.appconnect_us);
+		}
+	}
+	const curl_off_t connection_ready_us = std::max(info.connect_us, info.appconnect_us);
+	// Failed transfers might never reach the later phases.
+	if (info.starttransfer_us > 0) {
+		first_byte_us = GetDuration(connection_ready_us, info.starttransfer_us);
+		transfer_us = GetDuration(info.starttransfer_us, info.total_us);
+	}
+}
+
+/*static*/ SlowRequestLog &SlowRequestLog::GetInstance() {
+	static auto *log = new SlowRequestLog();
+	return *log;
+}
+
+void SlowRequestLog::Append(SlowRequestEntry entry) {
+	const std::lock_guard<std::mutex> lck(mu);
+	if (entries.size() >= CAPACITY) {
+		entries.pop_front();
+	}
+	entries.emplace_back(std::move(entry));
+}
+
+vector<SlowRequestEntry> SlowRequestLog::GetEntries() {
+	const std::lock_guard<std::mutex> lck(mu);
+	return vector<SlowRequestEntry>(entries.rbegin(), entries.rend());
+}
+
+void SlowRequestLog::Clear() {
+	const std::lock_guard<std::mutex> lck(mu);
+	entries.clear();
+}
+
+} // namespace duckdb
@@ -0,0 +1,113 @@
+#include "slow_requests_query_function.hpp"
+
+#include <utility>
+
+#include "duckdb/common/helper.hpp"
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/types/timestamp.hpp"
+#include "duckdb/common/unique_ptr.hpp"
+#include "duckdb/common/vector.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "slow_request_log.hpp"
+
+namespace duckdb {
+
+namespace {
+
+//===--------------------------------------------------------------------===//
+// Get slow requests query function
+//===--------------------------------------------------------------------===//
+
+struct SlowRequestsData : public GlobalTableFunctionState {
+	vector<SlowRequestEntry> entries;
+
+	// Used to record the progress of emission.
+	uint64_t offset = 0;
+};
+
+unique_ptr<FunctionData> GetSlowRequestsFuncBind(ClientContext &context, TableFunctionBindInput &input,
+                                                 vector<LogicalType> &return_types, vector<string> &names) {
+	ALWAYS_ASSERT(return_types.empty());
+	ALWAYS_ASSERT(names.empty());
+
+	auto add_column = [&](const char *name, LogicalTypeId type) {
+		names.emplace_back(name);
+		return_types.emplace_back(LogicalType {type});
+	};
+	add_column("time", LogicalTypeId::TIMESTAMP);
+	add_column("method", LogicalTypeId::VARCHAR);
+	add_column("url", LogicalTypeId::VARCHAR);
+	add_column("range", LogicalTypeId::VARCHAR);
+	add_column("status", LogicalTypeId::USMALLINT);
+	add_column("error", LogicalTypeId::VARCHAR);
+	add_column("connection_id", LogicalTypeId::BIGINT);
+	add_column("new_connections", LogicalTypeId::UBIGINT);
+	add_column("redirects", LogicalTypeId::UBIGINT);
+	add_column("bytes_received", LogicalTypeId::UBIGINT);
+	add_column("queue_us", LogicalTypeId::UBIGINT);
+	add_column("dns_us", LogicalTypeId::UBIGINT);
+	add_column("connect_us", LogicalTypeId::UBIGINT);
+	add_column("tls_us", LogicalTypeId::UBIGINT);
+	add_column("first_byte_us", LogicalTypeId::UBIGINT);
+	add_column("transfer_us", LogicalTypeId::UBIGINT);
+	add_column("total_us", LogicalTypeId::UBIGINT);
+
+	return nullptr;
+}
+
+unique_ptr<GlobalTableFunctionState> GetSlowRequestsFuncInit(ClientContext &context, TableFunctionInitInput &input) {
+	auto result = make_uniq<SlowRequestsData>();
+	result->entries = SlowRequestLog::GetInstance().GetEntries();
+	return std::move(result);
+}
+
+void GetSlowRequestsTableFunc(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+	auto &data = data_p.global_state->Cast<SlowRequestsData>();
+
+	// All entries have been emitted.
+	if (data.offset >= data.entries.size()) {
+		return;
+	}
+
+	// Start filling in the result buffer.
+	idx_t count = 0;
+	while (data.offset < data.entries.size() && count < STANDARD_VECTOR_SIZE) {
+		auto &entry = data.entries[data.offset++];
+		idx_t col_idx = 0;
+		output.SetValue(col_idx++, count, Value::TIMESTAMP(timestamp_t(entry.timestamp_us)));
+		output.SetValue(col_idx++, count, entry.method);
+		output.SetValue(col_idx++, count, entry.url);
+		output.SetValue(col_idx++, count, entry.range.empty() ? Value(LogicalType::VARCHAR) : Value(entry.range));
+		// Status is meaningless for requests failed without a response.
+		output.SetValue(col_idx++, count,
+		                entry.status_code == 0 ? Value(LogicalType::USMALLINT) : Value::USMALLINT(entry.status_code));
+		output.SetValue(col_idx++, count,
+		                entry.request_error.empty() ? Value(LogicalType::VARCHAR) : Value(entry.request_error));
+		output.SetValue(col_idx++, count,
+		                entry.connection_id < 0 ? Value(LogicalType::BIGINT) : Value::BIGINT(entry.connection_id));
+		output.SetValue(col_idx++, count, Value::UBIGINT(entry.new_connections));
+		output.SetValue(col_idx++, count, Value::UBIGINT(entry.redirects));
+		output.SetValue(col_idx++, count, Value::UBIGINT(entry.bytes_received));
+		output.SetValue(col_idx++, count, Value::UBIGINT(entry.queue_us));
+		output.SetValue(col_idx++, count, Value::UBIGINT(entry.dns_us));
+		output.SetValue(col_idx++, count, Value::UBIGINT(entry.connect_us));
+		output.SetValue(col_idx++, count, Value::UBIGINT(entry.tls_us));
+		output.SetValue(col_idx++, count, Value::UBIGINT(entry.first_byte_us));
+		output.SetValue(col_idx++, count, Value::UBIGINT(entry.transfer_us));
+		output.SetValue(col_idx++, count, Value::UBIGINT(entry.total_us));
+		count++;
+	}
+	output.SetCardinality(count);
+}
+} // namespace
+
+TableFunction GetSlowRequestsFunc() {
+	TableFunction slow_requests_query_func {/*name=*/"curl_httpfs_slow_requests",
+	                                        /*arguments=*/ {},
+	                                        /*function=*/GetSlowRequestsTableFunc,
+	                                        /*bind=*/GetSlowRequestsFuncBind,
+	                                        /*init_global=*/GetSlowRequestsFuncInit};
+	return slow_requests_query_func;
+}
+} // namespace duckdb
@@ -2,19 +2,29 @@
 
 #if defined(__APPLE__) || defined(__MACH__)
 #include <cstdio>
+#include <cstdlib>
 #include <sstream>
+#include <stdexcept>
 #else
+#include <algorithm>
 #include <arpa/inet.h>
 #include <array>
-#include <fcntl.h>
-#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <linux/inet_diag.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/sock_diag.h>
+#include <linux/tcp.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
 #include <unistd.h>
-#include <sstream>
+#include "duckdb/common/unordered_set.hpp"
 #include "syscall_macros.hpp"
 #endif
 
 #include "duckdb/common/string.hpp"
-#include "duckdb/common/unordered_map.hpp"
 
 namespace duckdb {
 
@@ -23,8 +33,23 @@ namespace duckdb {
 //===--------------------------------------------------------------------===//
 #if defined(__APPLE__) || defined(__MACH__)
 
-unordered_map<string, int> GetTcpConnectionNum() {
-	unordered_map<string, int> aggregated_tcp_conns;
+namespace {
+
+// Split netstat address `a.b.c.d.port` into IP and port.
+void ParseNetstatAddress(const string &address, string &ip, uint16_t &port) {
+	const size_t last_dot = address.rfind('.');
+	if (last_dot == string::npos) {
+		ip = address;
+		return;
+	}
+	ip = address.substr(0, last_dot);
+	port = static_cast<uint16_t>(std::strtoul(address.c_str() + last_dot + 1, nullptr, 10));
+}
+
+} // namespace
+
+vector<TcpConnectionInfo> GetTcpConnections() {
+	vector<TcpConnectionInfo> tcp_conns;
 
 	FILE *fp = popen("netstat -anv -p tcp", "r");
 	if (fp == nullptr) {
@@ -55,20 +80,15 @@ unordered_map<string, int> GetTcpConnectionNum() {
 			continue;
 		}
 
-		// Extract IP (before ':').
-		auto colon = remote.find('.');
-		if (colon == string::npos)
-			continue;
-
-		// IPv4 style “remote.port”.
-		// We can find the *last* '.' as separator.
-		size_t last_dot = remote.rfind('.');
-		string ip = (last_dot == string::npos) ? remote : remote.substr(0, last_dot);
-		++aggregated_tcp_conns[std::move(ip)];
+		TcpConnectionInfo cur_conn;
+		ParseNetstatAddress(local, cur_conn.local_ip, cur_conn.local_port);
+		ParseNetstatAddress(remote, cur_conn.remote_ip, cur_conn.remote_port);
+		cur_conn.state = std::move(state);
+		tcp_conns.emplace_back(std::move(cur_conn));
 	}
 
 	pclose(fp);
-	return aggregated_tcp_conns;
+	return tcp_conns;
 }
 
 //===--------------------------------------------------------------------===//
@@ -77,83 +97,162 @@ unordered_map<string, int> GetTcpConnectionNum() {
 #else
 
 namespace {
-constexpr const char *IPV4_TCP_PROC_FS_PATH = "/proc/net/tcp";
-constexpr const char *IPV6_TCP_PROC_FS_PATH = "/proc/net/tcp6";
-
-string HexToIP(const string &hex) {
-	if (hex.size() != 8) {
-		return "0.0.0.0";
-	}
-
-	// Read little-endian 32-bit into reverse byte order.
-	std::array<unsigned char, 4> bytes {};
-	for (int idx = 0; idx < 4; ++idx) {
-		string byte_str = hex.substr(idx * 2, 2);
-		bytes[idx] = static_cast<unsigned char>(std::stoul(byte_str, nullptr, 16));
-	}
+constexpr const char *PROCESS_FD_DIR = "/proc/self/fd";
+// Prefix of the fd link target for sockets, which looks like `socket:[<inode>]`.
+constexpr const char *SOCKET_LINK_PREFIX = "socket:[";
+// Netlink dump responses are batched into messages up to page size, a larger buffer fits several at once.
+constexpr size_t NETLINK_BUF_SIZE = 32 * 1024;
 
-	// Reverse the order of 4 bytes.
-	std::array<unsigned char, 4> reversed = {bytes[3], bytes[2], bytes[1], bytes[0]};
+// Indexed by kernel TCP state, see `include/net/tcp_states.h`.
+constexpr std::array<const char *, 13> TCP_STATE_NAMES = {
+    "UNKNOWN",   "ESTABLISHED", "SYN_SENT", "SYN_RECV", "FIN_WAIT1", "FIN_WAIT2",   "TIME_WAIT",
+    "CLOSE",     "CLOSE_WAIT",  "LAST_ACK", "LISTEN",   "CLOSING",   "NEW_SYN_RECV",
+};
 
-	// Convert IPv4 and IPv6 addresses from binary to text form.
-	std::array<char, INET_ADDRSTRLEN> buf {};
-	inet_ntop(AF_INET, reversed.data(), buf.data(), sizeof(buf));
-	return string(buf.data());
+const char *GetTcpStateName(uint8_t state) {
+	return state < TCP_STATE_NAMES.size() ? TCP_STATE_NAMES[state] : TCP_STATE_NAMES[0];
 }
 
-// @param path: local procfs path.
-// @param[out] per_remote_ip: aggregated <IP, count> pair.
-void ParseProcTCP(const char *path, unordered_map<string, int> &per_remote_ip) {
-	int fd = open(path, O_RDONLY);
-	SYSCALL_THROW_IF_ERROR(fd);
-
-	constexpr size_t BUF_SIZE = 65536;
-	string content;
-	content.reserve(BUF_SIZE);
-	char buf[BUF_SIZE];
-	ssize_t n = 0;
-	while ((n = read(fd, buf, sizeof(buf))) > 0) {
-		content.append(buf, n);
+// Closes the owned fd on destruction.
+struct FdGuard {
+	int fd = -1;
+	~FdGuard() {
+		if (fd >= 0) {
+			close(fd);
+		}
 	}
-	const int ret = close(fd);
-	SYSCALL_THROW_IF_ERROR(ret);
+};
 
-	// Ignore the first line, which is the prompt line.
-	// For example, "State Recv-Q Send-Q Local Address:Port   Peer Address:Port Process".
-	std::istringstream iss(content);
-	string cur_line;
-	std::getline(iss, cur_line);
-
-	while (std::getline(iss, cur_line)) {
-		if (cur_line.empty()) {
+// Get inodes of all sockets opened by the current process.
+unordered_set<uint64_t> GetProcessSocketInodes() {
+	DIR *dir = opendir(PROCESS_FD_DIR);
+	if (dir == nullptr) {
+		SYSCALL_THROW_IF_ERROR(-1);
+	}
+	const size_t prefix_len = std::strlen(SOCKET_LINK_PREFIX);
+	unordered_set<uint64_t> inodes;
+	std::array<char, 64> link {};
+	struct dirent *entry = nullptr;
+	while ((entry = readdir(dir)) != nullptr) {
+		if (entry->d_name[0] == '.') {
 			continue;
 		}
+		// Fds closed in the meantime fail to resolve, which are skipped.
+		const ssize_t len = readlinkat(dirfd(dir), entry->d_name, link.data(), link.size() - 1);
+		if (len <= 0) {
+			continue;
+		}
+		link[len] = '\0';
+		if (std::strncmp(link.data(), SOCKET_LINK_PREFIX, prefix_len) != 0) {
+			continue;
+		}
+		inodes.insert(std::strtoull(link.data() + prefix_len, nullptr, 10));
+	}
+	closedir(dir);
+	return inodes;
+}
 
-		std::istringstream ls(cur_line);
-		string sl, local, remote, state;
-		ls >> sl >> local >> remote >> state;
-		if (remote.empty() || state.empty()) {
+// Fill in connection status from the given sock_diag message.
+TcpConnectionInfo ParseInetDiagMsg(const struct nlmsghdr *nlh) {
+	const auto *msg = reinterpret_cast<const struct inet_diag_msg *>(NLMSG_DATA(nlh));
+	TcpConnectionInfo conn;
+	std::array<char, INET6_ADDRSTRLEN> addr_buf {};
+	inet_ntop(msg->idiag_family, msg->id.idiag_src, addr_buf.data(), addr_buf.size());
+	conn.local_ip = addr_buf.data();
+	inet_ntop(msg->idiag_family, msg->id.idiag_dst, addr_buf.data(), addr_buf.size());
+	conn.remote_ip = addr_buf.data();
+	conn.local_port = ntohs(msg->id.idiag_sport);
+	conn.remote_port = ntohs(msg->id.idiag_dport);
+	conn.state = GetTcpStateName(msg->idiag_state);
+
+	// TCP_INFO is attached as an attribute after the message, older kernels provide a shorter struct.
+	auto attr_len = static_cast<int>(nlh->nlmsg_len - NLMSG_LENGTH(sizeof(*msg)));
+	for (auto *attr = reinterpret_cast<const struct rtattr *>(msg + 1); RTA_OK(attr, attr_len);
+	     attr = RTA_NEXT(attr, attr_len)) {
+		if (attr->rta_type != INET_DIAG_INFO) {
 			continue;
 		}
+		struct tcp_info info {};
+		std::memcpy(&info, RTA_DATA(attr), std::min<size_t>(RTA_PAYLOAD(attr), sizeof(info)));
+		conn.has_tcp_info = true;
+		conn.rtt_us = info.tcpi_rtt;
+		conn.rtt_var_us = info.tcpi_rttvar;
+		conn.cwnd = info.tcpi_snd_cwnd;
+		conn.retransmits = info.tcpi_total_retrans;
+		conn.bytes_acked = info.tcpi_bytes_acked;
+		conn.bytes_received = info.tcpi_bytes_received;
+	}
+	return conn;
+}
+
+// Dump TCP sockets of the given address family via sock_diag, and collect those whose inode is in [`inodes`].
+void DumpTcpConnections(uint8_t family, const unordered_set<uint64_t> &inodes, vector<TcpConnectionInfo> &tcp_conns) {
+	FdGuard netlink_fd;
+	netlink_fd.fd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_SOCK_DIAG);
+	SYSCALL_THROW_IF_ERROR(netlink_fd.fd);
+
+	struct {
+		struct nlmsghdr nlh;
+		struct inet_diag_req_v2 req;
+	} request {};
+	request.nlh.nlmsg_len = sizeof(request);
+	request.nlh.nlmsg_type = SOCK_DIAG_BY_FAMILY;
+	request.nlh.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+	request.req.sdiag_family = family;
+	request.req.sdiag_protocol = IPPROTO_TCP;
+	// Dump sockets in all states, with TCP_INFO attached.
+	request.req.idiag_states = ~0U;
+	request.req.idiag_ext = 1 << (INET_DIAG_INFO - 1);
 
-		// Parse remote address (format: "HEX_IP:HEX_PORT").
-		auto colon = remote.find(':');
-		if (colon == string::npos) {
+	struct sockaddr_nl kernel_addr {};
+	kernel_addr.nl_family = AF_NETLINK;
+	const ssize_t sent = sendto(netlink_fd.fd, &request, sizeof(request), /*flags=*/0,
+	                            reinterpret_cast<struct sockaddr *>(&kernel_addr), sizeof(kernel_addr));
+	SYSCALL_THROW_IF_ERROR(sent);
+
+	alignas(struct nlmsghdr) std::array<char, NETLINK_BUF_SIZE> buf;
+	while (true) {
+		ssize_t len = recv(netlink_fd.fd, buf.data(), buf.size(), /*flags=*/0);
+		if (len < 0 && errno == EINTR) {
 			continue;
 		}
-		string ip_hex = remote.substr(0, colon);
-		string ip = HexToIP(ip_hex);
-		++per_remote_ip[ip];
+		SYSCALL_THROW_IF_ERROR(len);
+		if (len == 0) {
+			return;
+		}
+		for (auto *nlh = reinterpret_cast<struct nlmsghdr *>(buf.data()); NLMSG_OK(nlh, len);
+		     nlh = NLMSG_NEXT(nlh, len)) {
+			if (nlh->nlmsg_type == NLMSG_DONE) {
+				return;
+			}
+			if (nlh->nlmsg_type == NLMSG_ERROR) {
+				const auto *err = reinterpret_cast<const struct nlmsgerr *>(NLMSG_DATA(nlh));
+				errno = -err->error;
+				SYSCALL_THROW_IF_ERROR(-1);
+			}
+			if (nlh->nlmsg_type != SOCK_DIAG_BY_FAMILY) {
+				continue;
+			}
+			// Sockets of all processes are dumped, only those owned by the current process are kept.
+			const auto *msg = reinterpret_cast<const struct inet_diag_msg *>(NLMSG_DATA(nlh));
+			if (inodes.find(msg->idiag_inode) == inodes.end()) {
+				continue;
+			}
+			tcp_conns.emplace_back(ParseInetDiagMsg(nlh));
+		}
 	}
 }
 } // namespace
 
-unordered_map<string, int> GetTcpConnectionNum() {
-	// Maps from IP to TCP connection count.
-	unordered_map<string, int> aggregated_tcp_conns;
-	ParseProcTCP(IPV4_TCP_PROC_FS_PATH, aggregated_tcp_conns);
-	ParseProcTCP(IPV6_TCP_PROC_FS_PATH, aggregated_tcp_conns);
-	return aggregated_tcp_conns;
+vector<TcpConnectionInfo> GetTcpConnections() {
+	const auto inodes = GetProcessSocketInodes();
+	vector<TcpConnectionInfo> tcp_conns;
+	if (inodes.empty()) {
+		return tcp_conns;
+	}
+	DumpTcpConnections(AF_INET, inodes, tcp_conns);
+	DumpTcpConnections(AF_INET6, inodes, tcp_conns);
+	return tcp_conns;
 }
 
 #endif
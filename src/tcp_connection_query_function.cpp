@@ -1,14 +1,12 @@
 #include "tcp_connection_query_function.hpp"
 
 #include <algorithm>
-#include <array>
+#include <tuple>
 #include <utility>
 
 #include "duckdb/common/helper.hpp"
-#include "duckdb/common/numeric_utils.hpp"
 #include "duckdb/common/string.hpp"
 #include "duckdb/common/unique_ptr.hpp"
-#include "duckdb/common/unordered_map.hpp"
 #include "duckdb/common/vector.hpp"
 #include "duckdb/function/table_function.hpp"
 #include "duckdb/main/client_context.hpp"
@@ -18,86 +16,102 @@ namespace duckdb {
 
 namespace {
 
-struct TcpConnectionStatus {
-	string ip;
-	// TCP connection count for the IP.
-	int count = 0;
-};
-
 //===--------------------------------------------------------------------===//
-// Get TCP connection number query function
+// Get TCP connection query function
 //===--------------------------------------------------------------------===//
 
 struct TcpConnectionData : public GlobalTableFunctionState {
-	vector<TcpConnectionStatus> tcp_connection_status;
+	vector<TcpConnectionInfo> tcp_conns;
 
 	// Used to record the progress of emission.
 	uint64_t offset = 0;
 };
 
-unique_ptr<FunctionData> GetTcpConnectionNumFuncBind(ClientContext &context, TableFunctionBindInput &input,
-                                                     vector<LogicalType> &return_types, vector<string> &names) {
+unique_ptr<FunctionData> GetTcpConnectionFuncBind(ClientContext &context, TableFunctionBindInput &input,
+                                                  vector<LogicalType> &return_types, vector<string> &names) {
 	ALWAYS_ASSERT(return_types.empty());
 	ALWAYS_ASSERT(names.empty());
 
-	return_types.reserve(2);
-	names.reserve(2);
-
 	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
-	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
-	names.emplace_back("IP");
-	names.emplace_back("TCP connection number");
+	names.emplace_back("remote_ip");
+	return_types.emplace_back(LogicalType {LogicalTypeId::INTEGER});
+	names.emplace_back("remote_port");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+	names.emplace_back("local_ip");
+	return_types.emplace_back(LogicalType {LogicalTypeId::INTEGER});
+	names.emplace_back("local_port");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+	names.emplace_back("state");
+	// Columns below are NULL where TCP_INFO is not available.
+	return_types.emplace_back(LogicalType {LogicalTypeId::UBIGINT});
+	names.emplace_back("rtt_us");
+	return_types.emplace_back(LogicalType {LogicalTypeId::UBIGINT});
+	names.emplace_back("rtt_var_us");
+	return_types.emplace_back(LogicalType {LogicalTypeId::UBIGINT});
+	names.emplace_back("cwnd");
+	return_types.emplace_back(LogicalType {LogicalTypeId::UBIGINT});
+	names.emplace_back("retransmits");
+	return_types.emplace_back(LogicalType {LogicalTypeId::UBIGINT});
+	names.emplace_back("bytes_acked");
+	return_types.emplace_back(LogicalType {LogicalTypeId::UBIGINT});
+	names.emplace_back("bytes_received");
 
 	return nullptr;
 }
 
-unique_ptr<GlobalTableFunctionState> GetTcpConnectionNumFuncInit(ClientContext &context,
-                                                                 TableFunctionInitInput &input) {
+unique_ptr<GlobalTableFunctionState> GetTcpConnectionFuncInit(ClientContext &context, TableFunctionInitInput &input) {
 	auto result = make_uniq<TcpConnectionData>();
-	auto &tcp_connection_status = result->tcp_connection_status;
-
-	auto tcp_connection_map = GetTcpConnectionNum();
-	tcp_connection_status.reserve(tcp_connection_map.size());
-	for (const auto &[cur_ip, cur_cnt] : tcp_connection_map) {
-		TcpConnectionStatus cur_tcp_conn_status;
-		cur_tcp_conn_status.ip = cur_ip;
-		cur_tcp_conn_status.count = cur_cnt;
-		tcp_connection_status.emplace_back(std::move(cur_tcp_conn_status));
-	}
+	auto &tcp_conns = result->tcp_conns;
+	tcp_conns = GetTcpConnections();
 
-	// Sort by IP to provide stable output.
-	std::sort(tcp_connection_status.begin(), tcp_connection_status.end(),
-	          [](const TcpConnectionStatus &a, const TcpConnectionStatus &b) { return a.ip < b.ip; });
+	// Sort by remote address to provide stable output.
+	std::sort(tcp_conns.begin(), tcp_conns.end(), [](const TcpConnectionInfo &lhs, const TcpConnectionInfo &rhs) {
+		return std::tie(lhs.remote_ip, lhs.remote_port, lhs.local_ip, lhs.local_port) <
+		       std::tie(rhs.remote_ip, rhs.remote_port, rhs.local_ip, rhs.local_port);
+	});
 
 	return std::move(result);
 }
 
-void GetTcpConnectionNumTableFunc(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+void GetTcpConnectionTableFunc(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
 	auto &data = data_p.global_state->Cast<TcpConnectionData>();
 
 	// All entries have been emitted.
-	if (data.offset >= data.tcp_connection_status.size()) {
+	if (data.offset >= data.tcp_conns.size()) {
 		return;
 	}
 
 	// Start filling in the result buffer.
 	idx_t count = 0;
-	while (data.offset < data.tcp_connection_status.size() && count < STANDARD_VECTOR_SIZE) {
-		auto &entry = data.tcp_connection_status[data.offset++];
-		output.SetValue(/*col_idx=*/0, count, entry.ip);
-		output.SetValue(/*col_idx=*/1, count, entry.count);
+	while (data.offset < data.tcp_conns.size() && count < STANDARD_VECTOR_SIZE) {
+		auto &entry = data.tcp_conns[data.offset++];
+		idx_t col_idx = 0;
+		output.SetValue(col_idx++, count, entry.remote_ip);
+		output.SetValue(col_idx++, count, Value::INTEGER(entry.remote_port));
+		output.SetValue(col_idx++, count, entry.local_ip);
+		output.SetValue(col_idx++, count, Value::INTEGER(entry.local_port));
+		output.SetValue(col_idx++, count, entry.state);
+		auto tcp_info_value = [&entry](uint64_t value) {
+			return entry.has_tcp_info ? Value::UBIGINT(value) : Value(LogicalType {LogicalTypeId::UBIGINT});
+		};
+		output.SetValue(col_idx++, count, tcp_info_value(entry.rtt_us));
+		output.SetValue(col_idx++, count, tcp_info_value(entry.rtt_var_us));
+		output.SetValue(col_idx++, count, tcp_info_value(entry.cwnd));
+		output.SetValue(col_idx++, count, tcp_info_value(entry.retransmits));
+		output.SetValue(col_idx++, count, tcp_info_value(entry.bytes_acked));
+		output.SetValue(col_idx++, count, tcp_info_value(entry.bytes_received));
 		count++;
 	}
 	output.SetCardinality(count);
 }
 } // namespace
 
-TableFunction GetTcpConnectionNumFunc() {
+TableFunction GetTcpConnectionFunc() {
 	TableFunction get_tcp_conn_query_func {/*name=*/"curl_httpfs_get_tcp_connection",
 	                                       /*arguments=*/ {},
-	                                       /*function=*/GetTcpConnectionNumTableFunc,
-	                                       /*bind=*/GetTcpConnectionNumFuncBind,
-	                                       /*init_global=*/GetTcpConnectionNumFuncInit};
+	                                       /*function=*/GetTcpConnectionTableFunc,
+	                                       /*bind=*/GetTcpConnectionFuncBind,
+	                                       /*init_global=*/GetTcpConnectionFuncInit};
 	return get_tcp_conn_query_func;
 }
 } // namespace duckdb
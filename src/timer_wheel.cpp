@@ -0,0 +1,90 @@
+#include "timer_wheel.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#include "duckdb/common/assert.hpp"
+
+namespace duckdb {
+
+TimerWheel::TimerWheel(int64_t tick_ms_p, idx_t slot_count) : tick_ms(tick_ms_p), slots(slot_count) {
+	D_ASSERT(tick_ms > 0);
+	D_ASSERT(slot_count > 0);
+}
+
+void TimerWheel::Add(int64_t deadline_ms, uint64_t id) {
+	int64_t tick = deadline_ms / tick_ms;
+	if (current_tick < 0) {
+		current_tick = tick;
+	}
+	// Deadlines already passed are placed onto the next slot to scan.
+	tick = std::max(tick, current_tick);
+	slots[static_cast<idx_t>(tick % static_cast<int64_t>(slots.size()))].emplace_back(Entry {deadline_ms, id});
+	if (size == 0) {
+		earliest_deadline_ms = deadline_ms;
+		earliest_deadline_valid = true;
+	} else if (earliest_deadline_valid) {
+		earliest_deadline_ms = std::min(earliest_deadline_ms, deadline_ms);
+	}
+	++size;
+}
+
+bool TimerWheel::Remove(int64_t deadline_ms, uint64_t id) {
+	if (size == 0) {
+		return false;
+	}
+	// Unexpired deadlines stay in the slot of their own tick, or the current tick if they had passed when added.
+	const int64_t tick = std::max(deadline_ms / tick_ms, current_tick);
+	auto &slot = slots[static_cast<idx_t>(tick % static_cast<int64_t>(slots.size()))];
+	for (idx_t idx = 0; idx < slot.size(); ++idx) {
+		if (slot[idx].id != id || slot[idx].deadline_ms != deadline_ms) {
+			continue;
+		}
+		slot[idx] = slot.back();
+		slot.pop_back();
+		--size;
+		if (earliest_deadline_valid && deadline_ms <= earliest_deadline_ms) {
+			earliest_deadline_valid = false;
+		}
+		return true;
+	}
+	return false;
+}
+
+int64_t TimerWheel::GetTimeoutMs(int64_t now_ms) {
+	if (size == 0) {
+		return -1;
+	}
+	if (!earliest_deadline_valid) {
+		earliest_deadline_ms = FindEarliestDeadlineMs();
+		earliest_deadline_valid = true;
+	}
+	return std::max<int64_t>(earliest_deadline_ms - now_ms, 0);
+}
+
+int64_t TimerWheel::FindEarliestDeadlineMs() const {
+	// The first slot holding a deadline of the current round holds the earliest one, since deadlines in slots before
+	// it belong to later rounds, and those in slots after it are later.
+	const int64_t slot_count = static_cast<int64_t>(slots.size());
+	for (int64_t tick = current_tick; tick < current_tick + slot_count; ++tick) {
+		const auto &slot = slots[static_cast<idx_t>(tick % slot_count)];
+		const int64_t tick_end_ms = (tick + 1) * tick_ms;
+		int64_t earliest_ms = tick_end_ms;
+		for (const auto &cur_entry : slot) {
+			earliest_ms = std::min(earliest_ms, cur_entry.deadline_ms);
+		}
+		if (earliest_ms < tick_end_ms) {
+			return earliest_ms;
+		}
+	}
+	// All deadlines belong to later rounds.
+	int64_t earliest_ms = std::numeric_limits<int64_t>::max();
+	for (const auto &cur_slot : slots) {
+		for (const auto &cur_entry : cur_slot) {
+			earliest_ms = std::min(earliest_ms, cur_entry.deadline_ms);
+		}
+	}
+	return earliest_ms;
+}
+
+} // namespace duckdb
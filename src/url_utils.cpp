@@ -0,0 +1,18 @@
+#include "url_utils.hpp"
+
+#include <cstring>
+
+namespace duckdb {
+
+string GetUrlHost(const string &url) {
+	constexpr const char *SCHEME_SEPARATOR = "://";
+	const auto scheme_pos = url.find(SCHEME_SEPARATOR);
+	const size_t host_start = scheme_pos == string::npos ? 0 : scheme_pos + strlen(SCHEME_SEPARATOR);
+	const auto host_end = url.find_first_of("/?#", host_start);
+	if (host_end == string::npos) {
+		return url.substr(host_start);
+	}
+	return url.substr(host_start, host_end - host_start);
+}
+
+} // namespace duckdb
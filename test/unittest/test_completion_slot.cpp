@@ -0,0 +1,103 @@
+#include "catch.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "completion_slot.hpp"
+#include "duckdb/common/helper.hpp"
+#include "duckdb/common/vector.hpp"
+
+using namespace duckdb;
+
+namespace {
+
+constexpr int WAITER_COUNT = 8;
+constexpr int REQUESTS_PER_WAITER = 2000;
+
+} // namespace
+
+TEST_CASE("CompletionSlot delivers response completed before wait", "[completion_slot]") {
+	auto *slot = CompletionSlot::Acquire();
+	REQUIRE_FALSE(slot->Complete(make_uniq<HTTPResponse>(HTTPStatusCode::OK_200)));
+	auto response = slot->Wait();
+	REQUIRE(response != nullptr);
+	REQUIRE(response->status == HTTPStatusCode::OK_200);
+	CompletionSlot::Release(slot);
+
+	// Released slot is recycled by the same thread.
+	REQUIRE(CompletionSlot::Acquire() == slot);
+	CompletionSlot::Release(slot);
+}
+
+TEST_CASE("CompletionSlot wakes up parked waiter", "[completion_slot]") {
+	auto *slot = CompletionSlot::Acquire();
+	std::thread completer([slot]() {
+		// Give the waiter a chance to park.
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		if (slot->Complete(make_uniq<HTTPResponse>(HTTPStatusCode::NotFound_404))) {
+			slot->Wake();
+		}
+	});
+	auto response = slot->Wait();
+	completer.join();
+	REQUIRE(response->status == HTTPStatusCode::NotFound_404);
+	CompletionSlot::Release(slot);
+}
+
+TEST_CASE("CompletionSlot delivers responses to concurrent waiters", "[completion_slot]") {
+	// Completed in batches by a single thread, as the eventloop does.
+	std::mutex mu;
+	vector<std::pair<CompletionSlot *, int>> submitted;
+	std::atomic<bool> stopped {false};
+	std::thread completer([&]() {
+		vector<CompletionSlot *> slots_to_wake;
+		while (!stopped.load()) {
+			vector<std::pair<CompletionSlot *, int>> batch;
+			{
+				const std::lock_guard<std::mutex> lck(mu);
+				batch.swap(submitted);
+			}
+			for (auto &cur : batch) {
+				auto response = make_uniq<HTTPResponse>(HTTPStatusCode::OK_200);
+				response->body = std::to_string(cur.second);
+				if (cur.first->Complete(std::move(response))) {
+					slots_to_wake.emplace_back(cur.first);
+				}
+			}
+			for (auto *cur_slot : slots_to_wake) {
+				cur_slot->Wake();
+			}
+			slots_to_wake.clear();
+			std::this_thread::yield();
+		}
+	});
+
+	vector<std::thread> waiters;
+	std::atomic<int> mismatch_count {0};
+	for (int waiter_idx = 0; waiter_idx < WAITER_COUNT; ++waiter_idx) {
+		waiters.emplace_back([&, waiter_idx]() {
+			for (int req_idx = 0; req_idx < REQUESTS_PER_WAITER; ++req_idx) {
+				const int value = waiter_idx * REQUESTS_PER_WAITER + req_idx;
+				auto *slot = CompletionSlot::Acquire();
+				{
+					const std::lock_guard<std::mutex> lck(mu);
+					submitted.emplace_back(slot, value);
+				}
+				auto response = slot->Wait();
+				CompletionSlot::Release(slot);
+				if (response->body != std::to_string(value)) {
+					++mismatch_count;
+				}
+			}
+		});
+	}
+	for (auto &cur_waiter : waiters) {
+		cur_waiter.join();
+	}
+	stopped.store(true);
+	completer.join();
+	REQUIRE(mismatch_count.load() == 0);
+}
@@ -0,0 +1,115 @@
+#include "catch.hpp"
+
+#include <chrono>
+#include <curl/curl.h>
+#include <thread>
+
+#include "curl_completion_queue.hpp"
+#include "curl_request.hpp"
+#include "duckdb/common/helper.hpp"
+#include "duckdb/common/unique_ptr.hpp"
+#include "duckdb/common/vector.hpp"
+#include "extension_config.hpp"
+#include "loopback_listener.hpp"
+#include "multi_curl_manager.hpp"
+
+using namespace duckdb;
+
+namespace {
+
+// Deadline for requests under test, which never get responded.
+constexpr auto REQUEST_DEADLINE = std::chrono::milliseconds(1000);
+// Upper bound for tasks and requests to complete.
+constexpr auto MAX_COMPLETION_LATENCY = std::chrono::seconds(5);
+
+// Set the per-host connection limit for the given eventloop, and restore the previous one on destruction, so a failed
+// test doesn't leak the limit into others.
+class ScopedConnectionLimit {
+public:
+	ScopedConnectionLimit(CurlEventLoop &event_loop_p, uint64_t limit)
+	    : event_loop(event_loop_p), previous_limit(MAX_CONNECTIONS_PER_HOST.load()) {
+		MAX_CONNECTIONS_PER_HOST = limit;
+		event_loop.RefreshConnectionLimits();
+	}
+	~ScopedConnectionLimit() {
+		MAX_CONNECTIONS_PER_HOST = previous_limit;
+		event_loop.RefreshConnectionLimits();
+	}
+
+	// Disable copy / move constructor / assignment.
+	ScopedConnectionLimit(const ScopedConnectionLimit &) = delete;
+	ScopedConnectionLimit &operator=(const ScopedConnectionLimit &) = delete;
+
+private:
+	CurlEventLoop &event_loop;
+	const uint64_t previous_limit;
+};
+
+// Block until all tasks posted to the eventloop before are run.
+void WaitForTasks(CurlEventLoop &event_loop) {
+	CurlCompletionQueue completion_queue;
+	event_loop.PostTask(
+	    [&completion_queue]() { completion_queue.Push(/*tag=*/0, make_uniq<HTTPResponse>(HTTPStatusCode::OK_200)); });
+	CurlCompletionQueue::Completion completion;
+	REQUIRE(completion_queue.PopWithTimeout(completion, MAX_COMPLETION_LATENCY));
+}
+
+} // namespace
+
+TEST_CASE("Eventloop runs posted tasks in order on its own thread", "[multi_curl][task]") {
+	// Eventloops are never destroyed.
+	auto *event_loop = new CurlEventLoop();
+	vector<int> task_order;
+	std::thread::id task_thread_id;
+	for (int idx = 0; idx < 10; ++idx) {
+		event_loop->PostTask([&task_order, &task_thread_id, idx]() {
+			task_order.emplace_back(idx);
+			task_thread_id = std::this_thread::get_id();
+		});
+	}
+	WaitForTasks(*event_loop);
+	REQUIRE(task_order == vector<int> {0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+	REQUIRE(task_thread_id != std::this_thread::get_id());
+}
+
+TEST_CASE("Eventloop applies connection limit at runtime", "[multi_curl][connection_limit]") {
+	curl_global_init(CURL_GLOBAL_DEFAULT);
+	LoopbackListener listener;
+	auto *event_loop = new CurlEventLoop();
+
+	ScopedConnectionLimit connection_limit(*event_loop, /*limit=*/1);
+	WaitForTasks(*event_loop);
+
+	constexpr idx_t REQUEST_COUNT = 4;
+	CurlCompletionQueue completion_queue;
+	vector<CURL *> easy_curls;
+	const auto submit_time = std::chrono::steady_clock::now();
+	for (idx_t idx = 0; idx < REQUEST_COUNT; ++idx) {
+		easy_curls.emplace_back(curl_easy_init());
+		auto req = make_uniq<CurlRequest>(easy_curls.back());
+		req->SetUrl(listener.GetUrl());
+		req->SetGetAttrs();
+		req->SetDeadline(submit_time + REQUEST_DEADLINE);
+		req->SetCompletionCallback(completion_queue.CreateCallback(/*tag=*/idx));
+		event_loop->SubmitRequest(std::move(req));
+	}
+
+	// Requests beyond the limit are queued by curl, instead of opening new connections. Connections are polled until
+	// half of the request deadline, well before the only allowed one gets freed up.
+	const auto poll_deadline = submit_time + REQUEST_DEADLINE / 2;
+	idx_t connection_count = listener.AcceptPending();
+	while (connection_count <= 1 && std::chrono::steady_clock::now() < poll_deadline) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		connection_count = listener.AcceptPending();
+	}
+	REQUIRE(connection_count == 1);
+
+	for (idx_t idx = 0; idx < REQUEST_COUNT; ++idx) {
+		CurlCompletionQueue::Completion completion;
+		REQUIRE(completion_queue.PopWithTimeout(completion, MAX_COMPLETION_LATENCY));
+		REQUIRE(completion.response->HasRequestError());
+	}
+	for (auto *easy_curl : easy_curls) {
+		curl_easy_cleanup(easy_curl);
+	}
+}
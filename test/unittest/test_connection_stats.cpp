@@ -0,0 +1,65 @@
+#include "catch.hpp"
+
+#include <curl/curl.h>
+
+#include "connection_stats_registry.hpp"
+#include "curl_request.hpp"
+#include "duckdb/common/helper.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "extension_config.hpp"
+#include "loopback_listener.hpp"
+#include "loopback_range_server.hpp"
+#include "multi_curl_manager.hpp"
+#include "url_utils.hpp"
+
+using namespace duckdb;
+
+namespace {
+
+constexpr int REQUEST_COUNT = 3;
+
+void PerformRequests(const string &url, int request_count) {
+	CURL *easy_curl = curl_easy_init();
+	for (int idx = 0; idx < request_count; ++idx) {
+		auto req = make_uniq<CurlRequest>(easy_curl);
+		req->SetUrl(url);
+		req->SetGetAttrs();
+		MultiCurlManager::GetInstance().HandleRequest(std::move(req));
+	}
+	curl_easy_cleanup(easy_curl);
+}
+
+} // namespace
+
+TEST_CASE("Connection stats count reused connections per host", "[connection_stats]") {
+	curl_global_init(CURL_GLOBAL_DEFAULT);
+	LoopbackRangeServer server;
+	server.PutObject("/", "");
+
+	// Route all requests to the same eventloop, whose connection cache keeps the connection for the next request.
+	EVENT_LOOP_ROUTING = EventLoopRouting::HOST;
+	PerformRequests(server.GetUrl("/"), REQUEST_COUNT);
+	EVENT_LOOP_ROUTING = DEFAULT_EVENT_LOOP_ROUTING;
+
+	REQUIRE(server.GetRequestCount() == REQUEST_COUNT);
+	const string host = StringUtil::Format("127.0.0.1:%d", server.GetPort());
+	auto &stats = ConnectionStatsRegistry::GetInstance().GetOrCreate(host);
+	REQUIRE(stats.requests.load() == REQUEST_COUNT);
+	REQUIRE(stats.new_connections.load() == 1);
+	REQUIRE(stats.reused_connections.load() == REQUEST_COUNT - 1);
+	REQUIRE(stats.tls_handshakes.load() == 0);
+	REQUIRE(stats.http2_requests.load() == 0);
+}
+
+TEST_CASE("Connection stats don't count failed connects as reused", "[connection_stats]") {
+	curl_global_init(CURL_GLOBAL_DEFAULT);
+	// Other tests may have requested the same address, so only changes are checked.
+	auto &stats = ConnectionStatsRegistry::GetInstance().GetOrCreate(GetUrlHost(UNREACHABLE_URL));
+	const uint64_t prev_requests = stats.requests.load();
+	const uint64_t prev_reused_connections = stats.reused_connections.load();
+
+	PerformRequests(UNREACHABLE_URL, REQUEST_COUNT);
+
+	REQUIRE(stats.requests.load() - prev_requests == REQUEST_COUNT);
+	REQUIRE(stats.reused_connections.load() == prev_reused_connections);
+}
@@ -0,0 +1,84 @@
+#include "catch.hpp"
+
+#include <chrono>
+#include <curl/curl.h>
+#include <thread>
+
+#include "curl_handle_pool.hpp"
+#include "duckdb/common/helper.hpp"
+#include "duckdb/common/http_util.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/common/vector.hpp"
+#include "httpfs_client.hpp"
+#include "loopback_range_server.hpp"
+#include "multi_curl_client.hpp"
+#include "multi_curl_util.hpp"
+
+using namespace duckdb;
+
+namespace {
+
+// Number of threads issuing requests on the same client.
+constexpr idx_t THREAD_COUNT = 8;
+
+} // namespace
+
+TEST_CASE("CurlHandlePool hands out distinct handles and reuses released ones", "[curl_handle_pool]") {
+	curl_global_init(CURL_GLOBAL_DEFAULT);
+
+	CurlHandlePool pool(make_uniq<CURLHandle>(/*token=*/"", /*cert_path=*/""));
+	REQUIRE(pool.GetIdleHandleCount() == 0);
+	{
+		auto handle1 = pool.Acquire();
+		auto handle2 = pool.Acquire();
+		REQUIRE(handle1->Get() != nullptr);
+		REQUIRE(handle1->Get() != handle2->Get());
+	}
+	REQUIRE(pool.GetIdleHandleCount() == 2);
+
+	auto handle = pool.Acquire();
+	REQUIRE(pool.GetIdleHandleCount() == 1);
+}
+
+TEST_CASE("MultiCurlClient serves concurrent requests on one client", "[curl_handle_pool][multi_curl]") {
+	curl_global_init(CURL_GLOBAL_DEFAULT);
+
+	// Responses are delayed, so requests of all threads are in flight on the client at the same time.
+	LoopbackRangeServerConfig config;
+	config.latency = std::chrono::milliseconds(50);
+	LoopbackRangeServer server(config);
+	for (idx_t idx = 0; idx < THREAD_COUNT; ++idx) {
+		server.PutObject(StringUtil::Format("/object_%llu", idx), StringUtil::Format("content_%llu", idx));
+	}
+
+	MultiCurlUtil http_util;
+	HTTPFSParams params(http_util);
+	params.timeout = 10;
+	params.enable_curl_server_cert_verification = false;
+	MultiCurlClient client(params, server.GetUrl("/"));
+
+	vector<std::thread> threads;
+	threads.reserve(THREAD_COUNT);
+	// Catch assertions are not thread-safe, so responses are checked after join.
+	vector<unique_ptr<HTTPResponse>> responses(THREAD_COUNT);
+	for (idx_t idx = 0; idx < THREAD_COUNT; ++idx) {
+		threads.emplace_back([&client, &params, &server, &responses, idx]() {
+			const string url = server.GetUrl(StringUtil::Format("/object_%llu", idx));
+			HTTPHeaders headers;
+			GetRequestInfo request(url, headers, params, nullptr, nullptr);
+			responses[idx] = client.Get(request);
+		});
+	}
+	for (auto &cur_thread : threads) {
+		cur_thread.join();
+	}
+
+	for (idx_t idx = 0; idx < THREAD_COUNT; ++idx) {
+		REQUIRE(responses[idx] != nullptr);
+		REQUIRE_FALSE(responses[idx]->HasRequestError());
+		REQUIRE(responses[idx]->status == HTTPStatusCode::OK_200);
+		REQUIRE(responses[idx]->body == StringUtil::Format("content_%llu", idx));
+	}
+	// Every thread took its own handle, and all of them are back in the pool.
+	REQUIRE(client.GetIdleHandleCount() == THREAD_COUNT);
+}
@@ -0,0 +1,111 @@
+#include "catch.hpp"
+
+#include <cstring>
+
+#include "curl_request.hpp"
+#include "debug_event_ring.hpp"
+#include "duckdb/common/helper.hpp"
+#include "duckdb/common/string.hpp"
+#include "extension_config.hpp"
+#include "loopback_listener.hpp"
+#include "multi_curl_manager.hpp"
+
+using namespace duckdb;
+
+namespace {
+
+void AppendText(DebugEventRing &ring, const string &text, uint64_t request_id) {
+	ring.Append(CURLINFO_TEXT, text.data(), text.size(), request_id);
+}
+
+string GetData(const DebugEvent &event) {
+	return string(event.data.data(), event.data_len);
+}
+
+} // namespace
+
+TEST_CASE("DebugEventRing keeps text and headers only", "[debug_event_ring]") {
+	DebugEventRing ring;
+	REQUIRE(ring.Snapshot().empty());
+
+	AppendText(ring, "Connected to 127.0.0.1\n", /*request_id=*/1);
+	const string header_out = "GET /data.parquet HTTP/1.1\r\nHost: 127.0.0.1\r\nAuthorization: secret\r\n\r\n";
+	ring.Append(CURLINFO_HEADER_OUT, header_out.data(), header_out.size(), /*request_id=*/1);
+	const string header_in = "HTTP/1.1 206 Partial Content\r\n";
+	ring.Append(CURLINFO_HEADER_IN, header_in.data(), header_in.size(), /*request_id=*/1);
+	// Body and TLS data are never recorded.
+	const string body = "payload";
+	ring.Append(CURLINFO_DATA_IN, body.data(), body.size(), /*request_id=*/1);
+	ring.Append(CURLINFO_SSL_DATA_OUT, body.data(), body.size(), /*request_id=*/1);
+
+	const auto events = ring.Snapshot();
+	REQUIRE(events.size() == 3);
+	REQUIRE(events[0].type == DebugEvent::Type::TEXT);
+	REQUIRE(GetData(events[0]) == "Connected to 127.0.0.1");
+	REQUIRE(events[1].type == DebugEvent::Type::HEADER_OUT);
+	REQUIRE(GetData(events[1]) == "GET /data.parquet HTTP/1.1");
+	REQUIRE(events[2].type == DebugEvent::Type::HEADER_IN);
+	REQUIRE(GetData(events[2]) == "HTTP/1.1 206 Partial Content");
+	for (const auto &cur_event : events) {
+		REQUIRE(cur_event.request_id == 1);
+		REQUIRE(cur_event.timestamp_us > 0);
+	}
+}
+
+TEST_CASE("DebugEventRing drops credentials of presigned URLs and HTTP/2 headers", "[debug_event_ring]") {
+	DebugEventRing ring;
+	const string header_out = "GET /bucket/data.parquet?X-Amz-Credential=key%2F20240101&X-Amz-Signature=0123abcd "
+	                          "HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n";
+	ring.Append(CURLINFO_HEADER_OUT, header_out.data(), header_out.size(), /*request_id=*/1);
+	// HTTP/2 request headers are listed as text.
+	AppendText(ring, "[HTTP/2] [1] [Authorization: AWS4-HMAC-SHA256 Credential=secret]\n", /*request_id=*/1);
+	AppendText(ring, "[HTTP/2] [1] [range: bytes=0-3]\n", /*request_id=*/1);
+
+	const auto events = ring.Snapshot();
+	REQUIRE(events.size() == 3);
+	REQUIRE(GetData(events[0]) == "GET /bucket/data.parquet HTTP/1.1");
+	REQUIRE(GetData(events[1]) == "[HTTP/2] [1] [Authorization: <redacted>");
+	REQUIRE(GetData(events[2]) == "[HTTP/2] [1] [range: bytes=0-3]");
+}
+
+TEST_CASE("DebugEventRing truncates long data and keeps the latest events", "[debug_event_ring]") {
+	DebugEventRing ring;
+	const string long_text(DebugEvent::MAX_DATA_LEN * 2, 'a');
+	AppendText(ring, long_text, /*request_id=*/0);
+	auto events = ring.Snapshot();
+	REQUIRE(events.size() == 1);
+	REQUIRE(events[0].size == long_text.size());
+	REQUIRE(events[0].data_len == DebugEvent::MAX_DATA_LEN);
+
+	// Only the latest events are kept once the ring wraps around.
+	for (uint64_t request_id = 1; request_id <= DebugEventRing::CAPACITY + 10; ++request_id) {
+		AppendText(ring, "text", request_id);
+	}
+	events = ring.Snapshot();
+	REQUIRE(events.size() == DebugEventRing::CAPACITY);
+	REQUIRE(events.front().request_id == 11);
+	REQUIRE(events.back().request_id == DebugEventRing::CAPACITY + 10);
+}
+
+TEST_CASE("MultiCurlManager collects debug events of sampled requests", "[debug_event_ring]") {
+	curl_global_init(CURL_GLOBAL_DEFAULT);
+	ENABLE_DEBUG_EVENTS = true;
+	CURL *easy_curl = curl_easy_init();
+	curl_easy_setopt(easy_curl, CURLOPT_CONNECTTIMEOUT, 1L);
+	auto req = make_uniq<CurlRequest>(easy_curl);
+	req->SetUrl(UNREACHABLE_URL);
+	req->SetGetAttrs();
+	auto response = MultiCurlManager::GetInstance().HandleRequest(std::move(req));
+	REQUIRE(response->HasRequestError());
+	ENABLE_DEBUG_EVENTS = false;
+
+	bool found = false;
+	for (const auto &cur_event : MultiCurlManager::GetInstance().GetDebugEvents()) {
+		if (cur_event.type == DebugEvent::Type::TEXT && GetData(cur_event).find("127.0.0.1") != string::npos) {
+			found = true;
+		}
+	}
+	REQUIRE(found);
+
+	curl_easy_cleanup(easy_curl);
+}
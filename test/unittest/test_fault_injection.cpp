@@ -0,0 +1,172 @@
+#include "catch.hpp"
+
+#include <chrono>
+#include <curl/curl.h>
+
+#include "curl_request.hpp"
+#include "duckdb/common/helper.hpp"
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/unique_ptr.hpp"
+#include "duckdb/common/vector.hpp"
+#include "loopback_range_server.hpp"
+#include "multi_curl_manager.hpp"
+
+using namespace duckdb;
+
+namespace {
+
+constexpr idx_t OBJECT_SIZE = 256 * 1024;
+constexpr auto FAULT_DELAY = std::chrono::milliseconds(300);
+// Curl timeout, which is much longer than faults under test.
+constexpr long CURL_TIMEOUT_MS = 30000;
+// Upper bound for faulted requests to complete.
+constexpr auto MAX_FAULT_LATENCY = std::chrono::seconds(5);
+constexpr idx_t RANDOM_FAULT_REQUESTS = 200;
+
+struct FaultResponse {
+	unique_ptr<HTTPResponse> response;
+	std::chrono::steady_clock::duration elapsed;
+};
+
+LoopbackRangeServerConfig CreateConfig(bool http2) {
+	LoopbackRangeServerConfig config;
+	config.object_size = OBJECT_SIZE;
+	config.enable_http2 = http2;
+	config.fault_delay = FAULT_DELAY;
+	return config;
+}
+
+// Read the whole object on a fresh connection. Curl silently retries requests whose reused connection is reset before
+// any response, which would hide the fault and consume one scheduled for the next request.
+FaultResponse ReadObject(const LoopbackRangeServer &server, bool http2,
+                         std::chrono::steady_clock::duration deadline = std::chrono::steady_clock::duration::max()) {
+	CURL *easy_curl = curl_easy_init();
+	curl_easy_setopt(easy_curl, CURLOPT_TIMEOUT_MS, CURL_TIMEOUT_MS);
+	curl_easy_setopt(easy_curl, CURLOPT_FORBID_REUSE, 1L);
+	if (http2) {
+		curl_easy_setopt(easy_curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2_PRIOR_KNOWLEDGE);
+	}
+	auto req = make_uniq<CurlRequest>(easy_curl);
+	req->SetUrl(server.GetUrl());
+	req->SetGetAttrs();
+	const auto start = std::chrono::steady_clock::now();
+	if (deadline != std::chrono::steady_clock::duration::max()) {
+		req->SetDeadline(start + deadline);
+	}
+	FaultResponse result;
+	result.response = MultiCurlManager::GetInstance().HandleRequest(std::move(req));
+	result.elapsed = std::chrono::steady_clock::now() - start;
+	curl_easy_cleanup(easy_curl);
+	return result;
+}
+
+bool IsCompleteObject(const HTTPResponse &response) {
+	if (response.HasRequestError() || static_cast<int>(response.status) != 200 ||
+	    response.body.size() != OBJECT_SIZE) {
+		return false;
+	}
+	for (idx_t offset = 0; offset < OBJECT_SIZE; ++offset) {
+		if (response.body[offset] != LoopbackRangeServer::GetGeneratedByte(offset)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void CheckFaults(bool http2) {
+	curl_global_init(CURL_GLOBAL_DEFAULT);
+	LoopbackRangeServer server {CreateConfig(http2)};
+
+	// Slow first byte.
+	server.ScheduleFault(LoopbackFault::SLOW_FIRST_BYTE);
+	auto result = ReadObject(server, http2);
+	REQUIRE(IsCompleteObject(*result.response));
+	REQUIRE(result.elapsed >= FAULT_DELAY);
+	REQUIRE(result.elapsed < MAX_FAULT_LATENCY);
+
+	// Mid-body stall.
+	server.ScheduleFault(LoopbackFault::MID_BODY_STALL);
+	result = ReadObject(server, http2);
+	REQUIRE(IsCompleteObject(*result.response));
+	REQUIRE(result.elapsed >= FAULT_DELAY);
+	REQUIRE(result.elapsed < MAX_FAULT_LATENCY);
+
+	// Mid-body stall beyond the request deadline.
+	server.ScheduleFault(LoopbackFault::MID_BODY_STALL);
+	result = ReadObject(server, http2, /*deadline=*/std::chrono::milliseconds(100));
+	REQUIRE(result.response->HasRequestError());
+	REQUIRE(result.response->GetRequestError() == "Request deadline exceeded");
+	REQUIRE(result.elapsed < FAULT_DELAY);
+
+	// Connection reset.
+	server.ScheduleFault(LoopbackFault::CONNECTION_RESET);
+	result = ReadObject(server, http2);
+	REQUIRE(result.response->HasRequestError());
+	REQUIRE_FALSE(result.response->GetRequestError().empty());
+	REQUIRE(result.elapsed < MAX_FAULT_LATENCY);
+
+	// 503 SlowDown.
+	server.ScheduleFault(LoopbackFault::SLOW_DOWN);
+	result = ReadObject(server, http2);
+	REQUIRE_FALSE(result.response->HasRequestError());
+	REQUIRE(static_cast<int>(result.response->status) == 503);
+	REQUIRE(result.response->body.find("<Code>SlowDown</Code>") != string::npos);
+
+	// Truncated body.
+	server.ScheduleFault(LoopbackFault::TRUNCATED_BODY);
+	result = ReadObject(server, http2);
+	REQUIRE(result.response->HasRequestError());
+	REQUIRE_FALSE(result.response->GetRequestError().empty());
+	REQUIRE(result.elapsed < MAX_FAULT_LATENCY);
+
+	// Scheduled faults only apply to the given number of requests, and the server keeps serving afterwards.
+	REQUIRE(server.GetFaultCount() == 6);
+	REQUIRE(IsCompleteObject(*ReadObject(server, http2).response));
+	REQUIRE(server.GetFaultCount() == 6);
+}
+
+// Get statuses of sequential requests against a server injecting faults at random, 0 for request errors.
+vector<int> GetRandomFaultStatuses(uint64_t seed, uint64_t &fault_count) {
+	auto config = CreateConfig(/*http2=*/false);
+	config.fault_probabilities = {{LoopbackFault::SLOW_DOWN, 0.2}, {LoopbackFault::CONNECTION_RESET, 0.1}};
+	config.fault_seed = seed;
+	LoopbackRangeServer server {config};
+
+	vector<int> statuses;
+	for (idx_t idx = 0; idx < RANDOM_FAULT_REQUESTS; ++idx) {
+		auto result = ReadObject(server, /*http2=*/false);
+		statuses.emplace_back(result.response->HasRequestError() ? 0 : static_cast<int>(result.response->status));
+	}
+	fault_count = server.GetFaultCount();
+	return statuses;
+}
+
+} // namespace
+
+TEST_CASE("Loopback range server injects faults over HTTP/1.1", "[fault_injection]") {
+	CheckFaults(/*http2=*/false);
+}
+
+TEST_CASE("Loopback range server injects faults over HTTP/2", "[fault_injection]") {
+	CheckFaults(/*http2=*/true);
+}
+
+TEST_CASE("Loopback range server injects repeatable random faults", "[fault_injection]") {
+	curl_global_init(CURL_GLOBAL_DEFAULT);
+	uint64_t fault_count = 0;
+	const auto statuses = GetRandomFaultStatuses(/*seed=*/42, fault_count);
+	idx_t slow_down_count = 0;
+	idx_t reset_count = 0;
+	for (int cur_status : statuses) {
+		slow_down_count += cur_status == 503;
+		reset_count += cur_status == 0;
+	}
+	REQUIRE(slow_down_count + reset_count == fault_count);
+	REQUIRE(slow_down_count > 0);
+	REQUIRE(reset_count > 0);
+	REQUIRE(fault_count < RANDOM_FAULT_REQUESTS / 2);
+
+	// The same seed injects faults into the same requests.
+	uint64_t repeated_fault_count = 0;
+	REQUIRE(GetRandomFaultStatuses(/*seed=*/42, repeated_fault_count) == statuses);
+}
@@ -0,0 +1,199 @@
+#include "catch.hpp"
+
+#include <chrono>
+#include <curl/curl.h>
+#include <fstream>
+#include <unistd.h>
+
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "extension_config.hpp"
+#include "http_archive.hpp"
+#include "http_record_replay.hpp"
+
+using namespace duckdb;
+
+namespace {
+
+string GetArchivePath(const string &name) {
+	return StringUtil::Format("/tmp/curl_httpfs_%s_%d.har", name, getpid());
+}
+
+HttpArchiveEntry MakeEntry(const string &url, const string &range, const string &body) {
+	HttpArchiveEntry entry;
+	entry.method = "GET";
+	entry.url = url;
+	entry.request_headers.emplace_back("Range", range);
+	entry.status_code = 206;
+	entry.response_headers.emplace_back("Content-Length", std::to_string(body.size()));
+	entry.body = body;
+	entry.duration_us = 1500;
+	return entry;
+}
+
+} // namespace
+
+TEST_CASE("HTTP archive reads back appended entries", "[http_archive]") {
+	auto fs = FileSystem::CreateLocal();
+	const string path = GetArchivePath("roundtrip");
+	// Body with bytes of all values, and long enough to take a multi-byte length prefix.
+	string body;
+	for (int idx = 0; idx < 1024; ++idx) {
+		body.push_back(static_cast<char>(idx % 256));
+	}
+	{
+		HttpArchiveWriter writer {*fs, path};
+		writer.Append(MakeEntry("http://localhost/a", "bytes=0-1023", body));
+		auto failed = MakeEntry("http://localhost/b", "", "");
+		failed.status_code = 0;
+		failed.request_error = "Couldn't connect to server";
+		writer.Append(failed);
+	}
+
+	const auto entries = ReadHttpArchive(*fs, path);
+	REQUIRE(entries.size() == 2);
+	REQUIRE(entries[0].method == "GET");
+	REQUIRE(entries[0].url == "http://localhost/a");
+	REQUIRE(entries[0].GetRange() == "bytes=0-1023");
+	REQUIRE(entries[0].status_code == 206);
+	REQUIRE(entries[0].response_headers.size() == 1);
+	REQUIRE(entries[0].response_headers[0].second == "1024");
+	REQUIRE(entries[0].body == body);
+	REQUIRE(entries[0].duration_us == 1500);
+	REQUIRE(entries[1].GetRange().empty());
+	REQUIRE(entries[1].request_error == "Couldn't connect to server");
+	REQUIRE(entries[1].body.empty());
+	remove(path.c_str());
+}
+
+TEST_CASE("HTTP archive ignores an incomplete trailing entry", "[http_archive]") {
+	auto fs = FileSystem::CreateLocal();
+	const string path = GetArchivePath("truncated");
+	{
+		HttpArchiveWriter writer {*fs, path};
+		writer.Append(MakeEntry("http://localhost/a", "bytes=0-3", "abcd"));
+		writer.Append(MakeEntry("http://localhost/a", "bytes=4-7", "efgh"));
+	}
+	std::ifstream in {path, std::ios::binary | std::ios::ate};
+	const auto size = static_cast<long>(in.tellg());
+	in.close();
+	REQUIRE(truncate(path.c_str(), size - 3) == 0);
+
+	const auto entries = ReadHttpArchive(*fs, path);
+	REQUIRE(entries.size() == 1);
+	REQUIRE(entries[0].body == "abcd");
+	remove(path.c_str());
+}
+
+TEST_CASE("HTTP archive rejects files of other formats", "[http_archive]") {
+	auto fs = FileSystem::CreateLocal();
+	const string path = GetArchivePath("invalid");
+	{
+		std::ofstream out {path};
+		out << "not an archive";
+	}
+	REQUIRE_THROWS(ReadHttpArchive(*fs, path));
+	REQUIRE_THROWS(ReadHttpArchive(*fs, GetArchivePath("missing")));
+	remove(path.c_str());
+}
+
+TEST_CASE("Recorded requests are replayed by method, URL and range", "[http_archive]") {
+	auto fs = FileSystem::CreateLocal();
+	const string path = GetArchivePath("replay");
+	const string url = "http://localhost/data.parquet";
+	curl_slist *headers = nullptr;
+	headers = curl_slist_append(headers, "Authorization: AWS4-HMAC-SHA256 Credential=secret");
+	headers = curl_slist_append(headers, "Range: bytes=0-3");
+	curl_slist *other_range_headers = curl_slist_append(nullptr, "Range: bytes=4-7");
+
+	auto &recorder = HttpRecorder::GetInstance();
+	recorder.SetPath(*fs, path);
+	REQUIRE(recorder.IsRecording());
+	HTTPResponse first {HTTPStatusCode::PartialContent_206};
+	first.body = "abcd";
+	first.headers.Insert("ETag", "\"v1\"");
+	recorder.Record("GET", url, headers, first, std::chrono::milliseconds(2));
+	HTTPResponse second {HTTPStatusCode::PartialContent_206};
+	second.body = "ABCD";
+	recorder.Record("GET", url, headers, second, std::chrono::milliseconds(2));
+	HTTPResponse other_range {HTTPStatusCode::PartialContent_206};
+	other_range.body = "efgh";
+	recorder.Record("GET", url, other_range_headers, other_range, std::chrono::milliseconds(2));
+	recorder.SetPath(*fs, "");
+	REQUIRE_FALSE(recorder.IsRecording());
+
+	// Credentials never reach the archive.
+	const auto entries = ReadHttpArchive(*fs, path);
+	REQUIRE(entries.size() == 3);
+	REQUIRE(entries[0].request_headers[0].first == "Authorization");
+	REQUIRE(entries[0].request_headers[0].second == "<redacted>");
+	REQUIRE(entries[0].duration_us == 2000);
+
+	auto &replayer = HttpReplayer::GetInstance();
+	REPLAY_LATENCY = ReplayLatency::NONE;
+	replayer.SetPath(*fs, path);
+	REQUIRE(replayer.IsReplaying());
+
+	// Identical requests get recorded responses in turn, and start over once all are served.
+	auto response = replayer.Replay("GET", url, headers);
+	REQUIRE(static_cast<int>(response->status) == 206);
+	REQUIRE(response->body == "abcd");
+	REQUIRE(response->GetHeaderValue("ETag") == "\"v1\"");
+	REQUIRE(replayer.Replay("GET", url, headers)->body == "ABCD");
+	REQUIRE(replayer.Replay("GET", url, headers)->body == "abcd");
+	REQUIRE(replayer.Replay("GET", url, other_range_headers)->body == "efgh");
+
+	// Requests never recorded fail without a response.
+	response = replayer.Replay("HEAD", url, headers);
+	REQUIRE(response->HasRequestError());
+	response = replayer.Replay("GET", url, nullptr);
+	REQUIRE(response->HasRequestError());
+
+	// Recorded latency is applied if configured.
+	REPLAY_LATENCY = ReplayLatency::RECORDED;
+	const auto start = std::chrono::steady_clock::now();
+	replayer.Replay("GET", url, other_range_headers);
+	REQUIRE(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(2));
+
+	replayer.SetPath(*fs, "");
+	REQUIRE_FALSE(replayer.IsReplaying());
+	REPLAY_LATENCY = DEFAULT_REPLAY_LATENCY;
+	curl_slist_free_all(headers);
+	curl_slist_free_all(other_range_headers);
+	remove(path.c_str());
+}
+
+TEST_CASE("Credentials in recorded URLs are redacted, and replayed by redacted URL", "[http_archive]") {
+	auto fs = FileSystem::CreateLocal();
+	const string path = GetArchivePath("presigned");
+	const string url = "http://localhost/data.parquet?X-Amz-Credential=key%2F20240101&versionId=3&X-Amz-Signature=abcd";
+	auto &recorder = HttpRecorder::GetInstance();
+	recorder.SetPath(*fs, path);
+	HTTPResponse recorded {HTTPStatusCode::OK_200};
+	recorded.body = "abcd";
+	// Recorded latency long enough to be noticed if replay isn't interrupted.
+	recorder.Record("GET", url, nullptr, recorded, std::chrono::seconds(10));
+	recorder.SetPath(*fs, "");
+
+	const auto entries = ReadHttpArchive(*fs, path);
+	REQUIRE(entries.size() == 1);
+	REQUIRE(entries[0].url ==
+	        "http://localhost/data.parquet?X-Amz-Credential=<redacted>&versionId=3&X-Amz-Signature=<redacted>");
+
+	// Presigned URLs are signed again on every run.
+	auto &replayer = HttpReplayer::GetInstance();
+	REPLAY_LATENCY = ReplayLatency::RECORDED;
+	replayer.SetPath(*fs, path);
+	const string resigned_url =
+	    "http://localhost/data.parquet?X-Amz-Credential=key%2F20240102&versionId=3&X-Amz-Signature=ef01";
+	const auto start = std::chrono::steady_clock::now();
+	auto response = replayer.Replay("GET", resigned_url, nullptr, []() { return true; });
+	REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds(5));
+	REQUIRE(response->body == "abcd");
+	response = replayer.Replay("GET", "http://localhost/data.parquet?versionId=4", nullptr);
+	REQUIRE(response->HasRequestError());
+
+	replayer.SetPath(*fs, "");
+	REPLAY_LATENCY = DEFAULT_REPLAY_LATENCY;
+	remove(path.c_str());
+}
@@ -0,0 +1,117 @@
+#include "catch.hpp"
+
+// io_uring is only available on linux.
+#ifdef __linux__
+
+#include <curl/curl.h>
+
+#include "curl_completion_queue.hpp"
+#include "curl_request.hpp"
+#include "duckdb/common/helper.hpp"
+#include "duckdb/common/unique_ptr.hpp"
+#include "duckdb/common/vector.hpp"
+#include "extension_config.hpp"
+#include "io_uring_ring.hpp"
+#include "loopback_listener.hpp"
+#include "loopback_range_server.hpp"
+#include "multi_curl_manager.hpp"
+
+using namespace duckdb;
+
+namespace {
+
+// Number of requests submitted asynchronously.
+constexpr idx_t REQUEST_COUNT = 16;
+
+// Eventloops are never destroyed, share one across test cases.
+CurlEventLoop &GetIoUringEventLoop() {
+	static auto *event_loop = new CurlEventLoop(EventLoopBackend::IO_URING);
+	return *event_loop;
+}
+
+// Submit requests to the given URL, and wait for all their completions. If [`forbid_reuse`] is set, each connection is
+// closed once its transfer completes.
+vector<unique_ptr<HTTPResponse>> PerformRequests(CurlEventLoop &event_loop, const string &url, long timeout_ms,
+                                                 bool forbid_reuse = false) {
+	CurlCompletionQueue completion_queue;
+	vector<CURL *> easy_curls;
+	vector<unique_ptr<CurlRequest>> requests;
+	for (idx_t idx = 0; idx < REQUEST_COUNT; ++idx) {
+		CURL *easy_curl = curl_easy_init();
+		curl_easy_setopt(easy_curl, CURLOPT_TIMEOUT_MS, timeout_ms);
+		curl_easy_setopt(easy_curl, CURLOPT_FORBID_REUSE, forbid_reuse ? 1L : 0L);
+		easy_curls.emplace_back(easy_curl);
+
+		auto req = make_uniq<CurlRequest>(easy_curl);
+		req->SetUrl(url);
+		req->SetGetAttrs();
+		req->SetCompletionCallback(completion_queue.CreateCallback(/*tag=*/idx));
+		requests.emplace_back(std::move(req));
+	}
+	event_loop.SubmitRequests(std::move(requests));
+
+	vector<unique_ptr<HTTPResponse>> responses;
+	for (idx_t idx = 0; idx < REQUEST_COUNT; ++idx) {
+		responses.emplace_back(completion_queue.Pop().response);
+	}
+	for (auto *easy_curl : easy_curls) {
+		curl_easy_cleanup(easy_curl);
+	}
+	return responses;
+}
+
+} // namespace
+
+TEST_CASE("io_uring eventloop completes failed connections", "[multi_curl][io_uring]") {
+	if (!IoUring::IsSupported()) {
+		return;
+	}
+	curl_global_init(CURL_GLOBAL_DEFAULT);
+
+	auto &event_loop = GetIoUringEventLoop();
+	REQUIRE(event_loop.GetBackend() == EventLoopBackend::IO_URING);
+
+	auto responses = PerformRequests(event_loop, UNREACHABLE_URL, /*timeout_ms=*/1000);
+	for (auto &cur_response : responses) {
+		REQUIRE(cur_response != nullptr);
+		REQUIRE(cur_response->HasRequestError());
+	}
+}
+
+TEST_CASE("io_uring eventloop completes transfers which close their connections", "[multi_curl][io_uring]") {
+	if (!IoUring::IsSupported()) {
+		return;
+	}
+	curl_global_init(CURL_GLOBAL_DEFAULT);
+
+	// Completing a transfer closes its connection, which removes the socket being dispatched.
+	LoopbackRangeServerConfig config;
+	config.object_size = 64 * 1024;
+	LoopbackRangeServer server {config};
+	auto responses = PerformRequests(GetIoUringEventLoop(), server.GetUrl(), /*timeout_ms=*/10000,
+	                                 /*forbid_reuse=*/true);
+	for (auto &cur_response : responses) {
+		REQUIRE(cur_response != nullptr);
+		REQUIRE_FALSE(cur_response->HasRequestError());
+		REQUIRE(static_cast<int>(cur_response->status) == 200);
+		REQUIRE(cur_response->body.size() == config.object_size);
+	}
+	REQUIRE(server.GetConnectionCount() == REQUEST_COUNT);
+}
+
+TEST_CASE("io_uring eventloop fires curl timeout", "[multi_curl][io_uring]") {
+	if (!IoUring::IsSupported()) {
+		return;
+	}
+	curl_global_init(CURL_GLOBAL_DEFAULT);
+
+	// Connections are established by the kernel but never responded.
+	LoopbackListener listener;
+	auto responses = PerformRequests(GetIoUringEventLoop(), listener.GetUrl(), /*timeout_ms=*/200);
+	for (auto &cur_response : responses) {
+		REQUIRE(cur_response != nullptr);
+		REQUIRE(cur_response->HasRequestError());
+	}
+}
+
+#endif
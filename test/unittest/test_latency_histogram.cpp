@@ -0,0 +1,72 @@
+#include "catch.hpp"
+
+#include <thread>
+
+#include "duckdb/common/vector.hpp"
+#include "latency_histogram.hpp"
+
+using namespace duckdb;
+
+namespace {
+
+constexpr int RECORDER_COUNT = 8;
+constexpr int RECORDS_PER_RECORDER = 10000;
+
+} // namespace
+
+TEST_CASE("LatencyHistogram buckets cover all latencies with bounded error", "[latency_histogram]") {
+	// Small latencies are recorded exactly.
+	for (uint64_t latency_us = 0; latency_us < LatencyHistogram::SUB_BUCKET_COUNT; ++latency_us) {
+		REQUIRE(LatencyHistogram::GetBucketUpperBound(LatencyHistogram::GetBucketIndex(latency_us)) == latency_us);
+	}
+	for (uint64_t latency_us : {16ULL, 17ULL, 31ULL, 32ULL, 1000ULL, 123456ULL, 1ULL << 39}) {
+		const idx_t bucket_idx = LatencyHistogram::GetBucketIndex(latency_us);
+		REQUIRE(bucket_idx < LatencyHistogram::BUCKET_COUNT);
+		const uint64_t upper_bound = LatencyHistogram::GetBucketUpperBound(bucket_idx);
+		REQUIRE(upper_bound >= latency_us);
+		REQUIRE(upper_bound - latency_us <= latency_us / LatencyHistogram::SUB_BUCKET_COUNT);
+	}
+	// Latencies beyond the largest tracked power of two go to the last bucket.
+	REQUIRE(LatencyHistogram::GetBucketIndex(~0ULL) == LatencyHistogram::BUCKET_COUNT - 1);
+}
+
+TEST_CASE("LatencyHistogram reports percentiles", "[latency_histogram]") {
+	LatencyHistogram histogram;
+	REQUIRE(histogram.GetSnapshot().GetPercentile(0.5) == 0);
+
+	for (int64_t latency_us = 1; latency_us <= 1000; ++latency_us) {
+		histogram.Record(latency_us);
+	}
+	const auto snapshot = histogram.GetSnapshot();
+	REQUIRE(snapshot.count == 1000);
+	REQUIRE(snapshot.max_us == 1000);
+	REQUIRE(snapshot.GetMean() == Approx(500.5));
+
+	const uint64_t p50 = snapshot.GetPercentile(0.5);
+	REQUIRE(p50 >= 500);
+	REQUIRE(p50 <= 500 + 500 / LatencyHistogram::SUB_BUCKET_COUNT);
+	const uint64_t p99 = snapshot.GetPercentile(0.99);
+	REQUIRE(p99 >= 990);
+	REQUIRE(p99 <= 1000);
+	REQUIRE(snapshot.GetPercentile(1.0) == 1000);
+}
+
+TEST_CASE("LatencyHistogram records from concurrent threads", "[latency_histogram]") {
+	LatencyHistogram histogram;
+	vector<std::thread> recorders;
+	recorders.reserve(RECORDER_COUNT);
+	for (int recorder_idx = 0; recorder_idx < RECORDER_COUNT; ++recorder_idx) {
+		recorders.emplace_back([&histogram, recorder_idx]() {
+			for (int idx = 0; idx < RECORDS_PER_RECORDER; ++idx) {
+				histogram.Record(recorder_idx * 100 + idx % 100);
+			}
+		});
+	}
+	for (auto &cur_recorder : recorders) {
+		cur_recorder.join();
+	}
+
+	const auto snapshot = histogram.GetSnapshot();
+	REQUIRE(snapshot.count == RECORDER_COUNT * RECORDS_PER_RECORDER);
+	REQUIRE(snapshot.max_us == (RECORDER_COUNT - 1) * 100 + 99);
+}
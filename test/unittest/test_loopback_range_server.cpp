@@ -0,0 +1,163 @@
+#include "catch.hpp"
+
+#include <chrono>
+#include <curl/curl.h>
+
+#include "curl_request.hpp"
+#include "duckdb/common/helper.hpp"
+#include "duckdb/common/string.hpp"
+#include "extension_config.hpp"
+#include "hpack.hpp"
+#include "loopback_range_server.hpp"
+#include "multi_curl_manager.hpp"
+
+using namespace duckdb;
+
+namespace {
+
+constexpr idx_t OBJECT_SIZE = 256 * 1024;
+
+struct RangeResponse {
+	unique_ptr<HTTPResponse> response;
+	long http_version = CURL_HTTP_VERSION_NONE;
+};
+
+// Issue a request with the given method and range header on the given easy handle.
+RangeResponse HandleRequest(CURL *easy_curl, const string &url, const string &method, const string &range) {
+	curl_slist *headers = range.empty() ? nullptr : curl_slist_append(nullptr, ("Range: " + range).c_str());
+	auto req = make_uniq<CurlRequest>(easy_curl);
+	req->SetUrl(url);
+	req->SetHeaders(headers);
+	if (method == "HEAD") {
+		req->SetHeadAttrs();
+	} else {
+		req->SetGetAttrs();
+	}
+	RangeResponse result;
+	result.response = MultiCurlManager::GetInstance().HandleRequest(std::move(req));
+	curl_easy_getinfo(easy_curl, CURLINFO_HTTP_VERSION, &result.http_version);
+	curl_slist_free_all(headers);
+	return result;
+}
+
+string GetGeneratedContent(idx_t start, idx_t end) {
+	string content;
+	for (idx_t offset = start; offset <= end; ++offset) {
+		content.push_back(LoopbackRangeServer::GetGeneratedByte(offset));
+	}
+	return content;
+}
+
+void CheckRangeReads(CURL *easy_curl, const LoopbackRangeServer &server, long expected_http_version) {
+	auto result = HandleRequest(easy_curl, server.GetUrl(), "GET", "bytes=100-1123");
+	REQUIRE_FALSE(result.response->HasRequestError());
+	REQUIRE(static_cast<int>(result.response->status) == 206);
+	REQUIRE(result.response->body == GetGeneratedContent(100, 1123));
+	REQUIRE(result.http_version == expected_http_version);
+
+	// Open-ended and suffix ranges.
+	result = HandleRequest(easy_curl, server.GetUrl(), "GET", "bytes=262000-");
+	REQUIRE(result.response->body == GetGeneratedContent(262000, OBJECT_SIZE - 1));
+	result = HandleRequest(easy_curl, server.GetUrl(), "GET", "bytes=-10");
+	REQUIRE(result.response->body == GetGeneratedContent(OBJECT_SIZE - 10, OBJECT_SIZE - 1));
+
+	// Whole object spans multiple HTTP/2 frames and flow control windows.
+	result = HandleRequest(easy_curl, server.GetUrl(), "GET", "");
+	REQUIRE(static_cast<int>(result.response->status) == 200);
+	REQUIRE(result.response->body == GetGeneratedContent(0, OBJECT_SIZE - 1));
+
+	result = HandleRequest(easy_curl, server.GetUrl(), "HEAD", "");
+	REQUIRE(static_cast<int>(result.response->status) == 200);
+	REQUIRE(result.response->body.empty());
+
+	result = HandleRequest(easy_curl, server.GetUrl(), "GET", "bytes=300000-300010");
+	REQUIRE(static_cast<int>(result.response->status) == 416);
+	result = HandleRequest(easy_curl, server.GetUrl("/missing"), "GET", "");
+	REQUIRE(static_cast<int>(result.response->status) == 404);
+}
+
+} // namespace
+
+TEST_CASE("HPACK decodes Huffman-coded strings", "[loopback_range_server]") {
+	// Examples from RFC 7541 Appendix C.4.
+	const string encoded = "\xf1\xe3\xc2\xe5\xf2\x3a\x6b\xa0\xab\x90\xf4\xff";
+	string decoded;
+	REQUIRE(HpackHuffmanDecode(encoded.data(), encoded.size(), decoded));
+	REQUIRE(decoded == "www.example.com");
+
+	HpackDecoder decoder;
+	vector<HpackHeader> headers;
+	const string block = "\x82\x86\x84\x41\x8c\xf1\xe3\xc2\xe5\xf2\x3a\x6b\xa0\xab\x90\xf4\xff";
+	REQUIRE(decoder.Decode(block, headers));
+	REQUIRE(headers.size() == 4);
+	REQUIRE(headers[0] == HpackHeader(":method", "GET"));
+	REQUIRE(headers[1] == HpackHeader(":scheme", "http"));
+	REQUIRE(headers[2] == HpackHeader(":path", "/"));
+	REQUIRE(headers[3] == HpackHeader(":authority", "www.example.com"));
+	// The authority has been added to the dynamic table.
+	headers.clear();
+	REQUIRE(decoder.Decode("\xbe", headers));
+	REQUIRE(headers[0] == HpackHeader(":authority", "www.example.com"));
+}
+
+TEST_CASE("Loopback range server serves HTTP/1.1 range reads", "[loopback_range_server]") {
+	curl_global_init(CURL_GLOBAL_DEFAULT);
+	LoopbackRangeServerConfig config;
+	config.object_size = OBJECT_SIZE;
+	LoopbackRangeServer server {config};
+
+	CURL *easy_curl = curl_easy_init();
+	CheckRangeReads(easy_curl, server, CURL_HTTP_VERSION_1_1);
+
+	server.PutObject("/bucket/key", "hello world");
+	auto result = HandleRequest(easy_curl, server.GetUrl("/bucket/key"), "GET", "bytes=6-10");
+	REQUIRE(result.response->body == "world");
+	curl_easy_cleanup(easy_curl);
+}
+
+TEST_CASE("Loopback range server serves HTTP/2 upgraded from HTTP/1.1", "[loopback_range_server]") {
+	LoopbackRangeServerConfig config;
+	config.object_size = OBJECT_SIZE;
+	config.enable_http2 = true;
+	LoopbackRangeServer server {config};
+
+	CURL *easy_curl = curl_easy_init();
+	curl_easy_setopt(easy_curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2_0);
+	CheckRangeReads(easy_curl, server, CURL_HTTP_VERSION_2_0);
+	curl_easy_cleanup(easy_curl);
+}
+
+TEST_CASE("Loopback range server serves HTTP/2 with prior knowledge", "[loopback_range_server]") {
+	LoopbackRangeServerConfig config;
+	config.object_size = OBJECT_SIZE;
+	config.enable_http2 = true;
+	LoopbackRangeServer server {config};
+
+	CURL *easy_curl = curl_easy_init();
+	curl_easy_setopt(easy_curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2_PRIOR_KNOWLEDGE);
+	// Older libcurl fails to reuse prior knowledge connections in multi mode, regardless of the server.
+	curl_easy_setopt(easy_curl, CURLOPT_FORBID_REUSE, 1L);
+	CheckRangeReads(easy_curl, server, CURL_HTTP_VERSION_2_0);
+	curl_easy_cleanup(easy_curl);
+}
+
+TEST_CASE("Loopback range server injects latency and limits bandwidth", "[loopback_range_server]") {
+	LoopbackRangeServerConfig config;
+	config.object_size = OBJECT_SIZE;
+	config.latency = std::chrono::milliseconds(50);
+	// The whole object takes about 100 milliseconds to send.
+	config.bandwidth_bytes_per_sec = OBJECT_SIZE * 10;
+	LoopbackRangeServer server {config};
+
+	CURL *easy_curl = curl_easy_init();
+	auto start = std::chrono::steady_clock::now();
+	auto result = HandleRequest(easy_curl, server.GetUrl(), "GET", "bytes=0-0");
+	REQUIRE(static_cast<int>(result.response->status) == 206);
+	REQUIRE(std::chrono::steady_clock::now() - start >= config.latency);
+
+	start = std::chrono::steady_clock::now();
+	result = HandleRequest(easy_curl, server.GetUrl(), "GET", "");
+	REQUIRE(result.response->body.size() == OBJECT_SIZE);
+	REQUIRE(std::chrono::steady_clock::now() - start >= config.latency + std::chrono::milliseconds(80));
+	curl_easy_cleanup(easy_curl);
+}
@@ -0,0 +1,101 @@
+#include "catch.hpp"
+
+#include <curl/curl.h>
+#include <unistd.h>
+
+#include "curl_request.hpp"
+#include "duckdb/common/helper.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "loopback_listener.hpp"
+#include "metrics_exporter.hpp"
+#include "multi_curl_manager.hpp"
+
+using namespace duckdb;
+
+namespace {
+
+size_t AppendToString(char *data, size_t size, size_t nmemb, void *userp) {
+	static_cast<string *>(userp)->append(data, size * nmemb);
+	return size * nmemb;
+}
+
+// Scrape the given url with a plain easy handle, optionally over the given Unix socket; return the status code.
+long Scrape(const string &url, string &body, const string &unix_socket_path = string()) {
+	CURL *easy_curl = curl_easy_init();
+	curl_easy_setopt(easy_curl, CURLOPT_URL, url.c_str());
+	curl_easy_setopt(easy_curl, CURLOPT_WRITEFUNCTION, AppendToString);
+	curl_easy_setopt(easy_curl, CURLOPT_WRITEDATA, &body);
+	curl_easy_setopt(easy_curl, CURLOPT_TIMEOUT, 5L);
+	if (!unix_socket_path.empty()) {
+		curl_easy_setopt(easy_curl, CURLOPT_UNIX_SOCKET_PATH, unix_socket_path.c_str());
+	}
+	long status_code = 0;
+	if (curl_easy_perform(easy_curl) == CURLE_OK) {
+		curl_easy_getinfo(easy_curl, CURLINFO_RESPONSE_CODE, &status_code);
+	}
+	curl_easy_cleanup(easy_curl);
+	return status_code;
+}
+
+} // namespace
+
+TEST_CASE("MetricsExporter renders request metrics", "[metrics_exporter]") {
+	curl_global_init(CURL_GLOBAL_DEFAULT);
+	CURL *easy_curl = curl_easy_init();
+	curl_easy_setopt(easy_curl, CURLOPT_CONNECTTIMEOUT, 1L);
+	auto req = make_uniq<CurlRequest>(easy_curl);
+	req->SetUrl(UNREACHABLE_URL);
+	req->SetHeadAttrs();
+	auto response = MultiCurlManager::GetInstance().HandleRequest(std::move(req));
+	REQUIRE(response->HasRequestError());
+	curl_easy_cleanup(easy_curl);
+
+	const string metrics = MetricsExporter::RenderMetrics();
+	REQUIRE(metrics.find("# TYPE curl_httpfs_requests_total counter") != string::npos);
+	REQUIRE(metrics.find("curl_httpfs_requests_total{method=\"HEAD\",code=\"error\"} ") != string::npos);
+	REQUIRE(metrics.find("curl_httpfs_received_bytes_total{method=\"GET\"} ") != string::npos);
+	REQUIRE(metrics.find("curl_httpfs_inflight_requests{event_loop=\"0\",state=\"ongoing\"} ") != string::npos);
+	REQUIRE(metrics.find("curl_httpfs_request_wait_seconds_bucket{le=\"+Inf\"} ") != string::npos);
+}
+
+TEST_CASE("MetricsExporter serves metrics on TCP port", "[metrics_exporter]") {
+	auto &exporter = MetricsExporter::GetInstance();
+	exporter.SetEndpoint("127.0.0.1:0");
+	const string listen_address = exporter.GetListenAddress();
+	REQUIRE(StringUtil::StartsWith(listen_address, "127.0.0.1:"));
+	REQUIRE(listen_address != "127.0.0.1:0");
+
+	string body;
+	REQUIRE(Scrape("http://" + listen_address + "/metrics", body) == 200);
+	REQUIRE(body.find("# TYPE curl_httpfs_connections_opened_total counter") != string::npos);
+	string not_found_body;
+	REQUIRE(Scrape("http://" + listen_address + "/unknown", not_found_body) == 404);
+
+	// Endpoint is released once serving stops.
+	exporter.SetEndpoint("");
+	REQUIRE(exporter.GetListenAddress().empty());
+	REQUIRE(Scrape("http://" + listen_address + "/metrics", body) == 0);
+}
+
+TEST_CASE("MetricsExporter serves metrics on Unix socket", "[metrics_exporter]") {
+	const string socket_path = StringUtil::Format("/tmp/curl_httpfs_metrics_test_%d.sock", getpid());
+	auto &exporter = MetricsExporter::GetInstance();
+	exporter.SetEndpoint("unix:" + socket_path);
+	REQUIRE(access(socket_path.c_str(), F_OK) == 0);
+
+	string body;
+	REQUIRE(Scrape("http://localhost/metrics", body, socket_path) == 200);
+	REQUIRE(body.find("# TYPE curl_httpfs_request_phase_seconds histogram") != string::npos);
+
+	exporter.SetEndpoint("");
+	REQUIRE(access(socket_path.c_str(), F_OK) != 0);
+}
+
+TEST_CASE("MetricsExporter rejects malformed endpoints", "[metrics_exporter]") {
+	auto &exporter = MetricsExporter::GetInstance();
+	REQUIRE_THROWS(exporter.SetEndpoint("localhost"));
+	REQUIRE_THROWS(exporter.SetEndpoint("127.0.0.1:http"));
+	REQUIRE_THROWS(exporter.SetEndpoint("127.0.0.1:70000"));
+	REQUIRE_THROWS(exporter.SetEndpoint("unix:"));
+	REQUIRE(exporter.GetListenAddress().empty());
+}
@@ -0,0 +1,61 @@
+#include "catch.hpp"
+
+#include <thread>
+
+#include "duckdb/common/vector.hpp"
+#include "mpsc_queue.hpp"
+
+using namespace duckdb;
+
+namespace {
+
+constexpr int PRODUCER_COUNT = 8;
+constexpr int VALUES_PER_PRODUCER = 10000;
+
+} // namespace
+
+TEST_CASE("MpscQueue preserves FIFO order for single producer", "[mpsc_queue]") {
+	MpscQueue<int> queue;
+	REQUIRE(queue.Empty());
+	REQUIRE(queue.Push(0));
+	REQUIRE_FALSE(queue.Push(1));
+	REQUIRE_FALSE(queue.PushBatch(vector<int> {2, 3, 4}));
+	REQUIRE_FALSE(queue.Empty());
+
+	vector<int> consumed;
+	queue.ConsumeAll([&consumed](int value) { consumed.emplace_back(value); });
+	REQUIRE(consumed == vector<int> {0, 1, 2, 3, 4});
+	REQUIRE(queue.Empty());
+
+	// Queue turns non-empty again after being drained.
+	REQUIRE(queue.Push(5));
+}
+
+TEST_CASE("MpscQueue consumes all values from concurrent producers", "[mpsc_queue]") {
+	MpscQueue<int> queue;
+	vector<std::thread> producers;
+	producers.reserve(PRODUCER_COUNT);
+	for (int producer_idx = 0; producer_idx < PRODUCER_COUNT; ++producer_idx) {
+		producers.emplace_back([&queue, producer_idx]() {
+			for (int idx = 0; idx < VALUES_PER_PRODUCER; ++idx) {
+				queue.Push(producer_idx * VALUES_PER_PRODUCER + idx);
+			}
+		});
+	}
+
+	// Values from the same producer are consumed in the order they're pushed.
+	vector<int> last_value(PRODUCER_COUNT, -1);
+	int consumed_count = 0;
+	while (consumed_count < PRODUCER_COUNT * VALUES_PER_PRODUCER) {
+		queue.ConsumeAll([&](int value) {
+			const int producer_idx = value / VALUES_PER_PRODUCER;
+			REQUIRE(value > last_value[producer_idx]);
+			last_value[producer_idx] = value;
+			++consumed_count;
+		});
+	}
+	for (auto &cur_producer : producers) {
+		cur_producer.join();
+	}
+	REQUIRE(queue.Empty());
+}
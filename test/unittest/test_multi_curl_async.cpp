@@ -0,0 +1,96 @@
+#include "catch.hpp"
+
+#include <curl/curl.h>
+
+#include "curl_completion_queue.hpp"
+#include "curl_request.hpp"
+#include "duckdb/common/helper.hpp"
+#include "duckdb/common/http_util.hpp"
+#include "duckdb/common/unique_ptr.hpp"
+#include "duckdb/common/unordered_set.hpp"
+#include "duckdb/common/vector.hpp"
+#include "loopback_listener.hpp"
+#include "multi_curl_manager.hpp"
+
+using namespace duckdb;
+
+namespace {
+
+// Number of requests submitted asynchronously.
+constexpr idx_t REQUEST_COUNT = 16;
+
+} // namespace
+
+TEST_CASE("MultiCurlManager delivers asynchronous completions to completion queue", "[multi_curl][async]") {
+	curl_global_init(CURL_GLOBAL_DEFAULT);
+
+	CurlCompletionQueue completion_queue;
+	vector<CURL *> easy_curls;
+	vector<unique_ptr<CurlRequest>> requests;
+	for (idx_t idx = 0; idx < REQUEST_COUNT; ++idx) {
+		CURL *easy_curl = curl_easy_init();
+		curl_easy_setopt(easy_curl, CURLOPT_CONNECTTIMEOUT, 1L);
+		easy_curls.emplace_back(easy_curl);
+
+		auto req = make_uniq<CurlRequest>(easy_curl);
+		req->SetUrl(UNREACHABLE_URL);
+		req->SetGetAttrs();
+		req->SetCompletionCallback(completion_queue.CreateCallback(/*tag=*/idx));
+		requests.emplace_back(std::move(req));
+	}
+	MultiCurlManager::GetInstance().SubmitRequests(std::move(requests));
+
+	unordered_set<uint64_t> completed_tags;
+	for (idx_t idx = 0; idx < REQUEST_COUNT; ++idx) {
+		auto completion = completion_queue.Pop();
+		REQUIRE(completion.response != nullptr);
+		REQUIRE(completion.response->HasRequestError());
+		completed_tags.insert(completion.tag);
+	}
+	REQUIRE(completed_tags.size() == REQUEST_COUNT);
+
+	CurlCompletionQueue::Completion completion;
+	REQUIRE_FALSE(completion_queue.TryPop(completion));
+
+	for (auto *easy_curl : easy_curls) {
+		curl_easy_cleanup(easy_curl);
+	}
+}
+
+TEST_CASE("Eventloop reports health metrics", "[multi_curl][stats]") {
+	curl_global_init(CURL_GLOBAL_DEFAULT);
+
+	// Eventloops are never destroyed.
+	auto *event_loop = new CurlEventLoop();
+	CurlCompletionQueue completion_queue;
+	vector<CURL *> easy_curls;
+	vector<unique_ptr<CurlRequest>> requests;
+	for (idx_t idx = 0; idx < REQUEST_COUNT; ++idx) {
+		CURL *easy_curl = curl_easy_init();
+		curl_easy_setopt(easy_curl, CURLOPT_CONNECTTIMEOUT, 1L);
+		easy_curls.emplace_back(easy_curl);
+
+		auto req = make_uniq<CurlRequest>(easy_curl);
+		req->SetUrl(UNREACHABLE_URL);
+		req->SetGetAttrs();
+		req->SetCompletionCallback(completion_queue.CreateCallback(/*tag=*/idx));
+		requests.emplace_back(std::move(req));
+	}
+	event_loop->SubmitRequests(std::move(requests));
+	for (idx_t idx = 0; idx < REQUEST_COUNT; ++idx) {
+		completion_queue.Pop();
+	}
+
+	const auto stats = event_loop->GetStats();
+	REQUIRE(stats.pending_requests == 0);
+	REQUIRE(stats.queue_wait.count == REQUEST_COUNT);
+	REQUIRE(stats.wakeups > 0);
+	REQUIRE(stats.events > 0);
+	REQUIRE(stats.socket_action_calls > 0);
+	REQUIRE(stats.check_multi_calls > 0);
+	REQUIRE(stats.uptime_ns > 0);
+
+	for (auto *easy_curl : easy_curls) {
+		curl_easy_cleanup(easy_curl);
+	}
+}
@@ -0,0 +1,187 @@
+#include "catch.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <curl/curl.h>
+#include <thread>
+
+#include "curl_completion_queue.hpp"
+#include "curl_request.hpp"
+#include "duckdb/common/helper.hpp"
+#include "duckdb/common/unique_ptr.hpp"
+#include "loopback_listener.hpp"
+#include "multi_curl_manager.hpp"
+
+using namespace duckdb;
+
+namespace {
+
+// Curl timeout, which is much longer than cancellation and deadlines under test.
+constexpr long CURL_TIMEOUT_MS = 30000;
+// Upper bound for cancellation and deadline to take effect.
+constexpr auto MAX_TERMINATION_LATENCY = std::chrono::seconds(5);
+
+unique_ptr<CurlRequest> CreateRequest(CURL *easy_curl, const string &url) {
+	curl_easy_setopt(easy_curl, CURLOPT_TIMEOUT_MS, CURL_TIMEOUT_MS);
+	auto req = make_uniq<CurlRequest>(easy_curl);
+	req->SetUrl(url);
+	req->SetGetAttrs();
+	return req;
+}
+
+} // namespace
+
+TEST_CASE("MultiCurlManager cancels ongoing request", "[multi_curl][cancel]") {
+	curl_global_init(CURL_GLOBAL_DEFAULT);
+	LoopbackListener listener;
+	CURL *easy_curl = curl_easy_init();
+
+	CurlCompletionQueue completion_queue;
+	auto req = CreateRequest(easy_curl, listener.GetUrl());
+	req->SetCompletionCallback(completion_queue.CreateCallback(/*tag=*/0));
+	auto &manager = MultiCurlManager::GetInstance();
+	const auto handle = manager.SubmitRequest(std::move(req));
+
+	const auto start = std::chrono::steady_clock::now();
+	CurlCompletionQueue::Completion completion;
+	REQUIRE_FALSE(completion_queue.PopWithTimeout(completion, std::chrono::milliseconds(100)));
+	manager.CancelRequest(handle);
+	REQUIRE(completion_queue.PopWithTimeout(completion, MAX_TERMINATION_LATENCY));
+	REQUIRE(std::chrono::steady_clock::now() - start < MAX_TERMINATION_LATENCY);
+	REQUIRE(completion.response->HasRequestError());
+	REQUIRE(completion.response->GetRequestError() == "Request cancelled");
+
+	// Cancelling a completed request is a no-op.
+	manager.CancelRequest(handle);
+	curl_easy_cleanup(easy_curl);
+}
+
+TEST_CASE("MultiCurlManager cancels blocking request on interruption", "[multi_curl][cancel]") {
+	curl_global_init(CURL_GLOBAL_DEFAULT);
+	LoopbackListener listener;
+	CURL *easy_curl = curl_easy_init();
+
+	std::atomic<int> check_count {0};
+	const auto start = std::chrono::steady_clock::now();
+	auto response = MultiCurlManager::GetInstance().HandleRequest(CreateRequest(easy_curl, listener.GetUrl()),
+	                                                              [&check_count]() { return ++check_count >= 3; });
+	REQUIRE(std::chrono::steady_clock::now() - start < MAX_TERMINATION_LATENCY);
+	REQUIRE(check_count.load() == 3);
+	REQUIRE(response->HasRequestError());
+	REQUIRE(response->GetRequestError() == "Request cancelled");
+	curl_easy_cleanup(easy_curl);
+}
+
+TEST_CASE("MultiCurlManager enforces request deadline", "[multi_curl][deadline]") {
+	curl_global_init(CURL_GLOBAL_DEFAULT);
+	LoopbackListener listener;
+	CURL *easy_curl = curl_easy_init();
+
+	auto req = CreateRequest(easy_curl, listener.GetUrl());
+	const auto start = std::chrono::steady_clock::now();
+	req->SetDeadline(start + std::chrono::milliseconds(200));
+	auto response = MultiCurlManager::GetInstance().HandleRequest(std::move(req));
+	const auto elapsed = std::chrono::steady_clock::now() - start;
+	REQUIRE(elapsed >= std::chrono::milliseconds(200));
+	REQUIRE(elapsed < MAX_TERMINATION_LATENCY);
+	REQUIRE(response->HasRequestError());
+	REQUIRE(response->GetRequestError() == "Request deadline exceeded");
+	curl_easy_cleanup(easy_curl);
+}
+
+TEST_CASE("Eventloop drops deadlines of completed requests", "[multi_curl][deadline]") {
+	curl_global_init(CURL_GLOBAL_DEFAULT);
+	LoopbackListener listener;
+	CURL *failed_easy_curl = curl_easy_init();
+	CURL *cancelled_easy_curl = curl_easy_init();
+
+	// Eventloops are never destroyed.
+	auto *event_loop = new CurlEventLoop();
+	CurlCompletionQueue completion_queue;
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(CURL_TIMEOUT_MS);
+	// One request fails right away, the other one hangs until cancelled; both complete long before their deadline.
+	auto failed_req = CreateRequest(failed_easy_curl, UNREACHABLE_URL);
+	failed_req->SetCompletionCallback(completion_queue.CreateCallback(/*tag=*/0));
+	failed_req->SetDeadline(deadline);
+	event_loop->SubmitRequest(std::move(failed_req));
+	auto cancelled_req = CreateRequest(cancelled_easy_curl, listener.GetUrl());
+	cancelled_req->SetCompletionCallback(completion_queue.CreateCallback(/*tag=*/1));
+	cancelled_req->SetDeadline(deadline);
+	const auto handle = event_loop->SubmitRequest(std::move(cancelled_req));
+
+	CurlCompletionQueue::Completion completion;
+	REQUIRE(completion_queue.PopWithTimeout(completion, MAX_TERMINATION_LATENCY));
+	REQUIRE(completion.tag == 0);
+	event_loop->CancelRequest(handle.request_id);
+	REQUIRE(completion_queue.PopWithTimeout(completion, MAX_TERMINATION_LATENCY));
+	REQUIRE(completion.response->GetRequestError() == "Request cancelled");
+
+	// Stats are refreshed right after the wakeup which completes requests.
+	const auto stats_deadline = std::chrono::steady_clock::now() + MAX_TERMINATION_LATENCY;
+	while (event_loop->GetStats().pending_deadlines != 0 && std::chrono::steady_clock::now() < stats_deadline) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+	REQUIRE(event_loop->GetStats().pending_deadlines == 0);
+	curl_easy_cleanup(failed_easy_curl);
+	curl_easy_cleanup(cancelled_easy_curl);
+}
+
+#ifdef __linux__
+TEST_CASE("io_uring eventloop enforces request deadline", "[multi_curl][deadline][io_uring]") {
+	if (!IoUring::IsSupported()) {
+		return;
+	}
+	curl_global_init(CURL_GLOBAL_DEFAULT);
+	LoopbackListener listener;
+	CURL *easy_curl = curl_easy_init();
+
+	// Eventloops are never destroyed.
+	auto *event_loop = new CurlEventLoop(EventLoopBackend::IO_URING);
+	CurlCompletionQueue completion_queue;
+	auto req = CreateRequest(easy_curl, listener.GetUrl());
+	req->SetCompletionCallback(completion_queue.CreateCallback(/*tag=*/0));
+	req->SetDeadline(std::chrono::steady_clock::now() + std::chrono::milliseconds(200));
+	event_loop->SubmitRequest(std::move(req));
+
+	CurlCompletionQueue::Completion completion;
+	REQUIRE(completion_queue.PopWithTimeout(completion, MAX_TERMINATION_LATENCY));
+	REQUIRE(completion.response->GetRequestError() == "Request deadline exceeded");
+	curl_easy_cleanup(easy_curl);
+}
+#endif
+
+TEST_CASE("Eventloop snapshots requests in flight", "[multi_curl][inflight]") {
+	curl_global_init(CURL_GLOBAL_DEFAULT);
+	LoopbackListener listener;
+	CURL *easy_curl = curl_easy_init();
+
+	// Eventloops are never destroyed.
+	auto *event_loop = new CurlEventLoop();
+	REQUIRE(event_loop->SnapshotInflightRequests().get().empty());
+
+	CurlCompletionQueue completion_queue;
+	curl_slist *headers = curl_slist_append(nullptr, "Range: bytes=0-99");
+	// Signature of a presigned URL is never exposed.
+	auto req = CreateRequest(easy_curl, listener.GetUrl("/object?X-Amz-Signature=secret&partNumber=1"));
+	req->SetHeaders(headers);
+	req->SetCompletionCallback(completion_queue.CreateCallback(/*tag=*/0));
+	const auto handle = event_loop->SubmitRequest(std::move(req));
+
+	// Request is sent over the established connection, and waits for response.
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	auto snapshots = event_loop->SnapshotInflightRequests().get();
+	REQUIRE(snapshots.size() == 1);
+	REQUIRE(snapshots[0].url == listener.GetUrl("/object?X-Amz-Signature=<redacted>&partNumber=1"));
+	REQUIRE(snapshots[0].method == "GET");
+	REQUIRE(snapshots[0].range == "bytes=0-99");
+	REQUIRE(snapshots[0].state == InflightRequestState::TRANSFERRING);
+	REQUIRE(snapshots[0].bytes_received == 0);
+	REQUIRE(snapshots[0].elapsed_us >= 100 * 1000);
+
+	event_loop->CancelRequest(handle.request_id);
+	CurlCompletionQueue::Completion completion;
+	REQUIRE(completion_queue.PopWithTimeout(completion, MAX_TERMINATION_LATENCY));
+	REQUIRE(event_loop->SnapshotInflightRequests().get().empty());
+	curl_slist_free_all(headers);
+	curl_easy_cleanup(easy_curl);
+}
@@ -6,18 +6,12 @@
 #include "duckdb/common/string.hpp"
 #include "duckdb/common/unique_ptr.hpp"
 #include "httpfs_client.hpp"
+#include "loopback_listener.hpp"
 #include "multi_curl_client.hpp"
 #include "multi_curl_util.hpp"
 
 using namespace duckdb;
 
-namespace {
-
-// Loopback port 1 is reserved and should have no listener — triggers CURLE_COULDNT_CONNECT quickly.
-constexpr const char *UNREACHABLE_URL = "http://127.0.0.1:1/";
-
-} // namespace
-
 TEST_CASE("MultiCurlClient surfaces libcurl errors on connection failure", "[multi_curl][error]") {
 	curl_global_init(CURL_GLOBAL_DEFAULT);
 
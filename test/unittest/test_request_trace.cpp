@@ -0,0 +1,108 @@
+#include "catch.hpp"
+
+#include <curl/curl.h>
+#include <sstream>
+#include <thread>
+
+#include "curl_request.hpp"
+#include "duckdb/common/helper.hpp"
+#include "duckdb/common/vector.hpp"
+#include "extension_config.hpp"
+#include "loopback_listener.hpp"
+#include "multi_curl_manager.hpp"
+#include "request_trace.hpp"
+
+using namespace duckdb;
+
+namespace {
+
+constexpr int APPENDER_COUNT = 8;
+constexpr int RECORDS_PER_APPENDER = 1000;
+
+RequestTraceRecord CreateRecord(uint64_t trace_id) {
+	RequestTraceRecord record;
+	record.trace_id = trace_id;
+	record.submit_ns = static_cast<int64_t>(trace_id);
+	return record;
+}
+
+} // namespace
+
+TEST_CASE("RequestTrace drains records in order", "[request_trace]") {
+	auto &request_trace = RequestTrace::GetInstance();
+	request_trace.Drain();
+
+	for (uint64_t trace_id = 1; trace_id <= 10; ++trace_id) {
+		request_trace.Append(CreateRecord(trace_id));
+	}
+	auto records = request_trace.Drain();
+	REQUIRE(records.size() == 10);
+	for (idx_t idx = 0; idx < records.size(); ++idx) {
+		REQUIRE(records[idx].trace_id == idx + 1);
+	}
+	REQUIRE(request_trace.Drain().empty());
+
+	// Only the latest records are kept once the ring wraps around.
+	for (uint64_t trace_id = 1; trace_id <= RequestTrace::CAPACITY + 10; ++trace_id) {
+		request_trace.Append(CreateRecord(trace_id));
+	}
+	records = request_trace.Drain();
+	REQUIRE(records.size() == RequestTrace::CAPACITY);
+	REQUIRE(records.front().trace_id == 11);
+	REQUIRE(records.back().trace_id == RequestTrace::CAPACITY + 10);
+}
+
+TEST_CASE("RequestTrace keeps records from concurrent appenders", "[request_trace]") {
+	auto &request_trace = RequestTrace::GetInstance();
+	request_trace.Drain();
+
+	vector<std::thread> appenders;
+	appenders.reserve(APPENDER_COUNT);
+	for (int appender_idx = 0; appender_idx < APPENDER_COUNT; ++appender_idx) {
+		appenders.emplace_back([&request_trace]() {
+			for (int idx = 0; idx < RECORDS_PER_APPENDER; ++idx) {
+				request_trace.Append(CreateRecord(request_trace.NextTraceId()));
+			}
+		});
+	}
+	for (auto &cur_appender : appenders) {
+		cur_appender.join();
+	}
+	REQUIRE(request_trace.Drain().size() == APPENDER_COUNT * RECORDS_PER_APPENDER);
+}
+
+TEST_CASE("RequestTrace exports blocking requests in Chrome trace format", "[request_trace]") {
+	curl_global_init(CURL_GLOBAL_DEFAULT);
+	auto &request_trace = RequestTrace::GetInstance();
+	request_trace.Drain();
+
+	ENABLE_REQUEST_TRACE = true;
+	CURL *easy_curl = curl_easy_init();
+	curl_easy_setopt(easy_curl, CURLOPT_CONNECTTIMEOUT, 1L);
+	curl_slist *headers = curl_slist_append(nullptr, "Range: bytes=0-99");
+	auto req = make_uniq<CurlRequest>(easy_curl);
+	// Signature of a presigned URL is never recorded.
+	req->SetUrl(string(UNREACHABLE_URL) + "object?X-Amz-Signature=secret");
+	req->SetHeaders(headers);
+	req->SetGetAttrs();
+	auto response = MultiCurlManager::GetInstance().HandleRequest(std::move(req));
+	REQUIRE(response->HasRequestError());
+	ENABLE_REQUEST_TRACE = false;
+
+	std::ostringstream out;
+	REQUIRE(request_trace.ExportChromeTrace(out) == 1);
+	const string trace = out.str();
+	REQUIRE(trace.find("\"traceEvents\":[") != string::npos);
+	REQUIRE(trace.find("\"name\":\"request\"") != string::npos);
+	REQUIRE(trace.find("\"name\":\"queue\"") != string::npos);
+	// Wakeup of the blocking caller is joined with the request.
+	REQUIRE(trace.find("\"name\":\"wakeup\"") != string::npos);
+	REQUIRE(trace.find("\"url\":\"http://127.0.0.1:1/object?X-Amz-Signature=<redacted>\"") != string::npos);
+	REQUIRE(trace.find("secret") == string::npos);
+	REQUIRE(trace.find("\"range\":\"bytes=0-99\"") != string::npos);
+	REQUIRE(trace.find("\"failed\":true") != string::npos);
+	REQUIRE(trace.substr(trace.size() - 3) == "]}\n");
+
+	curl_slist_free_all(headers);
+	curl_easy_cleanup(easy_curl);
+}
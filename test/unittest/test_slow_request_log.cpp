@@ -0,0 +1,99 @@
+#include "catch.hpp"
+
+#include <chrono>
+#include <curl/curl.h>
+
+#include "curl_request.hpp"
+#include "duckdb/common/helper.hpp"
+#include "extension_config.hpp"
+#include "loopback_range_server.hpp"
+#include "multi_curl_manager.hpp"
+#include "slow_request_log.hpp"
+
+using namespace duckdb;
+
+namespace {
+
+constexpr int RESPONSE_DELAY_MS = 50;
+constexpr const char *OBJECT_PATH = "/slow";
+
+// Start a server which answers requests for a 4-byte object after a delay.
+unique_ptr<LoopbackRangeServer> StartDelayedServer() {
+	LoopbackRangeServerConfig config;
+	config.latency = std::chrono::milliseconds(RESPONSE_DELAY_MS);
+	auto server = make_uniq<LoopbackRangeServer>(std::move(config));
+	server->PutObject(OBJECT_PATH, "data");
+	return server;
+}
+
+SlowRequestEntry CreateEntry(uint64_t total_us) {
+	SlowRequestEntry entry;
+	entry.total_us = total_us;
+	return entry;
+}
+
+} // namespace
+
+TEST_CASE("SlowRequestLog keeps the latest entries", "[slow_request_log]") {
+	auto &slow_request_log = SlowRequestLog::GetInstance();
+	slow_request_log.Clear();
+	REQUIRE(slow_request_log.GetEntries().empty());
+
+	for (uint64_t total_us = 1; total_us <= SlowRequestLog::CAPACITY + 10; ++total_us) {
+		slow_request_log.Append(CreateEntry(total_us));
+	}
+	const auto entries = slow_request_log.GetEntries();
+	REQUIRE(entries.size() == SlowRequestLog::CAPACITY);
+	REQUIRE(entries.front().total_us == SlowRequestLog::CAPACITY + 10);
+	REQUIRE(entries.back().total_us == 11);
+	slow_request_log.Clear();
+}
+
+TEST_CASE("MultiCurlManager logs requests slower than the threshold", "[slow_request_log]") {
+	curl_global_init(CURL_GLOBAL_DEFAULT);
+	auto &slow_request_log = SlowRequestLog::GetInstance();
+	slow_request_log.Clear();
+
+	auto handle_request = [](const string &url) {
+		CURL *easy_curl = curl_easy_init();
+		curl_slist *headers = curl_slist_append(nullptr, "Range: bytes=0-3");
+		auto req = make_uniq<CurlRequest>(easy_curl);
+		req->SetUrl(url);
+		req->SetHeaders(headers);
+		req->SetGetAttrs();
+		auto response = MultiCurlManager::GetInstance().HandleRequest(std::move(req));
+		REQUIRE_FALSE(response->HasRequestError());
+		curl_slist_free_all(headers);
+		curl_easy_cleanup(easy_curl);
+	};
+
+	// Requests faster than the threshold are not logged.
+	SLOW_REQUEST_THRESHOLD_MS = 60 * 1000;
+	handle_request(StartDelayedServer()->GetUrl(OBJECT_PATH));
+	REQUIRE(slow_request_log.GetEntries().empty());
+
+	// A new server, so the slow request opens its own connection.
+	SLOW_REQUEST_THRESHOLD_MS = RESPONSE_DELAY_MS / 2;
+	auto server = StartDelayedServer();
+	// Presigned URL signatures are redacted from the log.
+	handle_request(server->GetUrl(string(OBJECT_PATH) + "?X-Amz-Signature=secret"));
+	SLOW_REQUEST_THRESHOLD_MS = DEFAULT_SLOW_REQUEST_THRESHOLD_MS;
+
+	const auto entries = slow_request_log.GetEntries();
+	REQUIRE(entries.size() == 1);
+	const auto &entry = entries[0];
+	REQUIRE(entry.method == "GET");
+	REQUIRE(entry.url == server->GetUrl(string(OBJECT_PATH) + "?X-Amz-Signature=<redacted>"));
+	REQUIRE(entry.range == "bytes=0-3");
+	REQUIRE(entry.status_code == 206);
+	REQUIRE(entry.request_error.empty());
+	REQUIRE(entry.new_connections == 1);
+	REQUIRE(entry.bytes_received == 4);
+	REQUIRE(entry.total_us >= RESPONSE_DELAY_MS * 1000);
+	// The server delay is spent waiting for the first byte.
+	REQUIRE(entry.first_byte_us >= RESPONSE_DELAY_MS * 1000 / 2);
+#if LIBCURL_VERSION_NUM >= 0x080200
+	REQUIRE(entry.connection_id >= 0);
+#endif
+	slow_request_log.Clear();
+}
@@ -0,0 +1,85 @@
+#include "catch.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "duckdb/common/vector.hpp"
+#include "tcp_connection_fetcher.hpp"
+
+using namespace duckdb;
+
+namespace {
+
+// Listen on loopback with the given listener and connect to it with the given client socket, return the port.
+uint16_t Connect(int listen_fd, int client_fd, int family) {
+	sockaddr_storage addr {};
+	socklen_t addr_len = 0;
+	if (family == AF_INET6) {
+		auto &addr6 = reinterpret_cast<sockaddr_in6 &>(addr);
+		addr6.sin6_family = AF_INET6;
+		addr6.sin6_addr = in6addr_loopback;
+		addr_len = sizeof(addr6);
+	} else {
+		auto &addr4 = reinterpret_cast<sockaddr_in &>(addr);
+		addr4.sin_family = AF_INET;
+		addr4.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		addr_len = sizeof(addr4);
+	}
+	REQUIRE(bind(listen_fd, reinterpret_cast<sockaddr *>(&addr), addr_len) == 0);
+	REQUIRE(listen(listen_fd, /*backlog=*/1) == 0);
+	getsockname(listen_fd, reinterpret_cast<sockaddr *>(&addr), &addr_len);
+	REQUIRE(connect(client_fd, reinterpret_cast<sockaddr *>(&addr), addr_len) == 0);
+	return family == AF_INET6 ? ntohs(reinterpret_cast<sockaddr_in6 &>(addr).sin6_port)
+	                          : ntohs(reinterpret_cast<sockaddr_in &>(addr).sin_port);
+}
+
+const TcpConnectionInfo *FindConnection(const vector<TcpConnectionInfo> &tcp_conns, const string &remote_ip,
+                                        uint16_t remote_port) {
+	for (const auto &cur_conn : tcp_conns) {
+		if (cur_conn.remote_ip == remote_ip && cur_conn.remote_port == remote_port) {
+			return &cur_conn;
+		}
+	}
+	return nullptr;
+}
+
+} // namespace
+
+TEST_CASE("TCP connections of the current process are listed with TCP_INFO", "[tcp_connection]") {
+	const int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+	const int client_fd = socket(AF_INET, SOCK_STREAM, 0);
+	const uint16_t port = Connect(listen_fd, client_fd, AF_INET);
+
+	const auto tcp_conns = GetTcpConnections();
+	const auto *conn = FindConnection(tcp_conns, "127.0.0.1", port);
+	REQUIRE(conn != nullptr);
+	REQUIRE(conn->local_ip == "127.0.0.1");
+	REQUIRE(conn->state == "ESTABLISHED");
+	// TCP_INFO is only fetched on Linux.
+#if !defined(__APPLE__) && !defined(__MACH__)
+	REQUIRE(conn->has_tcp_info);
+	REQUIRE(conn->cwnd > 0);
+#endif
+	close(client_fd);
+	close(listen_fd);
+}
+
+TEST_CASE("IPv6 TCP connections are listed with full addresses", "[tcp_connection]") {
+	const int listen_fd = socket(AF_INET6, SOCK_STREAM, 0);
+	if (listen_fd < 0) {
+		// IPv6 is not available in the environment.
+		return;
+	}
+	const int client_fd = socket(AF_INET6, SOCK_STREAM, 0);
+	const uint16_t port = Connect(listen_fd, client_fd, AF_INET6);
+
+	const auto tcp_conns = GetTcpConnections();
+	const auto *conn = FindConnection(tcp_conns, "::1", port);
+	REQUIRE(conn != nullptr);
+	REQUIRE(conn->local_ip == "::1");
+	REQUIRE(conn->state == "ESTABLISHED");
+	close(client_fd);
+	close(listen_fd);
+}
@@ -0,0 +1,101 @@
+#include "catch.hpp"
+
+#include "duckdb/common/vector.hpp"
+#include "timer_wheel.hpp"
+
+using namespace duckdb;
+
+namespace {
+
+constexpr int64_t TICK_MS = 10;
+constexpr idx_t SLOT_COUNT = 8;
+
+} // namespace
+
+TEST_CASE("TimerWheel expires deadlines in order of time", "[timer_wheel]") {
+	TimerWheel wheel(TICK_MS, SLOT_COUNT);
+	REQUIRE(wheel.GetTimeoutMs(/*now_ms=*/1000) == -1);
+
+	wheel.Add(/*deadline_ms=*/1015, /*id=*/1);
+	wheel.Add(/*deadline_ms=*/1055, /*id=*/2);
+	// Beyond one round of the wheel.
+	wheel.Add(/*deadline_ms=*/1215, /*id=*/3);
+	REQUIRE(wheel.Size() == 3);
+	REQUIRE(wheel.GetTimeoutMs(/*now_ms=*/1000) == 15);
+
+	vector<uint64_t> expired;
+	auto collect = [&expired](uint64_t id) { expired.emplace_back(id); };
+	wheel.Advance(/*now_ms=*/1014, collect);
+	REQUIRE(expired.empty());
+	wheel.Advance(/*now_ms=*/1015, collect);
+	REQUIRE(expired == vector<uint64_t> {1});
+	REQUIRE(wheel.GetTimeoutMs(/*now_ms=*/1015) == 40);
+
+	// Deadline of a later round sharing the slot is kept.
+	wheel.Advance(/*now_ms=*/1100, collect);
+	REQUIRE(expired == vector<uint64_t> {1, 2});
+	REQUIRE(wheel.Size() == 1);
+	// Only a deadline of a later round is pending.
+	REQUIRE(wheel.GetTimeoutMs(/*now_ms=*/1100) == 115);
+	// An earlier deadline takes over the cached earliest one.
+	wheel.Add(/*deadline_ms=*/1150, /*id=*/4);
+	REQUIRE(wheel.GetTimeoutMs(/*now_ms=*/1100) == 50);
+	wheel.Advance(/*now_ms=*/1150, collect);
+	REQUIRE(expired == vector<uint64_t> {1, 2, 4});
+	REQUIRE(wheel.GetTimeoutMs(/*now_ms=*/1150) == 65);
+	wheel.Advance(/*now_ms=*/1214, collect);
+	REQUIRE(wheel.Size() == 1);
+	wheel.Advance(/*now_ms=*/1215, collect);
+	REQUIRE(expired == vector<uint64_t> {1, 2, 4, 3});
+	REQUIRE(wheel.GetTimeoutMs(/*now_ms=*/1215) == -1);
+}
+
+TEST_CASE("TimerWheel expires passed deadlines on next advance", "[timer_wheel]") {
+	TimerWheel wheel(TICK_MS, SLOT_COUNT);
+	vector<uint64_t> expired;
+	auto collect = [&expired](uint64_t id) { expired.emplace_back(id); };
+	wheel.Advance(/*now_ms=*/1000, collect);
+
+	wheel.Add(/*deadline_ms=*/500, /*id=*/1);
+	REQUIRE(wheel.GetTimeoutMs(/*now_ms=*/1000) == 0);
+	wheel.Advance(/*now_ms=*/1000, collect);
+	REQUIRE(expired == vector<uint64_t> {1});
+
+	// Clock jumps over multiple rounds.
+	wheel.Add(/*deadline_ms=*/1020, /*id=*/2);
+	wheel.Add(/*deadline_ms=*/1070, /*id=*/3);
+	wheel.Advance(/*now_ms=*/5000, collect);
+	REQUIRE(expired == vector<uint64_t> {1, 2, 3});
+	REQUIRE(wheel.Size() == 0);
+}
+
+TEST_CASE("TimerWheel removes deadlines before expiration", "[timer_wheel]") {
+	TimerWheel wheel(TICK_MS, SLOT_COUNT);
+	vector<uint64_t> expired;
+	auto collect = [&expired](uint64_t id) { expired.emplace_back(id); };
+	wheel.Advance(/*now_ms=*/1000, collect);
+
+	wheel.Add(/*deadline_ms=*/1015, /*id=*/1);
+	wheel.Add(/*deadline_ms=*/1055, /*id=*/2);
+	// Shares the slot with the first deadline, of a later round.
+	wheel.Add(/*deadline_ms=*/1095, /*id=*/3);
+	// Passed when added.
+	wheel.Add(/*deadline_ms=*/500, /*id=*/4);
+	REQUIRE(wheel.Size() == 4);
+
+	// The cached earliest deadline is recomputed once removed.
+	REQUIRE(wheel.Remove(/*deadline_ms=*/500, /*id=*/4));
+	REQUIRE(wheel.GetTimeoutMs(/*now_ms=*/1000) == 15);
+	REQUIRE(wheel.Remove(/*deadline_ms=*/1015, /*id=*/1));
+	REQUIRE(wheel.GetTimeoutMs(/*now_ms=*/1000) == 55);
+	REQUIRE_FALSE(wheel.Remove(/*deadline_ms=*/1015, /*id=*/1));
+	REQUIRE(wheel.Size() == 2);
+
+	wheel.Advance(/*now_ms=*/1060, collect);
+	REQUIRE(expired == vector<uint64_t> {2});
+	// Expired deadlines are no longer found.
+	REQUIRE_FALSE(wheel.Remove(/*deadline_ms=*/1055, /*id=*/2));
+	REQUIRE(wheel.Remove(/*deadline_ms=*/1095, /*id=*/3));
+	REQUIRE(wheel.Size() == 0);
+	REQUIRE(wheel.GetTimeoutMs(/*now_ms=*/1060) == -1);
+}
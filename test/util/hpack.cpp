@@ -0,0 +1,361 @@
+#include "hpack.hpp"
+
+#include <array>
+#include <cstdint>
+
+namespace duckdb {
+
+namespace {
+
+// Size overhead of each dynamic table entry.
+constexpr idx_t ENTRY_OVERHEAD = 32;
+
+constexpr std::array<const char *[2], 61> STATIC_TABLE {{
+    {":authority", ""},
+    {":method", "GET"},
+    {":method", "POST"},
+    {":path", "/"},
+    {":path", "/index.html"},
+    {":scheme", "http"},
+    {":scheme", "https"},
+    {":status", "200"},
+    {":status", "204"},
+    {":status", "206"},
+    {":status", "304"},
+    {":status", "400"},
+    {":status", "404"},
+    {":status", "500"},
+    {"accept-charset", ""},
+    {"accept-encoding", "gzip, deflate"},
+    {"accept-language", ""},
+    {"accept-ranges", ""},
+    {"accept", ""},
+    {"access-control-allow-origin", ""},
+    {"age", ""},
+    {"allow", ""},
+    {"authorization", ""},
+    {"cache-control", ""},
+    {"content-disposition", ""},
+    {"content-encoding", ""},
+    {"content-language", ""},
+    {"content-length", ""},
+    {"content-location", ""},
+    {"content-range", ""},
+    {"content-type", ""},
+    {"cookie", ""},
+    {"date", ""},
+    {"etag", ""},
+    {"expect", ""},
+    {"expires", ""},
+    {"from", ""},
+    {"host", ""},
+    {"if-match", ""},
+    {"if-modified-since", ""},
+    {"if-none-match", ""},
+    {"if-range", ""},
+    {"if-unmodified-since", ""},
+    {"last-modified", ""},
+    {"link", ""},
+    {"location", ""},
+    {"max-forwards", ""},
+    {"proxy-authenticate", ""},
+    {"proxy-authorization", ""},
+    {"range", ""},
+    {"referer", ""},
+    {"refresh", ""},
+    {"retry-after", ""},
+    {"server", ""},
+    {"set-cookie", ""},
+    {"strict-transport-security", ""},
+    {"transfer-encoding", ""},
+    {"user-agent", ""},
+    {"vary", ""},
+    {"via", ""},
+    {"www-authenticate", ""},
+}};
+
+// Huffman code of each byte, see RFC 7541 Appendix B.
+constexpr std::array<uint32_t, 256> HUFFMAN_CODES {{
+    0x1ff8, 0x7fffd8, 0xfffffe2, 0xfffffe3, 0xfffffe4, 0xfffffe5, 0xfffffe6, 0xfffffe7,
+    0xfffffe8, 0xffffea, 0x3ffffffc, 0xfffffe9, 0xfffffea, 0x3ffffffd, 0xfffffeb, 0xfffffec,
+    0xfffffed, 0xfffffee, 0xfffffef, 0xffffff0, 0xffffff1, 0xffffff2, 0x3ffffffe, 0xffffff3,
+    0xffffff4, 0xffffff5, 0xffffff6, 0xffffff7, 0xffffff8, 0xffffff9, 0xffffffa, 0xffffffb,
+    0x14, 0x3f8, 0x3f9, 0xffa, 0x1ff9, 0x15, 0xf8, 0x7fa,
+    0x3fa, 0x3fb, 0xf9, 0x7fb, 0xfa, 0x16, 0x17, 0x18,
+    0x0, 0x1, 0x2, 0x19, 0x1a, 0x1b, 0x1c, 0x1d,
+    0x1e, 0x1f, 0x5c, 0xfb, 0x7ffc, 0x20, 0xffb, 0x3fc,
+    0x1ffa, 0x21, 0x5d, 0x5e, 0x5f, 0x60, 0x61, 0x62,
+    0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a,
+    0x6b, 0x6c, 0x6d, 0x6e, 0x6f, 0x70, 0x71, 0x72,
+    0xfc, 0x73, 0xfd, 0x1ffb, 0x7fff0, 0x1ffc, 0x3ffc, 0x22,
+    0x7ffd, 0x3, 0x23, 0x4, 0x24, 0x5, 0x25, 0x26,
+    0x27, 0x6, 0x74, 0x75, 0x28, 0x29, 0x2a, 0x7,
+    0x2b, 0x76, 0x2c, 0x8, 0x9, 0x2d, 0x77, 0x78,
+    0x79, 0x7a, 0x7b, 0x7ffe, 0x7fc, 0x3ffd, 0x1ffd, 0xffffffc,
+    0xfffe6, 0x3fffd2, 0xfffe7, 0xfffe8, 0x3fffd3, 0x3fffd4, 0x3fffd5, 0x7fffd9,
+    0x3fffd6, 0x7fffda, 0x7fffdb, 0x7fffdc, 0x7fffdd, 0x7fffde, 0xffffeb, 0x7fffdf,
+    0xffffec, 0xffffed, 0x3fffd7, 0x7fffe0, 0xffffee, 0x7fffe1, 0x7fffe2, 0x7fffe3,
+    0x7fffe4, 0x1fffdc, 0x3fffd8, 0x7fffe5, 0x3fffd9, 0x7fffe6, 0x7fffe7, 0xffffef,
+    0x3fffda, 0x1fffdd, 0xfffe9, 0x3fffdb, 0x3fffdc, 0x7fffe8, 0x7fffe9, 0x1fffde,
+    0x7fffea, 0x3fffdd, 0x3fffde, 0xfffff0, 0x1fffdf, 0x3fffdf, 0x7fffeb, 0x7fffec,
+    0x1fffe0, 0x1fffe1, 0x3fffe0, 0x1fffe2, 0x7fffed, 0x3fffe1, 0x7fffee, 0x7fffef,
+    0xfffea, 0x3fffe2, 0x3fffe3, 0x3fffe4, 0x7ffff0, 0x3fffe5, 0x3fffe6, 0x7ffff1,
+    0x3ffffe0, 0x3ffffe1, 0xfffeb, 0x7fff1, 0x3fffe7, 0x7ffff2, 0x3fffe8, 0x1ffffec,
+    0x3ffffe2, 0x3ffffe3, 0x3ffffe4, 0x7ffffde, 0x7ffffdf, 0x3ffffe5, 0xfffff1, 0x1ffffed,
+    0x7fff2, 0x1fffe3, 0x3ffffe6, 0x7ffffe0, 0x7ffffe1, 0x3ffffe7, 0x7ffffe2, 0xfffff2,
+    0x1fffe4, 0x1fffe5, 0x3ffffe8, 0x3ffffe9, 0xffffffd, 0x7ffffe3, 0x7ffffe4, 0x7ffffe5,
+    0xfffec, 0xfffff3, 0xfffed, 0x1fffe6, 0x3fffe9, 0x1fffe7, 0x1fffe8, 0x7ffff3,
+    0x3fffea, 0x3fffeb, 0x1ffffee, 0x1ffffef, 0xfffff4, 0xfffff5, 0x3ffffea, 0x7ffff4,
+    0x3ffffeb, 0x7ffffe6, 0x3ffffec, 0x3ffffed, 0x7ffffe7, 0x7ffffe8, 0x7ffffe9, 0x7ffffea,
+    0x7ffffeb, 0xffffffe, 0x7ffffec, 0x7ffffed, 0x7ffffee, 0x7ffffef, 0x7fffff0, 0x3ffffee,
+}};
+constexpr std::array<uint8_t, 256> HUFFMAN_CODE_LENS {{
+    13, 23, 28, 28, 28, 28, 28, 28, 28, 24, 30, 28, 28, 30, 28, 28,
+    28, 28, 28, 28, 28, 28, 30, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    6, 10, 10, 12, 13, 6, 8, 11, 10, 10, 8, 11, 8, 6, 6, 6,
+    5, 5, 5, 6, 6, 6, 6, 6, 6, 6, 7, 8, 15, 6, 12, 10,
+    13, 6, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+    7, 7, 7, 7, 7, 7, 7, 7, 8, 7, 8, 13, 19, 13, 14, 6,
+    15, 5, 6, 5, 6, 5, 6, 6, 6, 5, 7, 7, 6, 6, 6, 5,
+    6, 7, 6, 5, 5, 6, 7, 7, 7, 7, 7, 15, 11, 14, 13, 28,
+    20, 22, 20, 20, 22, 22, 22, 23, 22, 23, 23, 23, 23, 23, 24, 23,
+    24, 24, 22, 23, 24, 23, 23, 23, 23, 21, 22, 23, 22, 23, 23, 24,
+    22, 21, 20, 22, 22, 23, 23, 21, 23, 22, 22, 24, 21, 22, 23, 23,
+    21, 21, 22, 21, 23, 22, 23, 23, 20, 22, 22, 22, 23, 22, 22, 23,
+    26, 26, 20, 19, 22, 23, 22, 25, 26, 26, 26, 27, 27, 26, 24, 25,
+    19, 21, 26, 27, 27, 26, 27, 24, 21, 21, 26, 26, 28, 27, 27, 27,
+    20, 24, 20, 21, 22, 21, 21, 23, 22, 22, 25, 25, 24, 24, 26, 23,
+    26, 27, 26, 26, 27, 27, 27, 27, 27, 28, 27, 27, 27, 27, 27, 26,
+}};
+
+// Binary trie of Huffman codes, built once.
+class HuffmanTrie {
+public:
+	struct Node {
+		// Index of children for bit 0 and 1, 0 means none since the root is never a child.
+		std::array<uint16_t, 2> children {{0, 0}};
+		// Decoded byte for leaves, -1 for inner nodes.
+		int16_t symbol = -1;
+	};
+
+	HuffmanTrie() {
+		nodes.emplace_back();
+		for (idx_t symbol = 0; symbol < HUFFMAN_CODES.size(); ++symbol) {
+			idx_t node_idx = 0;
+			for (int bit_idx = HUFFMAN_CODE_LENS[symbol] - 1; bit_idx >= 0; --bit_idx) {
+				const auto bit = (HUFFMAN_CODES[symbol] >> bit_idx) & 1;
+				if (nodes[node_idx].children[bit] == 0) {
+					nodes[node_idx].children[bit] = static_cast<uint16_t>(nodes.size());
+					nodes.emplace_back();
+				}
+				node_idx = nodes[node_idx].children[bit];
+			}
+			nodes[node_idx].symbol = static_cast<int16_t>(symbol);
+		}
+	}
+
+	static const HuffmanTrie &GetInstance() {
+		static auto *trie = new HuffmanTrie();
+		return *trie;
+	}
+
+	vector<Node> nodes;
+};
+
+// Decode an integer with the given prefix bits at the given position, see RFC 7541 Section 5.1.
+bool DecodeInteger(const string &block, idx_t &pos, int prefix_bits, uint64_t &value) {
+	if (pos >= block.size()) {
+		return false;
+	}
+	const uint8_t prefix_max = static_cast<uint8_t>((1 << prefix_bits) - 1);
+	value = static_cast<uint8_t>(block[pos++]) & prefix_max;
+	if (value < prefix_max) {
+		return true;
+	}
+	for (int shift = 0; shift < 63; shift += 7) {
+		if (pos >= block.size()) {
+			return false;
+		}
+		const uint8_t cur_byte = static_cast<uint8_t>(block[pos++]);
+		value += static_cast<uint64_t>(cur_byte & 0x7f) << shift;
+		if ((cur_byte & 0x80) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// Decode a string literal at the given position, see RFC 7541 Section 5.2.
+bool DecodeString(const string &block, idx_t &pos, string &value) {
+	if (pos >= block.size()) {
+		return false;
+	}
+	const bool huffman = (static_cast<uint8_t>(block[pos]) & 0x80) != 0;
+	uint64_t length = 0;
+	if (!DecodeInteger(block, pos, /*prefix_bits=*/7, length) || length > block.size() - pos) {
+		return false;
+	}
+	value.clear();
+	if (huffman) {
+		if (!HpackHuffmanDecode(block.data() + pos, length, value)) {
+			return false;
+		}
+	} else {
+		value.assign(block, pos, length);
+	}
+	pos += length;
+	return true;
+}
+
+void EncodeInteger(uint64_t value, int prefix_bits, uint8_t first_byte, string &out) {
+	const uint64_t prefix_max = (1ULL << prefix_bits) - 1;
+	if (value < prefix_max) {
+		out.push_back(static_cast<char>(first_byte | value));
+		return;
+	}
+	out.push_back(static_cast<char>(first_byte | prefix_max));
+	value -= prefix_max;
+	while (value >= 0x80) {
+		out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+		value >>= 7;
+	}
+	out.push_back(static_cast<char>(value));
+}
+
+void EncodeString(const string &value, string &out) {
+	EncodeInteger(value.size(), /*prefix_bits=*/7, /*first_byte=*/0, out);
+	out += value;
+}
+
+} // namespace
+
+bool HpackHuffmanDecode(const char *data, idx_t size, string &out) {
+	const auto &nodes = HuffmanTrie::GetInstance().nodes;
+	idx_t node_idx = 0;
+	// Number of bits consumed since the last decoded symbol, and whether they're all ones.
+	int pending_bits = 0;
+	bool pending_all_ones = true;
+	for (idx_t idx = 0; idx < size; ++idx) {
+		const uint8_t cur_byte = static_cast<uint8_t>(data[idx]);
+		for (int bit_idx = 7; bit_idx >= 0; --bit_idx) {
+			const auto bit = (cur_byte >> bit_idx) & 1;
+			node_idx = nodes[node_idx].children[bit];
+			if (node_idx == 0) {
+				return false;
+			}
+			++pending_bits;
+			pending_all_ones = pending_all_ones && bit == 1;
+			if (nodes[node_idx].symbol >= 0) {
+				out.push_back(static_cast<char>(nodes[node_idx].symbol));
+				node_idx = 0;
+				pending_bits = 0;
+				pending_all_ones = true;
+			}
+		}
+	}
+	// Padding is the most significant bits of EOS, which are all ones and shorter than a byte.
+	return pending_bits < 8 && pending_all_ones;
+}
+
+bool HpackDecoder::Decode(const string &block, vector<HpackHeader> &headers) {
+	idx_t pos = 0;
+	while (pos < block.size()) {
+		const uint8_t cur_byte = static_cast<uint8_t>(block[pos]);
+		uint64_t index = 0;
+		// Indexed header field.
+		if (cur_byte & 0x80) {
+			HpackHeader field;
+			if (!DecodeInteger(block, pos, /*prefix_bits=*/7, index) || !GetIndexedField(index, field)) {
+				return false;
+			}
+			headers.emplace_back(std::move(field));
+			continue;
+		}
+		// Dynamic table size update.
+		if ((cur_byte & 0xe0) == 0x20) {
+			uint64_t new_size = 0;
+			if (!DecodeInteger(block, pos, /*prefix_bits=*/5, new_size) || new_size > DEFAULT_TABLE_SIZE) {
+				return false;
+			}
+			max_table_size = new_size;
+			EvictToFit(max_table_size);
+			continue;
+		}
+		// Literal header field, with incremental indexing or not.
+		const bool add_to_table = (cur_byte & 0xc0) == 0x40;
+		const int prefix_bits = add_to_table ? 6 : 4;
+		if (!DecodeInteger(block, pos, prefix_bits, index)) {
+			return false;
+		}
+		HpackHeader field;
+		if (index == 0) {
+			if (!DecodeString(block, pos, field.first)) {
+				return false;
+			}
+		} else {
+			HpackHeader indexed_field;
+			if (!GetIndexedField(index, indexed_field)) {
+				return false;
+			}
+			field.first = std::move(indexed_field.first);
+		}
+		if (!DecodeString(block, pos, field.second)) {
+			return false;
+		}
+		if (add_to_table) {
+			AddField(field);
+		}
+		headers.emplace_back(std::move(field));
+	}
+	return true;
+}
+
+bool HpackDecoder::GetIndexedField(uint64_t index, HpackHeader &field) const {
+	if (index == 0) {
+		return false;
+	}
+	if (index <= STATIC_TABLE.size()) {
+		field.first = STATIC_TABLE[index - 1][0];
+		field.second = STATIC_TABLE[index - 1][1];
+		return true;
+	}
+	const uint64_t dynamic_index = index - STATIC_TABLE.size() - 1;
+	if (dynamic_index >= dynamic_table.size()) {
+		return false;
+	}
+	field = dynamic_table[dynamic_index];
+	return true;
+}
+
+void HpackDecoder::AddField(HpackHeader field) {
+	const idx_t field_size = field.first.size() + field.second.size() + ENTRY_OVERHEAD;
+	// An entry larger than the table empties it without being inserted.
+	if (field_size > max_table_size) {
+		EvictToFit(0);
+		return;
+	}
+	EvictToFit(max_table_size - field_size);
+	dynamic_table.emplace_front(std::move(field));
+	table_size += field_size;
+}
+
+void HpackDecoder::EvictToFit(idx_t max_size) {
+	while (table_size > max_size) {
+		const auto &oldest = dynamic_table.back();
+		table_size -= oldest.first.size() + oldest.second.size() + ENTRY_OVERHEAD;
+		dynamic_table.pop_back();
+	}
+}
+
+/*static*/ string HpackEncoder::Encode(const vector<HpackHeader> &headers) {
+	string out;
+	for (const auto &cur_header : headers) {
+		// Literal header field without indexing, with a new name.
+		out.push_back(0);
+		EncodeString(cur_header.first, out);
+		EncodeString(cur_header.second, out);
+	}
+	return out;
+}
+
+} // namespace duckdb
@@ -0,0 +1,50 @@
+// Minimal HPACK (RFC 7541) codec for the HTTP/2 loopback server used by tests and benchmarks.
+//
+// The decoder supports everything a client could send: indexed fields, literals with or without indexing, dynamic
+// table size updates and Huffman-coded strings. The encoder never indexes or Huffman-codes, which keeps server state
+// independent of the client's dynamic table.
+
+#pragma once
+
+#include <deque>
+#include <utility>
+
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/typedefs.hpp"
+#include "duckdb/common/vector.hpp"
+
+namespace duckdb {
+
+using HpackHeader = std::pair<string, string>;
+
+class HpackDecoder {
+public:
+	// Default dynamic table size, see SETTINGS_HEADER_TABLE_SIZE.
+	static constexpr idx_t DEFAULT_TABLE_SIZE = 4096;
+
+	// Decode the given header block, and append fields in order; return false if the block is malformed.
+	bool Decode(const string &block, vector<HpackHeader> &headers);
+
+private:
+	// Get the field at the given index of the static table followed by the dynamic table.
+	bool GetIndexedField(uint64_t index, HpackHeader &field) const;
+	// Insert the given field into the dynamic table, evicting the oldest entries to fit.
+	void AddField(HpackHeader field);
+	void EvictToFit(idx_t max_size);
+
+	// Newest entry first.
+	std::deque<HpackHeader> dynamic_table;
+	idx_t table_size = 0;
+	idx_t max_table_size = DEFAULT_TABLE_SIZE;
+};
+
+class HpackEncoder {
+public:
+	// Encode the given fields as literals without indexing.
+	static string Encode(const vector<HpackHeader> &headers);
+};
+
+// Decode the given Huffman-coded string, return false if it's malformed.
+bool HpackHuffmanDecode(const char *data, idx_t size, string &out);
+
+} // namespace duckdb
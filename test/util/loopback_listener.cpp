@@ -0,0 +1,76 @@
+#include "loopback_listener.hpp"
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/string_util.hpp"
+
+namespace duckdb {
+
+namespace {
+
+// Backlog of listeners which never accept, large enough to hold all connections of a test.
+constexpr int LISTENER_BACKLOG = 128;
+
+} // namespace
+
+int ListenOnLoopback(int backlog, int &port) {
+	const int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+	if (listen_fd < 0) {
+		throw IOException("Failed to create loopback listener: %s", std::strerror(errno));
+	}
+	const int reuse_addr = 1;
+	setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse_addr, sizeof(reuse_addr));
+	sockaddr_in addr {};
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	addr.sin_port = 0;
+	socklen_t addr_len = sizeof(addr);
+	if (bind(listen_fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0 || listen(listen_fd, backlog) < 0 ||
+	    getsockname(listen_fd, reinterpret_cast<sockaddr *>(&addr), &addr_len) < 0) {
+		const int errnum = errno;
+		close(listen_fd);
+		throw IOException("Failed to listen on loopback: %s", std::strerror(errnum));
+	}
+	port = ntohs(addr.sin_port);
+	return listen_fd;
+}
+
+LoopbackListener::LoopbackListener() {
+	listen_fd = ListenOnLoopback(LISTENER_BACKLOG, port);
+	if (fcntl(listen_fd, F_SETFL, fcntl(listen_fd, F_GETFL) | O_NONBLOCK) < 0) {
+		const int errnum = errno;
+		close(listen_fd);
+		throw IOException("Failed to make loopback listener non-blocking: %s", std::strerror(errnum));
+	}
+}
+
+LoopbackListener::~LoopbackListener() {
+	for (int fd : accepted_fds) {
+		close(fd);
+	}
+	close(listen_fd);
+}
+
+string LoopbackListener::GetUrl(const string &path) const {
+	return StringUtil::Format("http://127.0.0.1:%d%s", port, path);
+}
+
+idx_t LoopbackListener::AcceptPending() {
+	while (true) {
+		const int fd = accept(listen_fd, nullptr, nullptr);
+		if (fd < 0) {
+			break;
+		}
+		accepted_fds.emplace_back(fd);
+	}
+	return accepted_fds.size();
+}
+
+} // namespace duckdb
@@ -0,0 +1,46 @@
+// Listening sockets on loopback for tests which need connections to be established but never responded, and the
+// shared address which refuses connections.
+
+#pragma once
+
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/typedefs.hpp"
+#include "duckdb/common/vector.hpp"
+
+namespace duckdb {
+
+// Loopback port 1 is reserved and should have no listener — triggers CURLE_COULDNT_CONNECT quickly.
+constexpr const char *UNREACHABLE_URL = "http://127.0.0.1:1/";
+
+// Create a socket listening on an ephemeral loopback port, and assign the port to [`port`]; throw IOException on
+// failure.
+int ListenOnLoopback(int backlog, int &port);
+
+// A listener on loopback which never responds. Connections are established by the kernel, and only accepted on
+// [`AcceptPending`], so requests to it hang until cancelled or timed out.
+class LoopbackListener {
+public:
+	LoopbackListener();
+	// Close the listener and all accepted connections.
+	~LoopbackListener();
+
+	// Disable copy / move constructor / assignment.
+	LoopbackListener(const LoopbackListener &) = delete;
+	LoopbackListener &operator=(const LoopbackListener &) = delete;
+
+	// Get the URL of the given path, i.e. `http://127.0.0.1:<port>/`.
+	string GetUrl(const string &path = "/") const;
+	int GetPort() const {
+		return port;
+	}
+
+	// Accept all connections established so far without blocking, and return number of connections accepted so far.
+	idx_t AcceptPending();
+
+private:
+	int listen_fd = -1;
+	int port = 0;
+	vector<int> accepted_fds;
+};
+
+} // namespace duckdb
@@ -0,0 +1,886 @@
+#include "loopback_range_server.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <map>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/helper.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "hpack.hpp"
+#include "loopback_listener.hpp"
+
+namespace duckdb {
+
+namespace {
+
+constexpr const char *HTTP2_PREFACE = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n";
+constexpr idx_t HTTP2_PREFACE_LEN = 24;
+constexpr idx_t HTTP2_FRAME_HEADER_LEN = 9;
+// Default flow control window and frame size, see RFC 9113 Section 6.5.2.
+constexpr int64_t HTTP2_DEFAULT_WINDOW = 65535;
+constexpr uint32_t HTTP2_DEFAULT_MAX_FRAME_SIZE = 16384;
+constexpr uint32_t HTTP2_MAX_CONCURRENT_STREAMS = 256;
+// Chunk size of HTTP/1.1 body writes, which is also the granularity of bandwidth pacing.
+constexpr idx_t HTTP1_CHUNK_SIZE = 16 * 1024;
+constexpr idx_t RECV_BUFFER_SIZE = 64 * 1024;
+// Error code of RST_STREAM frames sent for truncated bodies, see RFC 9113 Section 7.
+constexpr uint32_t HTTP2_INTERNAL_ERROR = 0x2;
+constexpr const char *SLOW_DOWN_BODY =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<Error><Code>SlowDown</Code><Message>Please reduce your request "
+    "rate.</Message></Error>";
+
+enum Http2FrameType : uint8_t {
+	DATA = 0x0,
+	HEADERS = 0x1,
+	PRIORITY = 0x2,
+	RST_STREAM = 0x3,
+	SETTINGS = 0x4,
+	PUSH_PROMISE = 0x5,
+	PING = 0x6,
+	GOAWAY = 0x7,
+	WINDOW_UPDATE = 0x8,
+	CONTINUATION = 0x9,
+};
+
+enum Http2Flag : uint8_t {
+	END_STREAM = 0x1,
+	ACK = 0x1,
+	END_HEADERS = 0x4,
+	PADDED = 0x8,
+	PRIORITY_FLAG = 0x20,
+};
+
+enum Http2Setting : uint16_t {
+	MAX_CONCURRENT_STREAMS = 0x3,
+	INITIAL_WINDOW_SIZE = 0x4,
+	MAX_FRAME_SIZE = 0x5,
+};
+
+bool SendAll(int fd, const char *data, idx_t size) {
+	while (size > 0) {
+		const ssize_t sent = send(fd, data, size, MSG_NOSIGNAL);
+		if (sent <= 0) {
+			return false;
+		}
+		data += sent;
+		size -= static_cast<idx_t>(sent);
+	}
+	return true;
+}
+
+// Receive more bytes into the given buffer, return false if the connection is closed.
+bool RecvMore(int fd, string &pending) {
+	char buf[RECV_BUFFER_SIZE];
+	const ssize_t received = recv(fd, buf, sizeof(buf), 0);
+	if (received <= 0) {
+		return false;
+	}
+	pending.append(buf, static_cast<size_t>(received));
+	return true;
+}
+
+void AppendUint32(string &out, uint32_t value) {
+	out.push_back(static_cast<char>((value >> 24) & 0xff));
+	out.push_back(static_cast<char>((value >> 16) & 0xff));
+	out.push_back(static_cast<char>((value >> 8) & 0xff));
+	out.push_back(static_cast<char>(value & 0xff));
+}
+
+uint32_t ReadUint32(const char *data) {
+	return (static_cast<uint32_t>(static_cast<uint8_t>(data[0])) << 24) |
+	       (static_cast<uint32_t>(static_cast<uint8_t>(data[1])) << 16) |
+	       (static_cast<uint32_t>(static_cast<uint8_t>(data[2])) << 8) |
+	       static_cast<uint32_t>(static_cast<uint8_t>(data[3]));
+}
+
+bool SendHttp2Frame(int fd, uint8_t type, uint8_t flags, uint32_t stream_id, const char *payload, idx_t size) {
+	string frame;
+	frame.reserve(HTTP2_FRAME_HEADER_LEN + size);
+	frame.push_back(static_cast<char>((size >> 16) & 0xff));
+	frame.push_back(static_cast<char>((size >> 8) & 0xff));
+	frame.push_back(static_cast<char>(size & 0xff));
+	frame.push_back(static_cast<char>(type));
+	frame.push_back(static_cast<char>(flags));
+	AppendUint32(frame, stream_id & 0x7fffffff);
+	frame.append(payload, size);
+	return SendAll(fd, frame.data(), frame.size());
+}
+
+bool SendHttp2Frame(int fd, uint8_t type, uint8_t flags, uint32_t stream_id, const string &payload) {
+	return SendHttp2Frame(fd, type, flags, stream_id, payload.data(), payload.size());
+}
+
+// Paces body bytes sent on a connection to the configured bandwidth.
+class BandwidthPacer {
+public:
+	explicit BandwidthPacer(uint64_t bandwidth_bytes_per_sec_p) : bandwidth_bytes_per_sec(bandwidth_bytes_per_sec_p) {
+	}
+
+	// Time point after which the next chunk could be sent.
+	std::chrono::steady_clock::time_point GetNextSendTime() const {
+		return next_send_time;
+	}
+
+	// Account the given bytes sent.
+	void OnSent(idx_t bytes) {
+		if (bandwidth_bytes_per_sec == 0) {
+			return;
+		}
+		const auto now = std::chrono::steady_clock::now();
+		next_send_time = std::max(next_send_time, now) +
+		                 std::chrono::microseconds(bytes * 1000 * 1000 / bandwidth_bytes_per_sec);
+	}
+
+private:
+	const uint64_t bandwidth_bytes_per_sec;
+	std::chrono::steady_clock::time_point next_send_time;
+};
+
+// Parse the given range header against the object size into inclusive offsets, return false if it's unsatisfiable.
+bool ParseRange(const string &range, idx_t object_size, idx_t &start, idx_t &end) {
+	constexpr const char *RANGE_PREFIX = "bytes=";
+	if (!StringUtil::StartsWith(range, RANGE_PREFIX)) {
+		return false;
+	}
+	const string spec = range.substr(strlen(RANGE_PREFIX));
+	const auto dash_pos = spec.find('-');
+	if (dash_pos == string::npos || object_size == 0) {
+		return false;
+	}
+	const string first = spec.substr(0, dash_pos);
+	const string last = spec.substr(dash_pos + 1);
+	try {
+		// Suffix range of the last bytes.
+		if (first.empty()) {
+			const idx_t suffix_len = std::stoull(last);
+			if (suffix_len == 0) {
+				return false;
+			}
+			start = object_size - std::min(suffix_len, object_size);
+			end = object_size - 1;
+			return true;
+		}
+		start = std::stoull(first);
+		end = last.empty() ? object_size - 1 : std::min<idx_t>(std::stoull(last), object_size - 1);
+	} catch (...) {
+		return false;
+	}
+	return start <= end && start < object_size;
+}
+
+string GetStatusText(int status) {
+	switch (status) {
+	case 101:
+		return "Switching Protocols";
+	case 200:
+		return "OK";
+	case 206:
+		return "Partial Content";
+	case 404:
+		return "Not Found";
+	case 405:
+		return "Method Not Allowed";
+	case 416:
+		return "Range Not Satisfiable";
+	case 503:
+		return "Service Unavailable";
+	default:
+		return "Unknown";
+	}
+}
+
+// Disable linger, so the connection is reset once closed.
+void ResetOnClose(int fd) {
+	linger no_linger {};
+	no_linger.l_onoff = 1;
+	no_linger.l_linger = 0;
+	setsockopt(fd, SOL_SOCKET, SO_LINGER, &no_linger, sizeof(no_linger));
+}
+
+// Whether the fault is injected into the body, which happens at [`GetBodyFaultOffset`].
+bool IsBodyFault(LoopbackFault fault) {
+	return fault == LoopbackFault::MID_BODY_STALL || fault == LoopbackFault::TRUNCATED_BODY;
+}
+
+idx_t GetBodyFaultOffset(const string &body) {
+	return body.size() / 2;
+}
+
+} // namespace
+
+struct LoopbackRangeServer::Response {
+	int status = 200;
+	// Header names are lowercase.
+	vector<HpackHeader> headers;
+	string body;
+	LoopbackFault fault = LoopbackFault::NONE;
+};
+
+LoopbackRangeServer::LoopbackRangeServer(LoopbackRangeServerConfig config_p)
+    : config(std::move(config_p)), fault_rng(config.fault_seed) {
+	listen_fd = ListenOnLoopback(/*backlog=*/SOMAXCONN, port);
+	if (pipe(stop_pipe) < 0) {
+		const int errnum = errno;
+		close(listen_fd);
+		throw IOException("Failed to create stop pipe of loopback server: %s", std::strerror(errnum));
+	}
+	serve_thread = std::thread([this]() { Serve(); });
+}
+
+LoopbackRangeServer::~LoopbackRangeServer() {
+	const char stop_byte = 0;
+	write(stop_pipe[1], &stop_byte, 1);
+	serve_thread.join();
+	{
+		const std::lock_guard<std::mutex> lck(mu);
+		// Wake up connection threads blocked in socket IO.
+		for (auto &cur_connection : connections) {
+			if (cur_connection->fd >= 0) {
+				shutdown(cur_connection->fd, SHUT_RDWR);
+			}
+		}
+	}
+	ReapConnections(/*wait_all=*/true);
+	close(listen_fd);
+	close(stop_pipe[0]);
+	close(stop_pipe[1]);
+}
+
+string LoopbackRangeServer::GetUrl(const string &path) const {
+	return StringUtil::Format("http://127.0.0.1:%d%s", port, path);
+}
+
+void LoopbackRangeServer::PutObject(const string &path, string content) {
+	const std::lock_guard<std::mutex> lck(mu);
+	objects[path] = make_shared_ptr<const string>(std::move(content));
+}
+
+/*static*/ char LoopbackRangeServer::GetGeneratedByte(idx_t offset) {
+	// Mix higher bits in, so misplaced ranges are detected even if they're a multiple of the alphabet size apart.
+	return static_cast<char>('a' + (offset + offset / 26 + offset / (26 * 26)) % 26);
+}
+
+void LoopbackRangeServer::ScheduleFault(LoopbackFault fault, idx_t count) {
+	const std::lock_guard<std::mutex> lck(mu);
+	scheduled_faults.insert(scheduled_faults.end(), count, fault);
+}
+
+LoopbackFault LoopbackRangeServer::PickFault() {
+	LoopbackFault fault = LoopbackFault::NONE;
+	{
+		const std::lock_guard<std::mutex> lck(mu);
+		if (!scheduled_faults.empty()) {
+			fault = scheduled_faults.front();
+			scheduled_faults.pop_front();
+		} else if (!config.fault_probabilities.empty()) {
+			const double sample = std::uniform_real_distribution<double>(0.0, 1.0)(fault_rng);
+			double cumulative_probability = 0;
+			for (const auto &cur_fault : config.fault_probabilities) {
+				cumulative_probability += cur_fault.probability;
+				if (sample < cumulative_probability) {
+					fault = cur_fault.fault;
+					break;
+				}
+			}
+		}
+	}
+	if (fault != LoopbackFault::NONE) {
+		fault_count.fetch_add(1, std::memory_order_relaxed);
+	}
+	return fault;
+}
+
+bool LoopbackRangeServer::SleepUnlessStopped(std::chrono::microseconds duration) const {
+	// Stop pipe stays readable once the server is stopped.
+	pollfd pfd;
+	pfd.fd = stop_pipe[0];
+	pfd.events = POLLIN;
+	const auto deadline = std::chrono::steady_clock::now() + duration;
+	while (true) {
+		const auto remaining =
+		    std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+		if (remaining.count() <= 0) {
+			std::this_thread::sleep_until(deadline);
+			return true;
+		}
+		if (poll(&pfd, 1, static_cast<int>(remaining.count())) > 0) {
+			return false;
+		}
+	}
+}
+
+void LoopbackRangeServer::Serve() {
+	while (true) {
+		pollfd fds[2];
+		fds[0].fd = listen_fd;
+		fds[0].events = POLLIN;
+		fds[1].fd = stop_pipe[0];
+		fds[1].events = POLLIN;
+		if (poll(fds, 2, /*timeout=*/-1) < 0) {
+			continue;
+		}
+		if (fds[1].revents != 0) {
+			return;
+		}
+		const int conn_fd = accept(listen_fd, nullptr, nullptr);
+		if (conn_fd < 0) {
+			continue;
+		}
+		const int no_delay = 1;
+		setsockopt(conn_fd, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+		connection_count.fetch_add(1, std::memory_order_relaxed);
+
+		ReapConnections(/*wait_all=*/false);
+		const std::lock_guard<std::mutex> lck(mu);
+		auto connection = make_uniq<Connection>();
+		auto *connection_ptr = connection.get();
+		connection->fd = conn_fd;
+		connection->thread = std::thread([this, connection_ptr]() {
+			ServeConnection(connection_ptr->fd);
+			// Close right away rather than on reap, so connections reset by faults are seen by clients promptly.
+			const std::lock_guard<std::mutex> lck(mu);
+			close(connection_ptr->fd);
+			connection_ptr->fd = -1;
+			connection_ptr->done = true;
+		});
+		connections.emplace_back(std::move(connection));
+	}
+}
+
+void LoopbackRangeServer::ReapConnections(bool wait_all) {
+	vector<unique_ptr<Connection>> to_reap;
+	{
+		const std::lock_guard<std::mutex> lck(mu);
+		// Connections to keep are moved to the front.
+		auto iter = std::partition(connections.begin(), connections.end(),
+		                           [wait_all](const unique_ptr<Connection> &cur_connection) {
+			                           return !wait_all && !cur_connection->done.load();
+		                           });
+		for (auto cur_iter = iter; cur_iter != connections.end(); ++cur_iter) {
+			to_reap.emplace_back(std::move(*cur_iter));
+		}
+		connections.erase(iter, connections.end());
+	}
+	for (auto &cur_connection : to_reap) {
+		cur_connection->thread.join();
+	}
+}
+
+void LoopbackRangeServer::ServeConnection(int fd) {
+	string pending;
+	while (pending.size() < HTTP2_PREFACE_LEN && string(HTTP2_PREFACE, pending.size()) == pending) {
+		if (!RecvMore(fd, pending)) {
+			return;
+		}
+	}
+	if (config.enable_http2 && StringUtil::StartsWith(pending, HTTP2_PREFACE)) {
+		ServeHttp2(fd, pending, /*upgraded_request=*/nullptr);
+		return;
+	}
+	ServeHttp1(fd, pending);
+}
+
+LoopbackRangeServer::Response LoopbackRangeServer::BuildResponse(const LoopbackRequest &request) {
+	request_count.fetch_add(1, std::memory_order_relaxed);
+	Response response;
+	response.fault = PickFault();
+	if (response.fault == LoopbackFault::SLOW_DOWN) {
+		response.status = 503;
+		response.body = SLOW_DOWN_BODY;
+		response.headers.emplace_back("content-length", std::to_string(response.body.size()));
+		response.headers.emplace_back("content-type", "application/xml");
+		if (request.method == "HEAD") {
+			response.body.clear();
+		}
+		return response;
+	}
+	if (request.method != "GET" && request.method != "HEAD") {
+		response.status = 405;
+		response.headers.emplace_back("content-length", "0");
+		return response;
+	}
+
+	const string path = request.path.substr(0, request.path.find('?'));
+	shared_ptr<const string> object;
+	idx_t object_size = 0;
+	if (path == GENERATED_OBJECT_PATH) {
+		object_size = config.object_size;
+	} else {
+		const std::lock_guard<std::mutex> lck(mu);
+		auto iter = objects.find(path);
+		if (iter == objects.end()) {
+			response.status = 404;
+			response.headers.emplace_back("content-length", "0");
+			return response;
+		}
+		object = iter->second;
+		object_size = object->size();
+	}
+
+	idx_t start = 0;
+	idx_t end = object_size == 0 ? 0 : object_size - 1;
+	auto range_iter = request.headers.find("range");
+	if (range_iter != request.headers.end()) {
+		if (!ParseRange(range_iter->second, object_size, start, end)) {
+			response.status = 416;
+			response.headers.emplace_back("content-range", StringUtil::Format("bytes */%llu", object_size));
+			response.headers.emplace_back("content-length", "0");
+			return response;
+		}
+		response.status = 206;
+		response.headers.emplace_back("content-range", StringUtil::Format("bytes %llu-%llu/%llu", start, end, object_size));
+	}
+	const idx_t content_length = object_size == 0 ? 0 : end - start + 1;
+	response.headers.emplace_back("content-length", std::to_string(content_length));
+	response.headers.emplace_back("content-type", "application/octet-stream");
+	response.headers.emplace_back("accept-ranges", "bytes");
+	response.headers.emplace_back("last-modified", "Mon, 01 Jan 2024 00:00:00 GMT");
+	response.headers.emplace_back("etag", StringUtil::Format("\"%llu\"", object_size));
+	if (request.method == "HEAD" || content_length == 0) {
+		return response;
+	}
+
+	if (object != nullptr) {
+		response.body = object->substr(start, content_length);
+	} else {
+		response.body.resize(content_length);
+		for (idx_t idx = 0; idx < content_length; ++idx) {
+			response.body[idx] = GetGeneratedByte(start + idx);
+		}
+	}
+	return response;
+}
+
+void LoopbackRangeServer::ServeHttp1(int fd, string &pending) {
+	BandwidthPacer pacer {config.bandwidth_bytes_per_sec};
+	while (true) {
+		auto header_end = pending.find("\r\n\r\n");
+		while (header_end == string::npos) {
+			if (!RecvMore(fd, pending)) {
+				return;
+			}
+			header_end = pending.find("\r\n\r\n");
+		}
+
+		LoopbackRequest request;
+		const auto lines = StringUtil::Split(pending.substr(0, header_end), "\r\n");
+		pending.erase(0, header_end + 4);
+		if (lines.empty()) {
+			return;
+		}
+		const auto request_line = StringUtil::Split(lines[0], " ");
+		if (request_line.size() < 2) {
+			return;
+		}
+		request.method = request_line[0];
+		request.path = request_line[1];
+		for (idx_t idx = 1; idx < lines.size(); ++idx) {
+			const auto colon_pos = lines[idx].find(':');
+			if (colon_pos == string::npos) {
+				continue;
+			}
+			auto value = lines[idx].substr(colon_pos + 1);
+			StringUtil::Trim(value);
+			request.headers[StringUtil::Lower(lines[idx].substr(0, colon_pos))] = std::move(value);
+		}
+
+		// Request body is discarded.
+		auto length_iter = request.headers.find("content-length");
+		const idx_t body_len = length_iter == request.headers.end() ? 0 : std::stoull(length_iter->second);
+		while (pending.size() < body_len) {
+			if (!RecvMore(fd, pending)) {
+				return;
+			}
+		}
+		pending.erase(0, body_len);
+
+		auto upgrade_iter = request.headers.find("upgrade");
+		if (config.enable_http2 && upgrade_iter != request.headers.end() &&
+		    upgrade_iter->second.find("h2c") != string::npos) {
+			const string switching = "HTTP/1.1 101 Switching Protocols\r\nConnection: Upgrade\r\nUpgrade: h2c\r\n\r\n";
+			if (!SendAll(fd, switching.data(), switching.size())) {
+				return;
+			}
+			request.http2 = true;
+			ServeHttp2(fd, pending, &request);
+			return;
+		}
+
+		auto response = BuildResponse(request);
+		if (response.fault == LoopbackFault::CONNECTION_RESET) {
+			ResetOnClose(fd);
+			return;
+		}
+		std::this_thread::sleep_for(config.latency);
+		if (response.fault == LoopbackFault::SLOW_FIRST_BYTE && !SleepUnlessStopped(config.fault_delay)) {
+			return;
+		}
+		auto connection_iter = request.headers.find("connection");
+		const bool close_connection =
+		    connection_iter != request.headers.end() && StringUtil::Lower(connection_iter->second) == "close";
+		string head = StringUtil::Format("HTTP/1.1 %d %s\r\n", response.status, GetStatusText(response.status));
+		for (const auto &cur_header : response.headers) {
+			head += cur_header.first + ": " + cur_header.second + "\r\n";
+		}
+		if (close_connection) {
+			head += "connection: close\r\n";
+		}
+		head += "\r\n";
+		if (!SendAll(fd, head.data(), head.size())) {
+			return;
+		}
+		const idx_t fault_offset = GetBodyFaultOffset(response.body);
+		idx_t offset = 0;
+		while (offset < response.body.size()) {
+			if (offset == fault_offset && response.fault == LoopbackFault::TRUNCATED_BODY) {
+				return;
+			}
+			if (offset == fault_offset && response.fault == LoopbackFault::MID_BODY_STALL &&
+			    !SleepUnlessStopped(config.fault_delay)) {
+				return;
+			}
+			std::this_thread::sleep_until(pacer.GetNextSendTime());
+			idx_t chunk_size = std::min(HTTP1_CHUNK_SIZE, response.body.size() - offset);
+			// Split the chunk at the fault offset.
+			if (IsBodyFault(response.fault) && offset < fault_offset) {
+				chunk_size = std::min(chunk_size, fault_offset - offset);
+			}
+			if (!SendAll(fd, response.body.data() + offset, chunk_size)) {
+				return;
+			}
+			pacer.OnSent(chunk_size);
+			offset += chunk_size;
+		}
+		if (close_connection) {
+			return;
+		}
+	}
+}
+
+void LoopbackRangeServer::ServeHttp2(int fd, string &pending, const LoopbackRequest *upgraded_request) {
+	struct Stream {
+		LoopbackRequest request;
+		// Header block fragments received so far.
+		string header_block;
+		// Whether the request ends with the header block being received.
+		bool end_stream_on_headers = false;
+		bool request_done = false;
+		Response response;
+		std::chrono::steady_clock::time_point ready_time;
+		bool headers_sent = false;
+		idx_t body_offset = 0;
+		int64_t send_window = HTTP2_DEFAULT_WINDOW;
+		// Time until which the body stalls, set once the stall fault is hit.
+		std::chrono::steady_clock::time_point stall_until;
+		bool stalled = false;
+	};
+
+	HpackDecoder decoder;
+	BandwidthPacer pacer {config.bandwidth_bytes_per_sec};
+	int64_t connection_send_window = HTTP2_DEFAULT_WINDOW;
+	int64_t initial_stream_window = HTTP2_DEFAULT_WINDOW;
+	idx_t max_frame_size = HTTP2_DEFAULT_MAX_FRAME_SIZE;
+	// Ordered by stream id, so streams are served in order of arrival.
+	std::map<uint32_t, Stream> streams;
+
+	auto finish_request = [&](Stream &stream) {
+		stream.request_done = true;
+		stream.request.http2 = true;
+		stream.response = BuildResponse(stream.request);
+		stream.ready_time = std::chrono::steady_clock::now() + config.latency;
+		if (stream.response.fault == LoopbackFault::SLOW_FIRST_BYTE) {
+			stream.ready_time += config.fault_delay;
+		}
+	};
+
+	// Server connection preface.
+	string settings;
+	settings.push_back(0);
+	settings.push_back(static_cast<char>(MAX_CONCURRENT_STREAMS));
+	AppendUint32(settings, HTTP2_MAX_CONCURRENT_STREAMS);
+	if (!SendHttp2Frame(fd, SETTINGS, 0, 0, settings)) {
+		return;
+	}
+	if (upgraded_request != nullptr) {
+		auto &stream = streams[1];
+		stream.request = *upgraded_request;
+		finish_request(stream);
+	}
+	while (pending.size() < HTTP2_PREFACE_LEN) {
+		if (!RecvMore(fd, pending)) {
+			return;
+		}
+	}
+	if (!StringUtil::StartsWith(pending, HTTP2_PREFACE)) {
+		return;
+	}
+	pending.erase(0, HTTP2_PREFACE_LEN);
+
+	// Handle the given header block of the given stream once it's complete.
+	auto handle_header_block = [&](uint32_t stream_id) {
+		auto &stream = streams[stream_id];
+		vector<HpackHeader> headers;
+		if (!decoder.Decode(stream.header_block, headers)) {
+			return false;
+		}
+		stream.header_block.clear();
+		// Trailers of a request are ignored.
+		if (stream.request.method.empty()) {
+			for (auto &cur_header : headers) {
+				if (cur_header.first == ":method") {
+					stream.request.method = std::move(cur_header.second);
+				} else if (cur_header.first == ":path") {
+					stream.request.path = std::move(cur_header.second);
+				} else if (cur_header.first[0] != ':') {
+					stream.request.headers[cur_header.first] = std::move(cur_header.second);
+				}
+			}
+		}
+		if (stream.end_stream_on_headers) {
+			finish_request(stream);
+		}
+		return true;
+	};
+
+	// Handle one frame, return false if the connection should be closed.
+	auto handle_frame = [&](uint8_t type, uint8_t flags, uint32_t stream_id, string payload) {
+		// Strip padding and priority, which are only present on DATA and HEADERS frames.
+		if ((type == DATA || type == HEADERS) && (flags & PADDED)) {
+			if (payload.empty() || static_cast<uint8_t>(payload[0]) >= payload.size()) {
+				return false;
+			}
+			const idx_t pad_len = static_cast<uint8_t>(payload[0]);
+			payload = payload.substr(1, payload.size() - 1 - pad_len);
+		}
+		switch (type) {
+		case DATA: {
+			// Request body is discarded, and the flow control window is replenished right away.
+			const uint32_t frame_len = static_cast<uint32_t>(payload.size());
+			if (frame_len > 0) {
+				string increment;
+				AppendUint32(increment, frame_len);
+				if (!SendHttp2Frame(fd, WINDOW_UPDATE, 0, 0, increment) ||
+				    !SendHttp2Frame(fd, WINDOW_UPDATE, 0, stream_id, increment)) {
+					return false;
+				}
+			}
+			auto iter = streams.find(stream_id);
+			if (iter != streams.end() && (flags & END_STREAM) && !iter->second.request_done) {
+				finish_request(iter->second);
+			}
+			return true;
+		}
+		case HEADERS: {
+			if (flags & PRIORITY_FLAG) {
+				if (payload.size() < 5) {
+					return false;
+				}
+				payload = payload.substr(5);
+			}
+			auto iter = streams.find(stream_id);
+			if (iter == streams.end()) {
+				iter = streams.emplace(stream_id, Stream {}).first;
+				iter->second.send_window = initial_stream_window;
+			}
+			auto &stream = iter->second;
+			stream.header_block += payload;
+			stream.end_stream_on_headers = (flags & END_STREAM) != 0;
+			return (flags & END_HEADERS) ? handle_header_block(stream_id) : true;
+		}
+		case CONTINUATION: {
+			auto iter = streams.find(stream_id);
+			if (iter == streams.end()) {
+				return false;
+			}
+			iter->second.header_block += payload;
+			return (flags & END_HEADERS) ? handle_header_block(stream_id) : true;
+		}
+		case RST_STREAM:
+			streams.erase(stream_id);
+			return true;
+		case SETTINGS: {
+			if (flags & ACK) {
+				return true;
+			}
+			for (idx_t offset = 0; offset + 6 <= payload.size(); offset += 6) {
+				const uint16_t id = static_cast<uint16_t>((static_cast<uint8_t>(payload[offset]) << 8) |
+				                                          static_cast<uint8_t>(payload[offset + 1]));
+				const uint32_t value = ReadUint32(payload.data() + offset + 2);
+				if (id == INITIAL_WINDOW_SIZE) {
+					const int64_t delta = static_cast<int64_t>(value) - initial_stream_window;
+					for (auto &cur_stream : streams) {
+						cur_stream.second.send_window += delta;
+					}
+					initial_stream_window = value;
+				} else if (id == MAX_FRAME_SIZE) {
+					max_frame_size = value;
+				}
+			}
+			return SendHttp2Frame(fd, SETTINGS, ACK, 0, "", 0);
+		}
+		case PING:
+			return (flags & ACK) ? true : SendHttp2Frame(fd, PING, ACK, 0, payload);
+		case GOAWAY:
+			return false;
+		case WINDOW_UPDATE: {
+			if (payload.size() < 4) {
+				return false;
+			}
+			const int64_t increment = ReadUint32(payload.data()) & 0x7fffffff;
+			if (stream_id == 0) {
+				connection_send_window += increment;
+			} else {
+				auto iter = streams.find(stream_id);
+				if (iter != streams.end()) {
+					iter->second.send_window += increment;
+				}
+			}
+			return true;
+		}
+		default:
+			// PRIORITY, PUSH_PROMISE and unknown frames are ignored.
+			return true;
+		}
+	};
+
+	while (true) {
+		// Handle all complete frames received.
+		while (pending.size() >= HTTP2_FRAME_HEADER_LEN) {
+			const idx_t payload_len = (static_cast<idx_t>(static_cast<uint8_t>(pending[0])) << 16) |
+			                          (static_cast<idx_t>(static_cast<uint8_t>(pending[1])) << 8) |
+			                          static_cast<idx_t>(static_cast<uint8_t>(pending[2]));
+			if (pending.size() < HTTP2_FRAME_HEADER_LEN + payload_len) {
+				break;
+			}
+			const uint8_t type = static_cast<uint8_t>(pending[3]);
+			const uint8_t flags = static_cast<uint8_t>(pending[4]);
+			const uint32_t stream_id = ReadUint32(pending.data() + 5) & 0x7fffffff;
+			string payload = pending.substr(HTTP2_FRAME_HEADER_LEN, payload_len);
+			pending.erase(0, HTTP2_FRAME_HEADER_LEN + payload_len);
+			if (!handle_frame(type, flags, stream_id, std::move(payload))) {
+				return;
+			}
+		}
+
+		// Send responses which are ready, one frame per stream at a time so streams share the connection fairly.
+		auto next_wakeup = std::chrono::steady_clock::time_point::max();
+		bool progress = true;
+		while (progress) {
+			progress = false;
+			const auto now = std::chrono::steady_clock::now();
+			for (auto iter = streams.begin(); iter != streams.end();) {
+				const uint32_t stream_id = iter->first;
+				auto &stream = iter->second;
+				if (!stream.request_done) {
+					++iter;
+					continue;
+				}
+				// The whole connection is reset, along with other streams on it.
+				if (stream.response.fault == LoopbackFault::CONNECTION_RESET) {
+					ResetOnClose(fd);
+					return;
+				}
+				if (!stream.headers_sent) {
+					if (now < stream.ready_time) {
+						next_wakeup = std::min(next_wakeup, stream.ready_time);
+						++iter;
+						continue;
+					}
+					vector<HpackHeader> headers;
+					headers.emplace_back(":status", std::to_string(stream.response.status));
+					for (const auto &cur_header : stream.response.headers) {
+						headers.emplace_back(cur_header);
+					}
+					const bool end_stream = stream.response.body.empty();
+					if (!SendHttp2Frame(fd, HEADERS, END_HEADERS | (end_stream ? END_STREAM : 0), stream_id,
+					                    HpackEncoder::Encode(headers))) {
+						return;
+					}
+					stream.headers_sent = true;
+					progress = true;
+					if (end_stream) {
+						iter = streams.erase(iter);
+						continue;
+					}
+				}
+				const idx_t fault_offset = GetBodyFaultOffset(stream.response.body);
+				if (stream.body_offset == fault_offset && stream.response.fault == LoopbackFault::TRUNCATED_BODY) {
+					string error_code;
+					AppendUint32(error_code, HTTP2_INTERNAL_ERROR);
+					if (!SendHttp2Frame(fd, RST_STREAM, 0, stream_id, error_code)) {
+						return;
+					}
+					progress = true;
+					iter = streams.erase(iter);
+					continue;
+				}
+				if (stream.body_offset == fault_offset && stream.response.fault == LoopbackFault::MID_BODY_STALL) {
+					if (!stream.stalled) {
+						stream.stalled = true;
+						stream.stall_until = now + config.fault_delay;
+					}
+					if (now < stream.stall_until) {
+						next_wakeup = std::min(next_wakeup, stream.stall_until);
+						++iter;
+						continue;
+					}
+				}
+				idx_t remaining = stream.response.body.size() - stream.body_offset;
+				// Split the frame at the fault offset.
+				if (IsBodyFault(stream.response.fault) && stream.body_offset < fault_offset) {
+					remaining = fault_offset - stream.body_offset;
+				}
+				const int64_t window = std::min(connection_send_window, stream.send_window);
+				if (window <= 0) {
+					++iter;
+					continue;
+				}
+				if (now < pacer.GetNextSendTime()) {
+					next_wakeup = std::min(next_wakeup, pacer.GetNextSendTime());
+					++iter;
+					continue;
+				}
+				const idx_t chunk_size = std::min<idx_t>({remaining, static_cast<idx_t>(window), max_frame_size});
+				const bool end_stream = stream.body_offset + chunk_size == stream.response.body.size();
+				if (!SendHttp2Frame(fd, DATA, end_stream ? END_STREAM : 0, stream_id,
+				                    stream.response.body.data() + stream.body_offset, chunk_size)) {
+					return;
+				}
+				pacer.OnSent(chunk_size);
+				stream.body_offset += chunk_size;
+				stream.send_window -= static_cast<int64_t>(chunk_size);
+				connection_send_window -= static_cast<int64_t>(chunk_size);
+				progress = true;
+				if (end_stream) {
+					iter = streams.erase(iter);
+					continue;
+				}
+				++iter;
+			}
+		}
+
+		// Wait for more frames, or the next response to be ready.
+		int timeout_ms = -1;
+		if (next_wakeup != std::chrono::steady_clock::time_point::max()) {
+			const auto wait = next_wakeup - std::chrono::steady_clock::now();
+			timeout_ms = static_cast<int>(std::max<int64_t>(
+			    std::chrono::duration_cast<std::chrono::microseconds>(wait).count() / 1000 + 1, 0));
+		}
+		pollfd pfd;
+		pfd.fd = fd;
+		pfd.events = POLLIN;
+		const int ret = poll(&pfd, 1, timeout_ms);
+		if (ret > 0 && !RecvMore(fd, pending)) {
+			return;
+		}
+	}
+}
+
+} // namespace duckdb
@@ -0,0 +1,163 @@
+// An HTTP server on loopback which serves range reads of in-memory objects, used by tests and benchmarks to avoid
+// depending on remote endpoints.
+//
+// It speaks HTTP/1.1 with keep-alive, and optionally cleartext HTTP/2, either with prior knowledge or upgraded from
+// HTTP/1.1 (`Upgrade: h2c`), which is what curl does for `http://` URLs when HTTP/2 is requested. Response latency and
+// per-connection bandwidth are configurable to emulate remote object stores.
+//
+// Faults which hurt tail latency in production (slow first byte, mid-body stalls, connection resets, 503 SlowDown and
+// truncated bodies) could be injected into scheduled requests or at random, see [`LoopbackFault`].
+//
+// Each connection is served by its own thread; HTTP/2 streams on a connection are served concurrently.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <random>
+#include <thread>
+
+#include "duckdb/common/shared_ptr.hpp"
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/typedefs.hpp"
+#include "duckdb/common/unique_ptr.hpp"
+#include "duckdb/common/unordered_map.hpp"
+#include "duckdb/common/vector.hpp"
+
+namespace duckdb {
+
+// Fault injected into the response of a request.
+enum class LoopbackFault : uint8_t {
+	NONE = 0,
+	// Response headers are delayed by [`LoopbackRangeServerConfig::fault_delay`], on top of the latency.
+	SLOW_FIRST_BYTE = 1,
+	// Body stalls for [`LoopbackRangeServerConfig::fault_delay`] once half of it is sent.
+	MID_BODY_STALL = 2,
+	// Connection is reset without a response.
+	CONNECTION_RESET = 3,
+	// Request is rejected with 503 and an S3 `SlowDown` error.
+	SLOW_DOWN = 4,
+	// Once half of the body is sent, connection is closed for HTTP/1.1, or stream is reset for HTTP/2.
+	TRUNCATED_BODY = 5,
+};
+
+struct LoopbackFaultProbability {
+	LoopbackFault fault = LoopbackFault::NONE;
+	// Probability within [0, 1] of each request to get the fault.
+	double probability = 0;
+};
+
+struct LoopbackRangeServerConfig {
+	// Size of the generated object served at [`LoopbackRangeServer::GENERATED_OBJECT_PATH`].
+	idx_t object_size = 1024 * 1024;
+	// Delay before sending response headers of each request.
+	std::chrono::microseconds latency {0};
+	// Max bytes of response body sent per second on each connection, 0 means unlimited.
+	uint64_t bandwidth_bytes_per_sec = 0;
+	// Whether to accept HTTP/2 over cleartext, otherwise upgrade requests are ignored.
+	bool enable_http2 = false;
+	// Faults injected at random into requests which have no scheduled fault; probabilities should sum up to at most 1.
+	vector<LoopbackFaultProbability> fault_probabilities;
+	// Seed of random faults, so runs with the same sequence of requests are repeatable.
+	uint64_t fault_seed = 0;
+	// Delay of slow first byte and mid-body stall faults.
+	std::chrono::microseconds fault_delay {std::chrono::seconds(1)};
+};
+
+// A request received by the server.
+struct LoopbackRequest {
+	string method;
+	string path;
+	// Header names are lowercase.
+	unordered_map<string, string> headers;
+	// Whether the request is received over HTTP/2.
+	bool http2 = false;
+};
+
+class LoopbackRangeServer {
+public:
+	// Path of the object whose content is generated from offsets, see [`GetGeneratedByte`].
+	static constexpr const char *GENERATED_OBJECT_PATH = "/object";
+
+	// Start serving, throw IOException if the server fails to listen.
+	explicit LoopbackRangeServer(LoopbackRangeServerConfig config = LoopbackRangeServerConfig {});
+	// Close all connections and stop serving.
+	~LoopbackRangeServer();
+
+	// Disable copy / move constructor / assignment.
+	LoopbackRangeServer(const LoopbackRangeServer &) = delete;
+	LoopbackRangeServer &operator=(const LoopbackRangeServer &) = delete;
+
+	// Get the URL of the given path, i.e. `http://127.0.0.1:<port>/object`.
+	string GetUrl(const string &path = GENERATED_OBJECT_PATH) const;
+	int GetPort() const {
+		return port;
+	}
+
+	// Serve the given content at the given path, which replaces the existing object. Thread-safe.
+	void PutObject(const string &path, string content);
+	// Byte at the given offset of the generated object.
+	static char GetGeneratedByte(idx_t offset);
+	// Inject the given fault into the next [`count`] requests, ahead of random faults. Thread-safe.
+	void ScheduleFault(LoopbackFault fault, idx_t count = 1);
+
+	// Number of requests received and connections accepted so far.
+	uint64_t GetRequestCount() const {
+		return request_count.load(std::memory_order_relaxed);
+	}
+	uint64_t GetConnectionCount() const {
+		return connection_count.load(std::memory_order_relaxed);
+	}
+	// Number of faults injected so far.
+	uint64_t GetFaultCount() const {
+		return fault_count.load(std::memory_order_relaxed);
+	}
+
+private:
+	struct Connection {
+		// Closed by the connection thread once it's done serving, and reset to -1.
+		int fd = -1;
+		std::thread thread;
+		std::atomic<bool> done {false};
+	};
+	struct Response;
+
+	void Serve();
+	void ServeConnection(int fd);
+	// Serve HTTP/1.1 requests on the connection; [`pending`] holds bytes received but not consumed.
+	void ServeHttp1(int fd, string &pending);
+	// Serve HTTP/2 on the connection. If [`upgraded_request`] is given, it's the request upgraded from HTTP/1.1,
+	// which is served as stream 1.
+	void ServeHttp2(int fd, string &pending, const LoopbackRequest *upgraded_request);
+	// Build the response of the given request, the body is only filled for non-HEAD requests.
+	Response BuildResponse(const LoopbackRequest &request);
+	// Pick the fault to inject into the next request.
+	LoopbackFault PickFault();
+	// Sleep for the given duration, return false if the server is stopped meanwhile.
+	bool SleepUnlessStopped(std::chrono::microseconds duration) const;
+	// Join threads of closed connections.
+	void ReapConnections(bool wait_all);
+
+	const LoopbackRangeServerConfig config;
+	int listen_fd = -1;
+	int port = 0;
+	// Pipe to stop the accept loop.
+	int stop_pipe[2] = {-1, -1};
+	std::thread serve_thread;
+
+	std::atomic<uint64_t> request_count {0};
+	std::atomic<uint64_t> connection_count {0};
+	std::atomic<uint64_t> fault_count {0};
+
+	// Protects objects, connections and faults.
+	std::mutex mu;
+	unordered_map<string, shared_ptr<const string>> objects;
+	vector<unique_ptr<Connection>> connections;
+	std::deque<LoopbackFault> scheduled_faults;
+	std::mt19937_64 fault_rng;
+};
+
+} // namespace duckdb